@@ -0,0 +1,144 @@
+# ==============================================================================
+#  Copyright 2018 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""Compares bf16 mixed precision against f32 on the simplified MNIST model.
+
+Trains the model of mnist_deep_simplified.py from the same initial weights
+and on the same batches twice, once in f32 and once with
+ngraph_config.enable_mixed_precision(), and reports the test accuracy and the
+training throughput of each run.
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import argparse
+import sys
+import time
+
+import numpy as np
+from tensorflow.examples.tutorials.mnist import input_data
+
+import tensorflow as tf
+import ngraph_config
+
+from mnist_deep_simplified import deepnn
+
+# Steps that compile new functions are not counted towards throughput.
+WARMUP_STEPS = 10
+
+
+def train_and_test(mnist, mixed_precision):
+    if mixed_precision:
+        ngraph_config.enable_mixed_precision()
+    else:
+        ngraph_config.disable_mixed_precision()
+
+    tf.reset_default_graph()
+    tf.set_random_seed(FLAGS.seed)
+
+    x = tf.placeholder(tf.float32, [None, 784])
+    y_ = tf.placeholder(tf.float32, [None, 10])
+    y_conv, keep_prob = deepnn(x)
+
+    cross_entropy = tf.reduce_mean(
+        tf.nn.softmax_cross_entropy_with_logits(labels=y_, logits=y_conv))
+    train_step = tf.train.AdamOptimizer(1e-4).minimize(cross_entropy)
+    correct_prediction = tf.equal(tf.argmax(y_conv, 1), tf.argmax(y_, 1))
+    accuracy = tf.reduce_mean(tf.cast(correct_prediction, tf.float32))
+
+    config = tf.ConfigProto(
+        allow_soft_placement=True,
+        log_device_placement=False,
+        inter_op_parallelism_threads=1)
+
+    # Both runs see the same batches.
+    rng = np.random.RandomState(FLAGS.seed)
+    num_train = mnist.train.num_examples
+
+    with tf.Session(config=config) as sess:
+        sess.run(tf.global_variables_initializer())
+
+        timed_steps = 0
+        timed_seconds = 0.0
+        for i in range(FLAGS.train_loop_count):
+            indices = rng.randint(0, num_train, FLAGS.batch_size)
+            t = time.time()
+            sess.run(
+                train_step,
+                feed_dict={
+                    x: mnist.train.images[indices],
+                    y_: mnist.train.labels[indices],
+                    keep_prob: 0.5
+                })
+            if i >= WARMUP_STEPS:
+                timed_steps += 1
+                timed_seconds += time.time() - t
+
+        test_accuracy = sess.run(
+            accuracy,
+            feed_dict={
+                x: mnist.test.images[:FLAGS.test_image_count],
+                y_: mnist.test.labels[:FLAGS.test_image_count],
+                keep_prob: 1.0
+            })
+
+    images_per_sec = (timed_steps * FLAGS.batch_size / timed_seconds
+                      if timed_seconds > 0 else float('nan'))
+    return test_accuracy, images_per_sec
+
+
+def main(_):
+    mnist = input_data.read_data_sets(FLAGS.data_dir, one_hot=True)
+
+    f32_accuracy, f32_throughput = train_and_test(mnist, False)
+    bf16_accuracy, bf16_throughput = train_and_test(mnist, True)
+    ngraph_config.disable_mixed_precision()
+
+    print('%-16s %14s %18s' % ('', 'test accuracy', 'train images/sec'))
+    print('%-16s %14.4f %18.1f' % ('f32', f32_accuracy, f32_throughput))
+    print('%-16s %14.4f %18.1f' % ('mixed (bf16)', bf16_accuracy,
+                                   bf16_throughput))
+    print('accuracy change %+.4f, speedup %.2fx' %
+          (bf16_accuracy - f32_accuracy, bf16_throughput / f32_throughput))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        '--data_dir',
+        type=str,
+        default='/tmp/tensorflow/mnist/input_data',
+        help='Directory where input data is stored')
+
+    parser.add_argument(
+        '--train_loop_count',
+        type=int,
+        default=1000,
+        help='Number of training iterations')
+
+    parser.add_argument('--batch_size', type=int, default=50, help='Batch Size')
+
+    parser.add_argument(
+        '--test_image_count',
+        type=int,
+        default=None,
+        help="Number of test images to evaluate on")
+
+    parser.add_argument(
+        '--seed', type=int, default=0, help='Seed for weights and batches')
+
+    FLAGS, unparsed = parser.parse_known_args()
+    tf.app.run(main=main, argv=[sys.argv[0]] + unparsed)
@@ -41,7 +41,21 @@ tensorflow::int64 LogLevelStrToInt(const char* tf_env_var_val) {
 }
 }  // namespace
 
-tensorflow::int64 NGraphLogMessage::MinNGraphVLogLevel() {
-  const char* tf_env_var_val = std::getenv("NGRAPH_TF_VLOG_LEVEL");
-  return LogLevelStrToInt(tf_env_var_val);
+constexpr tensorflow::int64 NGraphLogMessage::kLevelUnset;
+
+std::atomic<tensorflow::int64> NGraphLogMessage::s_min_vlog_level{kLevelUnset};
+
+tensorflow::int64 NGraphLogMessage::InitMinNGraphVLogLevel() {
+  tensorflow::int64 level =
+      LogLevelStrToInt(std::getenv("NGRAPH_TF_VLOG_LEVEL"));
+  // A level set through SetMinNGraphVLogLevel in the meantime wins.
+  tensorflow::int64 expected = kLevelUnset;
+  if (!s_min_vlog_level.compare_exchange_strong(expected, level)) {
+    return expected;
+  }
+  return level;
+}
+
+void NGraphLogMessage::SetMinNGraphVLogLevel(tensorflow::int64 level) {
+  s_min_vlog_level.store(level, std::memory_order_relaxed);
 }
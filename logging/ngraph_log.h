@@ -17,17 +17,39 @@
 #ifndef NGRAPH_LOG_H_
 #define NGRAPH_LOG_H_
 
+#include <atomic>
+#include <limits>
 #include <string>
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/default/logging.h"
 #include "tensorflow/core/platform/macros.h"
 
+// VLOG levels above NGRAPH_TF_MAX_VLOG_LEVEL are compiled out. Set it with
+// the CMake option of the same name.
+#ifndef NGRAPH_TF_MAX_VLOG_LEVEL
+#define NGRAPH_TF_MAX_VLOG_LEVEL 1000
+#endif
+
 class NGraphLogMessage : public tensorflow::internal::LogMessage {
  public:
-  static tensorflow::int64 MinNGraphVLogLevel();
+  // The level is parsed from NGRAPH_TF_VLOG_LEVEL on first use, and can be
+  // changed at any time with SetMinNGraphVLogLevel.
+  static tensorflow::int64 MinNGraphVLogLevel() {
+    tensorflow::int64 level = s_min_vlog_level.load(std::memory_order_relaxed);
+    return level != kLevelUnset ? level : InitMinNGraphVLogLevel();
+  }
+  static void SetMinNGraphVLogLevel(tensorflow::int64 level);
+
+ private:
+  static constexpr tensorflow::int64 kLevelUnset =
+      std::numeric_limits<tensorflow::int64>::min();
+  static tensorflow::int64 InitMinNGraphVLogLevel();
+  static std::atomic<tensorflow::int64> s_min_vlog_level;
 };
 
-#define NGRAPH_VLOG_IS_ON(lvl) ((lvl) <= NGraphLogMessage::MinNGraphVLogLevel())
+#define NGRAPH_VLOG_IS_ON(lvl)          \
+  ((lvl) <= NGRAPH_TF_MAX_VLOG_LEVEL && \
+   (lvl) <= NGraphLogMessage::MinNGraphVLogLevel())
 
 #define NGRAPH_VLOG(lvl)      \
   if (NGRAPH_VLOG_IS_ON(lvl)) \
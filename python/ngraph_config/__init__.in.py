@@ -37,7 +37,20 @@ import ctypes
 
 __all__ = ['enable', 'disable', 'is_enabled', 'backends_len', 'list_backends',
     'set_backend', 'start_logging_placement', 'stop_logging_placement',
-    'is_logging_placement', '__version__']
+    'is_logging_placement', 'enable_cost_model', 'disable_cost_model',
+    'is_cost_model_enabled', 'set_min_cluster_flops_per_byte',
+    'get_min_cluster_flops_per_byte', 'set_cost_model_unknown_dim_size',
+    'get_cost_model_unknown_dim_size', 'enable_horizontal_merge',
+    'disable_horizontal_merge', 'is_horizontal_merge_enabled',
+    'set_cluster_profile_path',
+    'start_recording_cluster_profile', 'stop_recording_cluster_profile',
+    'is_recording_cluster_profile', 'enable_mixed_precision',
+    'disable_mixed_precision', 'is_mixed_precision_enabled', 'set_vlog_level',
+    'get_vlog_level', 'set_max_cluster_size', 'get_max_cluster_size',
+    'set_max_cluster_flops', 'get_max_cluster_flops',
+    'enable_recompile_fallback', 'disable_recompile_fallback',
+    'is_recompile_fallback_enabled', 'set_max_new_signature_rate',
+    'get_max_new_signature_rate', 'get_compile_count', '__version__']
 
 
 ext = 'dylib' if system() == 'Darwin' else 'so'
@@ -104,6 +117,28 @@ ngraph_bridge_lib.ngraph_is_enabled.restype = ctypes.c_bool
 ngraph_bridge_lib.ngraph_list_backends.restype = ctypes.c_bool
 ngraph_bridge_lib.ngraph_set_backend.restype = ctypes.c_bool
 ngraph_bridge_lib.ngraph_is_logging_placement.restype = ctypes.c_bool
+ngraph_bridge_lib.ngraph_is_cost_model_enabled.restype = ctypes.c_bool
+ngraph_bridge_lib.ngraph_is_horizontal_merge_enabled.restype = ctypes.c_bool
+ngraph_bridge_lib.ngraph_set_min_cluster_flops_per_byte.argtypes = [
+    ctypes.c_double]
+ngraph_bridge_lib.ngraph_get_min_cluster_flops_per_byte.restype = \
+    ctypes.c_double
+ngraph_bridge_lib.ngraph_set_cost_model_unknown_dim_size.argtypes = [
+    ctypes.c_int64]
+ngraph_bridge_lib.ngraph_get_cost_model_unknown_dim_size.restype = \
+    ctypes.c_int64
+ngraph_bridge_lib.ngraph_is_recording_cluster_profile.restype = ctypes.c_bool
+ngraph_bridge_lib.ngraph_is_mixed_precision_enabled.restype = ctypes.c_bool
+ngraph_bridge_lib.ngraph_set_vlog_level.argtypes = [ctypes.c_int64]
+ngraph_bridge_lib.ngraph_get_vlog_level.restype = ctypes.c_int64
+ngraph_bridge_lib.ngraph_set_max_cluster_size.argtypes = [ctypes.c_int64]
+ngraph_bridge_lib.ngraph_get_max_cluster_size.restype = ctypes.c_int64
+ngraph_bridge_lib.ngraph_set_max_cluster_flops.argtypes = [ctypes.c_int64]
+ngraph_bridge_lib.ngraph_get_max_cluster_flops.restype = ctypes.c_int64
+ngraph_bridge_lib.ngraph_is_recompile_fallback_enabled.restype = ctypes.c_bool
+ngraph_bridge_lib.ngraph_set_max_new_signature_rate.argtypes = [ctypes.c_double]
+ngraph_bridge_lib.ngraph_get_max_new_signature_rate.restype = ctypes.c_double
+ngraph_bridge_lib.ngraph_get_compile_count.restype = ctypes.c_int64
 ngraph_bridge_lib.ngraph_tf_version.restype = ctypes.c_char_p
 
 def enable():
@@ -145,5 +180,121 @@ def stop_logging_placement():
 
 def is_logging_placement():
   return ngraph_bridge_lib.ngraph_is_logging_placement()
+
+
+def enable_cost_model():
+  ngraph_bridge_lib.ngraph_enable_cost_model()
+
+
+def disable_cost_model():
+  ngraph_bridge_lib.ngraph_disable_cost_model()
+
+
+def is_cost_model_enabled():
+  return ngraph_bridge_lib.ngraph_is_cost_model_enabled()
+
+
+def set_min_cluster_flops_per_byte(flops_per_byte):
+  ngraph_bridge_lib.ngraph_set_min_cluster_flops_per_byte(flops_per_byte)
+
+
+def get_min_cluster_flops_per_byte():
+  return ngraph_bridge_lib.ngraph_get_min_cluster_flops_per_byte()
+
+
+def set_cost_model_unknown_dim_size(dim_size):
+  ngraph_bridge_lib.ngraph_set_cost_model_unknown_dim_size(dim_size)
+
+
+def get_cost_model_unknown_dim_size():
+  return ngraph_bridge_lib.ngraph_get_cost_model_unknown_dim_size()
+
+
+def enable_horizontal_merge():
+  ngraph_bridge_lib.ngraph_enable_horizontal_merge()
+
+
+def disable_horizontal_merge():
+  ngraph_bridge_lib.ngraph_disable_horizontal_merge()
+
+
+def is_horizontal_merge_enabled():
+  return ngraph_bridge_lib.ngraph_is_horizontal_merge_enabled()
+
+
+def set_cluster_profile_path(path):
+  ngraph_bridge_lib.ngraph_set_cluster_profile_path(path.encode('utf-8'))
+
+
+def start_recording_cluster_profile():
+  ngraph_bridge_lib.ngraph_start_recording_cluster_profile()
+
+
+def stop_recording_cluster_profile():
+  ngraph_bridge_lib.ngraph_stop_recording_cluster_profile()
+
+
+def is_recording_cluster_profile():
+  return ngraph_bridge_lib.ngraph_is_recording_cluster_profile()
+
+
+def enable_mixed_precision():
+  ngraph_bridge_lib.ngraph_enable_mixed_precision()
+
+
+def disable_mixed_precision():
+  ngraph_bridge_lib.ngraph_disable_mixed_precision()
+
+
+def is_mixed_precision_enabled():
+  return ngraph_bridge_lib.ngraph_is_mixed_precision_enabled()
+
+
+def set_vlog_level(level):
+  ngraph_bridge_lib.ngraph_set_vlog_level(level)
+
+
+def get_vlog_level():
+  return ngraph_bridge_lib.ngraph_get_vlog_level()
+
+
+def set_max_cluster_size(size):
+  ngraph_bridge_lib.ngraph_set_max_cluster_size(size)
+
+
+def get_max_cluster_size():
+  return ngraph_bridge_lib.ngraph_get_max_cluster_size()
+
+
+def set_max_cluster_flops(flops):
+  ngraph_bridge_lib.ngraph_set_max_cluster_flops(flops)
+
+
+def get_max_cluster_flops():
+  return ngraph_bridge_lib.ngraph_get_max_cluster_flops()
+
+
+def enable_recompile_fallback():
+  ngraph_bridge_lib.ngraph_enable_recompile_fallback()
+
+
+def disable_recompile_fallback():
+  ngraph_bridge_lib.ngraph_disable_recompile_fallback()
+
+
+def is_recompile_fallback_enabled():
+  return ngraph_bridge_lib.ngraph_is_recompile_fallback_enabled()
+
+
+def set_max_new_signature_rate(rate):
+  ngraph_bridge_lib.ngraph_set_max_new_signature_rate(rate)
+
+
+def get_max_new_signature_rate():
+  return ngraph_bridge_lib.ngraph_get_max_new_signature_rate()
+
+
+def get_compile_count():
+  return ngraph_bridge_lib.ngraph_get_compile_count()
  
 __version__ = ngraph_bridge_lib.ngraph_tf_version()
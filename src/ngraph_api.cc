@@ -13,9 +13,14 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  *******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
 #include "ngraph/runtime/backend.hpp"
 
 #include "ngraph_api.h"
+#include "ngraph_log.h"
 
 namespace tensorflow {
 namespace ngraph_bridge {
@@ -23,6 +28,18 @@ namespace config {
 
 static bool _is_enabled = true;
 static bool _is_logging_placement = false;
+static bool _is_cost_model_enabled = false;
+static double _min_cluster_flops_per_byte = 0.5;
+static int64_t _cost_model_unknown_dim_size = 32;
+static bool _is_horizontal_merge_enabled = false;
+static string _cluster_profile_path;
+static bool _is_recording_cluster_profile = false;
+static bool _is_mixed_precision_enabled = false;
+static int64_t _max_cluster_size = -1;
+static int64_t _max_cluster_flops = -1;
+static bool _is_recompile_fallback_disabled = false;
+static double _max_new_signature_rate = -1;
+static std::atomic<int64_t> _compile_count(0);
 
 extern "C" {
 void ngraph_enable() { Enable(); }
@@ -51,6 +68,62 @@ bool ngraph_set_backend(const char* backend) {
 void ngraph_start_logging_placement() { StartLoggingPlacement(); }
 void ngraph_stop_logging_placement() { StopLoggingPlacement(); }
 bool ngraph_is_logging_placement() { return IsLoggingPlacement(); }
+
+void ngraph_enable_cost_model() { EnableCostModel(); }
+void ngraph_disable_cost_model() { DisableCostModel(); }
+bool ngraph_is_cost_model_enabled() { return IsCostModelEnabled(); }
+void ngraph_set_min_cluster_flops_per_byte(double flops_per_byte) {
+  SetMinClusterFlopsPerByte(flops_per_byte);
+}
+double ngraph_get_min_cluster_flops_per_byte() {
+  return GetMinClusterFlopsPerByte();
+}
+void ngraph_set_cost_model_unknown_dim_size(int64_t dim_size) {
+  SetCostModelUnknownDimSize(dim_size);
+}
+int64_t ngraph_get_cost_model_unknown_dim_size() {
+  return GetCostModelUnknownDimSize();
+}
+void ngraph_enable_horizontal_merge() { EnableHorizontalMerge(); }
+void ngraph_disable_horizontal_merge() { DisableHorizontalMerge(); }
+bool ngraph_is_horizontal_merge_enabled() {
+  return IsHorizontalMergeEnabled();
+}
+
+void ngraph_set_cluster_profile_path(const char* path) {
+  SetClusterProfilePath(string(path));
+}
+void ngraph_start_recording_cluster_profile() {
+  StartRecordingClusterProfile();
+}
+void ngraph_stop_recording_cluster_profile() { StopRecordingClusterProfile(); }
+bool ngraph_is_recording_cluster_profile() {
+  return IsRecordingClusterProfile();
+}
+
+void ngraph_enable_mixed_precision() { EnableMixedPrecision(); }
+void ngraph_disable_mixed_precision() { DisableMixedPrecision(); }
+bool ngraph_is_mixed_precision_enabled() { return IsMixedPrecisionEnabled(); }
+
+void ngraph_set_vlog_level(int64_t level) { SetVLogLevel(level); }
+int64_t ngraph_get_vlog_level() { return GetVLogLevel(); }
+
+void ngraph_set_max_cluster_size(int64_t size) { SetMaxClusterSize(size); }
+int64_t ngraph_get_max_cluster_size() { return GetMaxClusterSize(); }
+void ngraph_set_max_cluster_flops(int64_t flops) { SetMaxClusterFlops(flops); }
+int64_t ngraph_get_max_cluster_flops() { return GetMaxClusterFlops(); }
+
+void ngraph_enable_recompile_fallback() { EnableRecompileFallback(); }
+void ngraph_disable_recompile_fallback() { DisableRecompileFallback(); }
+bool ngraph_is_recompile_fallback_enabled() {
+  return IsRecompileFallbackEnabled();
+}
+void ngraph_set_max_new_signature_rate(double rate) {
+  SetMaxNewSignatureRate(rate);
+}
+double ngraph_get_max_new_signature_rate() { return GetMaxNewSignatureRate(); }
+
+int64_t ngraph_get_compile_count() { return GetCompileCount(); }
 }
 
 // note that TensorFlow always uses camel case for the C++ API, but not for
@@ -80,6 +153,90 @@ bool IsLoggingPlacement() {
                          std::getenv("NGRAPH_TF_LOG_PLACEMENT") != nullptr);
 }
 
+void EnableCostModel() { _is_cost_model_enabled = true; }
+void DisableCostModel() { _is_cost_model_enabled = false; }
+bool IsCostModelEnabled() {
+  return _is_cost_model_enabled ||
+         std::getenv("NGRAPH_TF_ENABLE_COST_MODEL") != nullptr;
+}
+void SetMinClusterFlopsPerByte(double flops_per_byte) {
+  _min_cluster_flops_per_byte = flops_per_byte;
+}
+double GetMinClusterFlopsPerByte() { return _min_cluster_flops_per_byte; }
+void SetCostModelUnknownDimSize(int64_t dim_size) {
+  _cost_model_unknown_dim_size = dim_size;
+}
+int64_t GetCostModelUnknownDimSize() { return _cost_model_unknown_dim_size; }
+void EnableHorizontalMerge() { _is_horizontal_merge_enabled = true; }
+void DisableHorizontalMerge() { _is_horizontal_merge_enabled = false; }
+bool IsHorizontalMergeEnabled() {
+  return _is_horizontal_merge_enabled ||
+         std::getenv("NGRAPH_TF_HORIZONTAL_MERGE") != nullptr;
+}
+
+void SetClusterProfilePath(const string& path) { _cluster_profile_path = path; }
+string GetClusterProfilePath() {
+  if (!_cluster_profile_path.empty()) {
+    return _cluster_profile_path;
+  }
+  const char* path = std::getenv("NGRAPH_TF_CLUSTER_PROFILE");
+  return path == nullptr ? "" : path;
+}
+void StartRecordingClusterProfile() { _is_recording_cluster_profile = true; }
+void StopRecordingClusterProfile() { _is_recording_cluster_profile = false; }
+bool IsRecordingClusterProfile() {
+  return !GetClusterProfilePath().empty() &&
+         (_is_recording_cluster_profile ||
+          std::getenv("NGRAPH_TF_RECORD_CLUSTER_PROFILE") != nullptr);
+}
+
+void EnableMixedPrecision() { _is_mixed_precision_enabled = true; }
+void DisableMixedPrecision() { _is_mixed_precision_enabled = false; }
+bool IsMixedPrecisionEnabled() {
+  return _is_mixed_precision_enabled ||
+         std::getenv("NGRAPH_TF_MIXED_PRECISION") != nullptr;
+}
+
+void SetVLogLevel(int64_t level) {
+  NGraphLogMessage::SetMinNGraphVLogLevel(level);
+}
+int64_t GetVLogLevel() { return NGraphLogMessage::MinNGraphVLogLevel(); }
+
+// A limit set through the API wins; otherwise it comes from "env_var".
+static int64_t GetLimit(int64_t limit, const char* env_var) {
+  if (limit >= 0) {
+    return limit;
+  }
+  const char* value = std::getenv(env_var);
+  return value == nullptr ? 0 : std::max<int64_t>(0, std::atoll(value));
+}
+void SetMaxClusterSize(int64_t size) { _max_cluster_size = size; }
+int64_t GetMaxClusterSize() {
+  return GetLimit(_max_cluster_size, "NGRAPH_TF_MAX_CLUSTER_SIZE");
+}
+void SetMaxClusterFlops(int64_t flops) { _max_cluster_flops = flops; }
+int64_t GetMaxClusterFlops() {
+  return GetLimit(_max_cluster_flops, "NGRAPH_TF_MAX_CLUSTER_FLOPS");
+}
+
+void EnableRecompileFallback() { _is_recompile_fallback_disabled = false; }
+void DisableRecompileFallback() { _is_recompile_fallback_disabled = true; }
+bool IsRecompileFallbackEnabled() {
+  return !_is_recompile_fallback_disabled &&
+         std::getenv("NGRAPH_TF_DISABLE_RECOMPILE_FALLBACK") == nullptr;
+}
+void SetMaxNewSignatureRate(double rate) { _max_new_signature_rate = rate; }
+double GetMaxNewSignatureRate() {
+  if (_max_new_signature_rate >= 0) {
+    return _max_new_signature_rate;
+  }
+  const char* rate = std::getenv("NGRAPH_TF_MAX_NEW_SIGNATURE_RATE");
+  return rate == nullptr ? 0.5 : std::max(0.0, std::atof(rate));
+}
+
+void CountCompile() { _compile_count++; }
+int64_t GetCompileCount() { return _compile_count; }
+
 }  // namespace config
 }  // namespace ngraph_bridge
 }  // namespace tensorflow
@@ -15,6 +15,7 @@
  *******************************************************************************/
 #pragma once
 
+#include <stdint.h>
 #include <string.h>
 #include <vector>
 
@@ -37,6 +38,42 @@ extern bool ngraph_set_backend(const char* backend);
 extern void ngraph_start_logging_placement();
 extern void ngraph_stop_logging_placement();
 extern bool ngraph_is_logging_placement();
+
+extern void ngraph_enable_cost_model();
+extern void ngraph_disable_cost_model();
+extern bool ngraph_is_cost_model_enabled();
+extern void ngraph_set_min_cluster_flops_per_byte(double flops_per_byte);
+extern double ngraph_get_min_cluster_flops_per_byte();
+extern void ngraph_set_cost_model_unknown_dim_size(int64_t dim_size);
+extern int64_t ngraph_get_cost_model_unknown_dim_size();
+extern void ngraph_enable_horizontal_merge();
+extern void ngraph_disable_horizontal_merge();
+extern bool ngraph_is_horizontal_merge_enabled();
+
+extern void ngraph_set_cluster_profile_path(const char* path);
+extern void ngraph_start_recording_cluster_profile();
+extern void ngraph_stop_recording_cluster_profile();
+extern bool ngraph_is_recording_cluster_profile();
+
+extern void ngraph_enable_mixed_precision();
+extern void ngraph_disable_mixed_precision();
+extern bool ngraph_is_mixed_precision_enabled();
+
+extern void ngraph_set_vlog_level(int64_t level);
+extern int64_t ngraph_get_vlog_level();
+
+extern void ngraph_set_max_cluster_size(int64_t size);
+extern int64_t ngraph_get_max_cluster_size();
+extern void ngraph_set_max_cluster_flops(int64_t flops);
+extern int64_t ngraph_get_max_cluster_flops();
+
+extern void ngraph_enable_recompile_fallback();
+extern void ngraph_disable_recompile_fallback();
+extern bool ngraph_is_recompile_fallback_enabled();
+extern void ngraph_set_max_new_signature_rate(double rate);
+extern double ngraph_get_max_new_signature_rate();
+
+extern int64_t ngraph_get_compile_count();
 }
 
 extern void Enable();
@@ -51,6 +88,73 @@ extern tensorflow::Status SetBackend(const string& type);
 extern void StartLoggingPlacement();
 extern void StopLoggingPlacement();
 extern bool IsLoggingPlacement();
+
+// When the cost model is enabled, cluster formation prefers contracting the
+// edges carrying the most bytes, and clusters whose estimated flops do not
+// reach min_cluster_flops_per_byte times the bytes crossing their boundary
+// are deassigned. Unknown dimensions are estimated as unknown_dim_size.
+extern void EnableCostModel();
+extern void DisableCostModel();
+extern bool IsCostModelEnabled();
+extern void SetMinClusterFlopsPerByte(double flops_per_byte);
+extern double GetMinClusterFlopsPerByte();
+extern void SetCostModelUnknownDimSize(int64_t dim_size);
+extern int64_t GetCostModelUnknownDimSize();
+
+// With horizontal merging enabled, and the cost model as well, sibling
+// clusters that cannot form a cycle are merged when one of them does not pay
+// for its own dispatch (see ngraph_assign_clusters.cc). Also enabled by
+// NGRAPH_TF_HORIZONTAL_MERGE.
+extern void EnableHorizontalMerge();
+extern void DisableHorizontalMerge();
+extern bool IsHorizontalMergeEnabled();
+
+// Profile-guided declustering (see ngraph_cluster_profile.h). While recording,
+// cluster timings are written to the profile path; otherwise clusters that the
+// profile shows to be slower than TF are deassigned.
+extern void SetClusterProfilePath(const string& path);
+extern string GetClusterProfilePath();
+extern void StartRecordingClusterProfile();
+extern void StopRecordingClusterProfile();
+extern bool IsRecordingClusterProfile();
+
+// In mixed precision mode, convolutions and dot products in clusters run in
+// bf16 (see ngraph_mixed_precision.cc). This applies to clusters translated
+// after the call.
+extern void EnableMixedPrecision();
+extern void DisableMixedPrecision();
+extern bool IsMixedPrecisionEnabled();
+
+// The NGRAPH_VLOG level, initially taken from NGRAPH_TF_VLOG_LEVEL. Levels
+// above the NGRAPH_TF_MAX_VLOG_LEVEL the bridge was built with stay off.
+extern void SetVLogLevel(int64_t level);
+extern int64_t GetVLogLevel();
+
+// Clusters with more than max_cluster_size ops, or more estimated flops than
+// max_cluster_flops, are split into parts within the limits (see
+// ngraph_assign_clusters.cc). Zero means no limit; the defaults come from
+// NGRAPH_TF_MAX_CLUSTER_SIZE and NGRAPH_TF_MAX_CLUSTER_FLOPS.
+extern void SetMaxClusterSize(int64_t size);
+extern int64_t GetMaxClusterSize();
+extern void SetMaxClusterFlops(int64_t flops);
+extern int64_t GetMaxClusterFlops();
+
+// A cluster that compiles a function for a new input signature on more than
+// max_new_signature_rate of its calls runs with TensorFlow from then on (see
+// ngraph_encapsulate_op.cc). The rate defaults to 0.5, or comes from
+// NGRAPH_TF_MAX_NEW_SIGNATURE_RATE; the fallback is disabled by
+// DisableRecompileFallback or NGRAPH_TF_DISABLE_RECOMPILE_FALLBACK. This
+// applies to clusters whose kernels are created after the call.
+extern void EnableRecompileFallback();
+extern void DisableRecompileFallback();
+extern bool IsRecompileFallbackEnabled();
+extern void SetMaxNewSignatureRate(double rate);
+extern double GetMaxNewSignatureRate();
+
+// The number of nGraph functions translated from clusters in this process.
+// Functions reused from NGraphFunctionRegistry are not counted again.
+extern void CountCompile();
+extern int64_t GetCompileCount();
 }  // namespace config
 }  // namespace ngraph_bridge
 }  // namespace tensorflow
@@ -16,20 +16,25 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/platform/default/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/util/device_name_utils.h"
 
+#include "ngraph_api.h"
 #include "ngraph_assign_clusters.h"
 #include "ngraph_cluster_manager.h"
+#include "ngraph_cost_model.h"
 #include "ngraph_log.h"
 #include "ngraph_mark_for_clustering.h"
+#include "ngraph_sink_static_inputs.h"
 #include "ngraph_utils.h"
 #include "tf_deadness_analysis.h"
 #include "tf_graphcycles.h"
@@ -71,7 +76,9 @@ namespace ngraph_bridge {
 // Other Constraints (Non Data Flow Constraints)
 //
 //   (1) If N1 is a static input to N2, N1 and N2 are not placed in the same
-//       cluster (More on static inputs in ngraph_mark_for_clustering)
+//       cluster (More on static inputs in ngraph_mark_for_clustering), unless
+//       N1 is a Const, or N1 was sunk by SinkStaticInputs and all the copies
+//       it is computed from can be placed in the cluster of N2
 //   (2) If N1 and N2 have mismatching deadness predicates, they are not
 //       placed in the same cluster (More on deadness in tf_deadness_analysis)
 //
@@ -311,6 +318,378 @@ void MergeClusters(Edge* edge,
   }
 }
 
+// Merges the cluster of "from" into the cluster of "into", where the two
+// clusters are not connected by any edge (see MergeSiblingClusters).
+// WARNING : Use this function when ready to merge
+void MergeUnconnectedClusters(
+    Node* into, Node* from,
+    std::map<Node*, std::shared_ptr<Cluster>>& cluster_map) {
+  NGRAPH_VLOG(5) << "Merging sibling clusters: " << into->name() << "@"
+                 << cluster_map[into]->index << " <- " << from->name() << "@"
+                 << cluster_map[from]->index;
+
+  auto cluster_from = cluster_map[from];
+
+#if !defined(NGRAPH_TF_DISABLE_DEADNESS_CHECK)
+  cluster_map[into]->outgoing_edges.insert(
+      cluster_from->outgoing_edges.begin(), cluster_from->outgoing_edges.end());
+#endif
+
+  for (auto node : cluster_from->nodes) {
+    cluster_map[into]->nodes.insert(node);
+    cluster_map[node] = cluster_map[into];
+  }
+}
+
+//
+// Horizontal merging. Contraction only ever merges along edges, so
+// independent branches (e.g. the parallel towers of an Inception block)
+// end up in separate clusters, each paying for its own kernel dispatch,
+// signature computation and backend lock. Here we merge clusters that are
+// siblings---they consume an output of the same node, or feed the same
+// node---as long as neither can reach the other, so that the merge cannot
+// introduce a cycle. Both clusters must also agree on backend and deadness
+// predicate.
+//
+// A merged cluster waits for the inputs of both halves, and TF can no longer
+// run them in parallel. Siblings are therefore only merged when the cost
+// model finds that at least one of them does not pay for its own dispatch
+// (see NGraphCostModel::ClusterIsProfitable); siblings that both do stay
+// apart.
+//
+// The merge is done in gc by inserting an edge between the two clusters and
+// contracting it; since there is no other path between them, contraction
+// always succeeds.
+//
+// Horizontal merging is off by default. It is enabled by
+// config::EnableHorizontalMerge() or by setting NGRAPH_TF_HORIZONTAL_MERGE=1,
+// and only takes effect when the cost model is enabled as well.
+//
+Status MergeSiblingClusters(
+    Graph* graph, GraphCycles& gc,
+    std::map<Node*, std::shared_ptr<Cluster>>& cluster_map) {
+  std::unique_ptr<NGraphCostModel> cost_model;
+  TF_RETURN_IF_ERROR(NGraphCostModel::Build(*graph, &cost_model));
+  auto is_profitable = [&cost_model](const Cluster& cluster) {
+    return NGraphCostModel::ClusterIsProfitable(
+        cost_model->ComputeClusterCost(cluster.nodes));
+  };
+
+  bool changed;
+
+  do {
+    changed = false;
+
+    for (auto node : graph->op_nodes()) {
+      // One representative node per distinct sibling cluster, for the
+      // consumers and for the producers of "node" respectively.
+      std::vector<std::vector<Node*>> sibling_groups(2);
+      std::set<Cluster*> seen;
+
+      for (auto edge : node->out_edges()) {
+        Node* dst = edge->dst();
+        if (!edge->IsControlEdge() && dst->IsOp() &&
+            NodeIsMarkedForClustering(dst) &&
+            seen.insert(cluster_map[dst].get()).second) {
+          sibling_groups[0].push_back(dst);
+        }
+      }
+
+      seen.clear();
+      for (auto edge : node->in_edges()) {
+        Node* src = edge->src();
+        if (!edge->IsControlEdge() && src->IsOp() &&
+            NodeIsMarkedForClustering(src) &&
+            seen.insert(cluster_map[src].get()).second) {
+          sibling_groups[1].push_back(src);
+        }
+      }
+
+      for (auto& siblings : sibling_groups) {
+        for (size_t i = 0; i < siblings.size(); i++) {
+          for (size_t j = i + 1; j < siblings.size(); j++) {
+            auto cluster_i = cluster_map[siblings[i]];
+            auto cluster_j = cluster_map[siblings[j]];
+            if (cluster_i == cluster_j ||
+                cluster_i->backend != cluster_j->backend) {
+              continue;
+            }
+#if !defined(NGRAPH_TF_DISABLE_DEADNESS_CHECK)
+            if (cluster_i->predicate_string != cluster_j->predicate_string) {
+              continue;
+            }
+#endif
+            if (gc.IsReachable(cluster_i->index, cluster_j->index) ||
+                gc.IsReachable(cluster_j->index, cluster_i->index)) {
+              continue;
+            }
+            if (is_profitable(*cluster_i) && is_profitable(*cluster_j)) {
+              continue;
+            }
+
+            if (!gc.InsertEdge(cluster_i->index, cluster_j->index)) {
+              return errors::Internal(
+                  "Unable to insert edge between sibling clusters ",
+                  cluster_i->index, " and ", cluster_j->index);
+            }
+            if (!gc.ContractEdge(cluster_i->index, cluster_j->index)) {
+              return errors::Internal("Unable to merge sibling clusters ",
+                                      cluster_i->index, " and ",
+                                      cluster_j->index);
+            }
+            MergeUnconnectedClusters(siblings[i], siblings[j], cluster_map);
+            changed = true;
+          }
+        }
+      }
+    }
+  } while (changed);
+
+  return Status::OK();
+}
+
+// Collects the sunk static input copies that "node" is computed from,
+// including "node" itself.
+void CollectSunkChain(Node* node, std::set<Node*>& chain) {
+  if (!IsSunkStaticInput(node) || !chain.insert(node).second) {
+    return;
+  }
+  for (auto edge : node->in_edges()) {
+    if (!edge->IsControlEdge()) {
+      CollectSunkChain(edge->src(), chain);
+    }
+  }
+}
+
+// The value of a static input computed by copies that SinkStaticInputs made
+// can only be folded if all of them are in the cluster of its consumer. The
+// copies feeding "static_edges" (all into the same consumer) are contracted
+// into that cluster before anything else, when deadness and backends allow it
+// for all of them; otherwise "contracted" is false and the static inputs get
+// shadow edges like any other.
+Status ContractSunkStaticInputs(
+    const std::vector<const Edge*>& static_edges, GraphCycles& gc,
+    std::map<Node*, std::shared_ptr<Cluster>>& cluster_map, bool* contracted) {
+  *contracted = false;
+  Node* consumer = static_edges[0]->dst();
+  std::set<Node*> chain;
+  for (auto edge : static_edges) {
+    CollectSunkChain(edge->src(), chain);
+  }
+  for (auto node : chain) {
+    if (!NodeIsMarkedForClustering(node) ||
+        cluster_map[node]->backend != cluster_map[consumer]->backend) {
+      return Status::OK();
+    }
+#if !defined(NGRAPH_TF_DISABLE_DEADNESS_CHECK)
+    // Copies of Consts have the True predicate, which merges with any other.
+    const string& predicate = cluster_map[node]->predicate_string;
+    if (!DeadnessAnalysis::IsTruePredString(predicate) &&
+        predicate != cluster_map[consumer]->predicate_string) {
+      return Status::OK();
+    }
+#endif
+  }
+
+  // The copies only feed each other and the consumer, so contracting them
+  // into it, starting from the consumer, cannot introduce a cycle.
+  std::vector<const Edge*> pending(static_edges);
+  while (!pending.empty()) {
+    const Edge* edge = pending.back();
+    pending.pop_back();
+    Node* src = edge->src();
+    if (cluster_map[src] == cluster_map[consumer]) {
+      continue;
+    }
+    int src_index = cluster_map[src]->index;
+    int dst_index = cluster_map[edge->dst()]->index;
+    if (!gc.HasEdge(src_index, dst_index) ||
+        !gc.ContractEdge(src_index, dst_index)) {
+      return errors::Internal("Unable to contract sunk static input ",
+                              src->name(), " into ", consumer->name());
+    }
+    MergeClusters(const_cast<Edge*>(edge), cluster_map);
+    for (auto in_edge : src->in_edges()) {
+      if (!in_edge->IsControlEdge() && chain.count(in_edge->src()) != 0) {
+        pending.push_back(in_edge);
+      }
+    }
+  }
+  *contracted = true;
+  return Status::OK();
+}
+
+// Appends the sunk static input copies in "cluster_nodes" that "node" reads,
+// and then "node" itself, to "order".
+void AppendWithSunkInputs(Node* node, const std::set<Node*>& cluster_nodes,
+                          std::set<Node*>& appended,
+                          std::vector<Node*>& order) {
+  if (!appended.insert(node).second) {
+    return;
+  }
+  for (auto edge : node->in_edges()) {
+    if (!edge->IsControlEdge() && IsSunkStaticInput(edge->src()) &&
+        cluster_nodes.count(edge->src()) != 0) {
+      AppendWithSunkInputs(edge->src(), cluster_nodes, appended, order);
+    }
+  }
+  order.push_back(node);
+}
+
+//
+// Cluster splitting. Backend compile time grows faster than linearly with the
+// size of a function, so a maximal cluster of a large training graph can take
+// minutes (and a lot of memory) to compile on the first step. When
+// config::GetMaxClusterSize() (in ops) or config::GetMaxClusterFlops() (as
+// estimated by the cost model) is set, larger clusters are split into parts
+// within the limits.
+//
+// The parts are contiguous ranges of a topological order of the cluster.
+// Every edge inside the cluster goes forward in that order, and no path that
+// leaves the cluster comes back to it, so the parts cannot form a cycle. Each
+// part ends where the fewest tensor bytes cross from it into the rest of the
+// cluster, among the points where it is at least half full.
+//
+// The copies that SinkStaticInputs made for a static input are only folded
+// if they are in the same cluster as their consumer, so each chain of them is
+// ordered right before its consumer and no part ends inside it. A part can
+// exceed the limits by the length of such a chain.
+//
+Status SplitOversizedClusters(
+    Graph* graph, GraphCycles& gc,
+    std::map<Node*, std::shared_ptr<Cluster>>& cluster_map) {
+  const int64 max_size = config::GetMaxClusterSize();
+  const int64 max_flops = config::GetMaxClusterFlops();
+
+  std::unique_ptr<NGraphCostModel> cost_model;
+  TF_RETURN_IF_ERROR(NGraphCostModel::Build(*graph, &cost_model));
+
+  std::vector<Node*> order;
+  GetReversePostOrder(*graph, &order);
+  std::map<Node*, size_t> position;
+  for (size_t i = 0; i < order.size(); i++) {
+    position[order[i]] = i;
+  }
+
+  std::set<std::shared_ptr<Cluster>> clusters;
+  for (auto& kv : cluster_map) {
+    clusters.insert(kv.second);
+  }
+
+  for (auto cluster : clusters) {
+    std::vector<Node*> sorted(cluster->nodes.begin(), cluster->nodes.end());
+    if (sorted.size() < 2 || !NodeIsMarkedForClustering(sorted[0])) {
+      continue;
+    }
+    std::sort(sorted.begin(), sorted.end(), [&position](Node* n1, Node* n2) {
+      return position[n1] < position[n2];
+    });
+    // Sunk copies whose consumer is in another cluster only feed each other,
+    // so they can go last.
+    std::vector<Node*> nodes;
+    std::set<Node*> appended;
+    for (auto node : sorted) {
+      if (!IsSunkStaticInput(node)) {
+        AppendWithSunkInputs(node, cluster->nodes, appended, nodes);
+      }
+    }
+    for (auto node : sorted) {
+      if (appended.insert(node).second) {
+        nodes.push_back(node);
+      }
+    }
+    std::map<Node*, size_t> index;
+    for (size_t i = 0; i < nodes.size(); i++) {
+      index[nodes[i]] = i;
+    }
+
+    auto exceeds = [max_size, max_flops](int64 size, int64 flops) {
+      return (max_size > 0 && size > max_size) ||
+             (max_flops > 0 && flops > max_flops);
+    };
+    auto half_full = [max_size, max_flops](int64 size, int64 flops) {
+      return (max_size > 0 && 2 * size >= max_size) ||
+             (max_flops > 0 && 2 * flops >= max_flops);
+    };
+
+    // The index of the first node of each part.
+    std::vector<size_t> part_begins;
+    size_t begin = 0;
+    while (begin < nodes.size()) {
+      part_begins.push_back(begin);
+      int64 flops = 0;
+      // Bytes on the edges from [begin, end) to the rest of the cluster.
+      int64 crossing_bytes = 0;
+      int64 best_bytes = std::numeric_limits<int64>::max();
+      size_t best_end = 0;
+      size_t end = begin;
+      while (end < nodes.size()) {
+        Node* node = nodes[end];
+        int64 node_flops = cost_model->GetNodeCost(node).flops;
+        if (end > begin && !IsSunkStaticInput(nodes[end - 1]) &&
+            exceeds(end + 1 - begin, flops + node_flops)) {
+          break;
+        }
+        flops += node_flops;
+        for (auto edge : node->in_edges()) {
+          auto src = index.find(edge->src());
+          if (!edge->IsControlEdge() && src != index.end() &&
+              src->second >= begin) {
+            crossing_bytes -= cost_model->GetEdgeBytes(edge);
+          }
+        }
+        for (auto edge : node->out_edges()) {
+          if (!edge->IsControlEdge() && index.count(edge->dst()) != 0) {
+            crossing_bytes += cost_model->GetEdgeBytes(edge);
+          }
+        }
+        end++;
+        if (!IsSunkStaticInput(node) && half_full(end - begin, flops) &&
+            crossing_bytes <= best_bytes) {
+          best_bytes = crossing_bytes;
+          best_end = end;
+        }
+      }
+      begin = (end == nodes.size() || best_end == 0) ? end : best_end;
+    }
+
+    if (part_begins.size() < 2) {
+      continue;
+    }
+    NGRAPH_VLOG(2) << "Splitting cluster " << cluster->index << " of "
+                   << nodes.size() << " ops into " << part_begins.size()
+                   << " parts";
+
+    part_begins.push_back(nodes.size());
+    for (size_t part = 1; part + 1 < part_begins.size(); part++) {
+      auto new_cluster = std::make_shared<Cluster>();
+      new_cluster->index = gc.NewNode();
+      new_cluster->backend = cluster->backend;
+#if !defined(NGRAPH_TF_DISABLE_DEADNESS_CHECK)
+      new_cluster->predicate_string = cluster->predicate_string;
+#endif
+      for (size_t i = part_begins[part]; i < part_begins[part + 1]; i++) {
+        cluster->nodes.erase(nodes[i]);
+        new_cluster->nodes.insert(nodes[i]);
+        cluster_map[nodes[i]] = new_cluster;
+      }
+    }
+  }
+
+#if !defined(NGRAPH_TF_DISABLE_DEADNESS_CHECK)
+  for (auto& kv : cluster_map) {
+    kv.second->outgoing_edges.clear();
+  }
+  for (auto edge : graph->edges()) {
+    if (cluster_map[edge->src()] != cluster_map[edge->dst()]) {
+      cluster_map[edge->src()]->outgoing_edges.insert(edge);
+    }
+  }
+#endif
+
+  return Status::OK();
+}
+
 }  // namespace
 
 // Main Entry point for Cluster Assignment to the Node
@@ -412,29 +791,68 @@ Status AssignClusters(Graph* graph) {
     if (static_inputs.size() > 0) {
       std::vector<const Edge*> edges_to_node;
       TF_RETURN_IF_ERROR(node->input_edges(&edges_to_node));
+      std::vector<const Edge*> shadowed_edges;
+      std::vector<const Edge*> sunk_edges;
       for (auto static_inp_idx : static_inputs) {
         auto static_edge = edges_to_node[static_inp_idx];
-        if (static_edge->src()->type_string() != "Const") {
-          int shadow_node_index = gc.NewNode();
-          bool gc_success = gc.InsertEdge(
-              cluster_map[static_edge->src()]->index, shadow_node_index);
-          gc_success &= gc.InsertEdge(shadow_node_index,
-                                      cluster_map[static_edge->dst()]->index);
-          if (!gc_success)
-            return errors::Internal(
-                "Unable to create shadow edges in GraphCycles");
+        if (static_edge->src()->type_string() == "Const") {
+          continue;
+        }
+        if (IsSunkStaticInput(static_edge->src())) {
+          sunk_edges.push_back(static_edge);
+        } else {
+          shadowed_edges.push_back(static_edge);
+        }
+      }
+      if (!sunk_edges.empty()) {
+        bool contracted = false;
+        TF_RETURN_IF_ERROR(
+            ContractSunkStaticInputs(sunk_edges, gc, cluster_map, &contracted));
+        if (!contracted) {
+          shadowed_edges.insert(shadowed_edges.end(), sunk_edges.begin(),
+                                sunk_edges.end());
         }
       }
+      for (auto static_edge : shadowed_edges) {
+        int shadow_node_index = gc.NewNode();
+        bool gc_success = gc.InsertEdge(cluster_map[static_edge->src()]->index,
+                                        shadow_node_index);
+        gc_success &= gc.InsertEdge(shadow_node_index,
+                                    cluster_map[static_edge->dst()]->index);
+        if (!gc_success)
+          return errors::Internal(
+              "Unable to create shadow edges in GraphCycles");
+      }
     }
   }
 
+  // By default we try to contract edges in graph order. With the cost model
+  // enabled, the edges carrying the most bytes are tried first: when two
+  // contractions exclude each other (because making one would introduce a
+  // cycle for the other), the one that keeps the larger tensor inside a
+  // cluster wins.
+  std::vector<Edge*> contraction_order;
+  for (auto edge : graph->edges()) {
+    contraction_order.push_back(edge);
+  }
+
+  if (config::IsCostModelEnabled()) {
+    std::unique_ptr<NGraphCostModel> cost_model;
+    TF_RETURN_IF_ERROR(NGraphCostModel::Build(*graph, &cost_model));
+    std::stable_sort(contraction_order.begin(), contraction_order.end(),
+                     [&cost_model](const Edge* e1, const Edge* e2) {
+                       return cost_model->GetEdgeBytes(e1) >
+                              cost_model->GetEdgeBytes(e2);
+                     });
+  }
+
   NGRAPH_VLOG(2) << "Starting contraction";
   bool changed;
 
   do {
     changed = false;
 
-    for (auto edge : graph->edges()) {
+    for (auto edge : contraction_order) {
       Node* src = edge->src();
       Node* dst = edge->dst();
 
@@ -493,6 +911,18 @@ Status AssignClusters(Graph* graph) {
   } while (changed);
   NGRAPH_VLOG(2) << "Contraction done";
 
+  if (config::IsHorizontalMergeEnabled() && config::IsCostModelEnabled()) {
+    NGRAPH_VLOG(2) << "Starting horizontal merging";
+    TF_RETURN_IF_ERROR(MergeSiblingClusters(graph, gc, cluster_map));
+    NGRAPH_VLOG(2) << "Horizontal merging done";
+  }
+
+  if (config::GetMaxClusterSize() > 0 || config::GetMaxClusterFlops() > 0) {
+    NGRAPH_VLOG(2) << "Starting cluster splitting";
+    TF_RETURN_IF_ERROR(SplitOversizedClusters(graph, gc, cluster_map));
+    NGRAPH_VLOG(2) << "Cluster splitting done";
+  }
+
   NGRAPH_VLOG(2) << "Starting tagging";
   std::set<Cluster*> seen;
 
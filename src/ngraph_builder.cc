@@ -15,8 +15,12 @@
  *******************************************************************************/
 
 #include "ngraph_builder.h"
+#include "ngraph_api.h"
+#include "ngraph_const_store.h"
 #include "ngraph_conversions.h"
 #include "ngraph_log.h"
+#include "ngraph_mixed_precision.h"
+#include "ngraph_transpose_sinking.h"
 #include "ngraph_utils.h"
 
 #include "ngraph/builder/autobroadcast.hpp"
@@ -56,52 +60,85 @@ static Status ValidateInputCountMin(const Node* op, size_t count) {
   }
   return Status::OK();
 }
+Builder::OpMap::OpMap(const Graph& graph)
+    : m_outputs(graph.num_node_ids()),
+      m_input_offsets(graph.num_node_ids() + 1) {
+  for (int id = 0; id < graph.num_node_ids(); id++) {
+    const Node* node = graph.FindNodeId(id);
+    m_input_offsets[id + 1] =
+        m_input_offsets[id] + (node == nullptr ? 0 : node->num_inputs());
+  }
+
+  m_inputs.assign(m_input_offsets.back(), Input{-1, -1});
+  for (auto edge : graph.edges()) {
+    if (edge->IsControlEdge()) {
+      continue;
+    }
+    Input& input = m_inputs[m_input_offsets[edge->dst()->id()] +
+                            edge->dst_input()];
+    input.src_id = edge->src()->id();
+    input.src_output = edge->src_output();
+  }
+}
+
+void Builder::OpMap::Save(const Node* node,
+                          const shared_ptr<ng::Node>& output) {
+  m_outputs[node->id()].push_back(output);
+}
+
+Status Builder::OpMap::GetInput(const Node* node, size_t input_index,
+                                shared_ptr<ng::Node>* result) const {
+  int offset = m_input_offsets[node->id()] + input_index;
+  if (offset >= m_input_offsets[node->id() + 1] ||
+      m_inputs[offset].src_id < 0) {
+    return Status(error::NOT_FOUND, "Edge not found");
+  }
+
+  const Input& input = m_inputs[offset];
+  const std::vector<shared_ptr<ng::Node>>& ng_op = m_outputs[input.src_id];
+  if (ng_op.empty()) {
+    return Status(error::NOT_FOUND,
+                  string("Ngraph op not found for input ") +
+                      to_string(input_index) + " of " + node->name());
+  }
+  if (input.src_output >= ng_op.size()) {
+    return Status(error::NOT_FOUND, string("Input node not found at index ") +
+                                        to_string(input.src_output));
+  }
+  *result = ng_op[input.src_output];
+  return Status::OK();
+}
+
 //
 // Helper for storing ops in ng_op_map.
 // For most of the cases, op would have one output so
-// vector ng_op_map[op_name] would contain one element.
+// ng_op_map would hold one ng::Node for it.
 //
 // If storing more than one output_nodes, make sure it's in
 // the same order as tensorflow would do that.
 //
 // Parameters:
 //    Builder::OpMap& ng_op_map        - The TF-to-nGraph op map.
-//    std::string op_name              - Name of the op.
+//    const Node* op                   - TF op being translated.
 //
 //    shared_ptr<ng::Node> output_node - ng::Node to store
 //
 
-static void SaveNgOp(Builder::OpMap& ng_op_map, const std::string& op_name,
+static void SaveNgOp(Builder::OpMap& ng_op_map, const Node* op,
                      const shared_ptr<ng::Node>& output_node) {
-  // no need to try-catch, map[key] will create vector object
-  // if not exists
-  ng_op_map[op_name].push_back(output_node);
+  ng_op_map.Save(op, output_node);
 }
 
 // Helper for fetching correct input node from ng_op_map.
 // Handles edge checking to make sure correct input node is
-// fetched.
-//
-// Reduces some boilerplate code (incorrect from now) like this:
-//
-//      Node* tf_input;
-//      TF_RETURN_IF_ERROR(op->input_node(0, &tf_input));
-//
-//      shared_ptr<ng::Node> ng_input;
-//      try {
-//        ng_input = ng_op_map.at(tf_input->name());
-//      } catch (const std::out_of_range&) {
-//        return errors::NotFound(tf_input->name(),
-//                                    " is not found in the ng_op_map");
-//      }
+// fetched (an input op may have resulted in more than one ng::Node, e.g.
+// Split).
 //
-// Into 2 lines:
+// Usage:
 //
 //      shared_ptr<ng::node> ng_input;
 //      TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, op, 0, &ng_input))
 //
-//
-//
 // Parameters:
 //    Builder::OpMap& ng_op_map     - The TF-to-nGraph op map.
 //    Node* op                  - TF op being translated.
@@ -110,37 +147,10 @@ static void SaveNgOp(Builder::OpMap& ng_op_map, const std::string& op_name,
 //    shared_ptr<ng::Node> *result  - ng::Node pointer where result
 //                                    will be written
 //
-//
 
 static Status GetInputNode(const Builder::OpMap& ng_op_map, const Node* op,
                            size_t input_idx, shared_ptr<ng::Node>* result) {
-  // input op may have resulted in more than one ng::Node (eg. Split)
-  // we need to look at Edge to check index of the input op
-  std::vector<const Edge*> edges;
-  TF_RETURN_IF_ERROR(op->input_edges(&edges));
-  size_t src_output_idx;
-  try {
-    src_output_idx = edges.at(input_idx)->src_output();
-  } catch (const out_of_range&) {
-    return Status(error::NOT_FOUND, "Edge not found");
-  }
-
-  Node* tf_input;
-  TF_RETURN_IF_ERROR(op->input_node(input_idx, &tf_input));
-  const std::vector<shared_ptr<ng::Node>>* ng_op = nullptr;
-  try {
-    ng_op = &ng_op_map.at(tf_input->name());
-  } catch (const out_of_range&) {
-    return Status(error::NOT_FOUND,
-                  string("Ngraph op not found for ") + tf_input->name());
-  }
-  try {
-    *result = ng_op->at(src_output_idx);
-  } catch (const out_of_range&) {
-    return Status(error::NOT_FOUND, string("Input node not found at index ") +
-                                        to_string(src_output_idx));
-  }
-  return Status::OK();
+  return ng_op_map.GetInput(op, input_idx, result);
 }
 
 namespace detail {
@@ -183,6 +193,9 @@ static Status GetStaticNodeTensor(
     *result = *source_tensor;
     return Status::OK();
   } else if (node->type_string() == "Const") {
+    if (NGraphConstStore::Lookup(node->def(), result)) {
+      return Status::OK();
+    }
     if (!result->FromProto(node->def().attr().at("value").tensor())) {
       return errors::Internal(
           "GetStaticNodeTensor: Const tensor proto parsing failed");
@@ -277,6 +290,21 @@ static Status GetStaticInputVector(
 template <typename T, typename VecT = T>
 static Status MakeConstOp(const Node* op, ng::element::Type et,
                           std::shared_ptr<ng::Node>* ng_node) {
+  // Large values live in the constant store; copy them into the Constant
+  // directly from the shared buffer.
+  if (NGraphConstStore::IsExternalized(op->def())) {
+    Tensor value;
+    if (!NGraphConstStore::Lookup(op->def(), &value)) {
+      return errors::Internal("Value of Const ", op->name(),
+                              " is missing from the constant store");
+    }
+    ng::Shape ng_shape;
+    TF_RETURN_IF_ERROR(TFTensorShapeToNGraphShape(value.shape(), &ng_shape));
+    *ng_node = make_shared<ng::op::Constant>(et, ng_shape,
+                                             value.tensor_data().data());
+    return Status::OK();
+  }
+
   vector<VecT> const_values;
   TensorShapeProto shape_proto;
 
@@ -349,7 +377,7 @@ static Status TranslateUnaryOp(
         create_unary_op) {
   shared_ptr<ng::Node> ng_input;
   TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input));
-  SaveNgOp(ng_op_map, op->name(), create_unary_op(ng_input));
+  SaveNgOp(ng_op_map, op, create_unary_op(ng_input));
 
   return Status::OK();
 }
@@ -409,7 +437,7 @@ static Status TranslateBinaryOp(
   std::tie(ng_lhs, ng_rhs) =
       ng::builder::numpy_broadcast(std::make_pair(ng_lhs, ng_rhs));
 
-  SaveNgOp(ng_op_map, op->name(), create_binary_op(ng_lhs, ng_rhs));
+  SaveNgOp(ng_op_map, op, create_binary_op(ng_lhs, ng_rhs));
 
   return Status::OK();
 }
@@ -441,7 +469,7 @@ static Status TranslateAllreduceOp(
   shared_ptr<ng::Node> ng_input;
   TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input));
 
-  SaveNgOp(ng_op_map, op->name(), make_shared<ng::op::AllReduce>(ng_input));
+  SaveNgOp(ng_op_map, op, make_shared<ng::op::AllReduce>(ng_input));
   return Status::OK();
 }
 
@@ -454,7 +482,7 @@ static Status TranslateAddNOp(
     TF_RETURN_IF_ERROR(
         GetInputNode(ng_op_map, op, inp_idx, &ng_arg_vec[inp_idx]));
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            std::accumulate(std::next(ng_arg_vec.begin()), ng_arg_vec.end(),
                            ng_arg_vec.at(0)));  // accumulation: start with
                                                 // first element. default op is
@@ -511,7 +539,7 @@ static Status TranslateAnyOp(const Node* op,
                                           ng_result_shape_with_keep);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_any);
+  SaveNgOp(ng_op_map, op, ng_any);
   return Status::OK();
 }
 
@@ -567,7 +595,7 @@ static Status TranslateAllOp(const Node* op,
                                           ng_result_shape_with_keep);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_all);
+  SaveNgOp(ng_op_map, op, ng_all);
   return Status::OK();
 }
 
@@ -603,7 +631,7 @@ static Status TranslateArgMaxOp(
 
   auto ng_argmax = make_shared<ng::op::ArgMax>(ng_input, input_dims, ng_et);
 
-  SaveNgOp(ng_op_map, op->name(), ng_argmax);
+  SaveNgOp(ng_op_map, op, ng_argmax);
   return Status::OK();
 }
 
@@ -639,7 +667,7 @@ static Status TranslateArgMinOp(
 
   auto ng_argmin = make_shared<ng::op::ArgMin>(ng_input, input_dims, ng_et);
 
-  SaveNgOp(ng_op_map, op->name(), ng_argmin);
+  SaveNgOp(ng_op_map, op, ng_argmin);
   return Status::OK();
 }
 
@@ -699,7 +727,7 @@ static Status TranslateAvgPoolOp(
   NGRAPH_VLOG(3) << "avgpool outshape: {" << ng::join(ng_avgpool->get_shape())
                  << "}";
 
-  SaveNgOp(ng_op_map, op->name(), ng_avgpool);
+  SaveNgOp(ng_op_map, op, ng_avgpool);
   return Status::OK();
 }
 
@@ -775,11 +803,84 @@ static Status TranslateAvgPoolGradOp(
   NGRAPH_VLOG(3) << "avgpoolbackprop outshape: {"
                  << ng::join(ng_avgpool_backprop->get_shape()) << "}";
 
-  SaveNgOp(ng_op_map, op->name(), ng_avgpool_backprop);
+  SaveNgOp(ng_op_map, op, ng_avgpool_backprop);
 
   return Status::OK();
 }
 
+// Largest number of elements in the [G, M, K, N] intermediate product that
+// BatchedDot materializes for a group of G batch elements (64 MiB of floats).
+static const size_t MAX_BATCHED_DOT_BROADCAST_ELEMENTS = 1 << 24;
+
+// Multiplies each of the B matrices in "ng_lhs" [B, M, K] with the
+// corresponding matrix in "ng_rhs" [B, K, N], giving [B, M, N].
+//
+// nGraph has no batched Dot (BatchDot is private to the CPU backend, which
+// the bridge does not link against), and a single Dot over the block-diagonal
+// form costs B times the flops and B * B * M * N memory. Instead we split the
+// batch into groups whose [G, M, K, N] product stays within
+// MAX_BATCHED_DOT_BROADCAST_ELEMENTS, broadcast both operands of each group,
+// multiply and reduce over K. That takes exactly the flops of the batched
+// product, bounded memory, and a number of nodes proportional to the work
+// rather than to B. Only when a single product is larger than the bound do
+// we emit a Dot per batch element, each of which is then large enough to
+// amortize its nodes.
+static shared_ptr<ng::Node> BatchedDot(shared_ptr<ng::Node> ng_lhs,
+                                       shared_ptr<ng::Node> ng_rhs) {
+  auto ng_lhs_shape = ng_lhs->get_shape();
+  auto ng_rhs_shape = ng_rhs->get_shape();
+  size_t batch = ng_lhs_shape[0];
+  size_t m = ng_lhs_shape[1];
+  size_t k = ng_lhs_shape[2];
+  size_t n = ng_rhs_shape[2];
+
+  size_t group =
+      MAX_BATCHED_DOT_BROADCAST_ELEMENTS / std::max<size_t>(m * k * n, 1);
+  if (group == 0) {
+    vector<shared_ptr<ng::Node>> ng_products;
+    for (size_t b = 0; b < batch; b++) {
+      auto ng_lhs_slice = make_shared<ng::op::Reshape>(
+          make_shared<ng::op::Slice>(ng_lhs, ng::Coordinate{b, 0, 0},
+                                     ng::Coordinate{b + 1, m, k}),
+          ng::AxisVector{0, 1, 2}, ng::Shape{m, k});
+      auto ng_rhs_slice = make_shared<ng::op::Reshape>(
+          make_shared<ng::op::Slice>(ng_rhs, ng::Coordinate{b, 0, 0},
+                                     ng::Coordinate{b + 1, k, n}),
+          ng::AxisVector{0, 1, 2}, ng::Shape{k, n});
+      ng_products.push_back(make_shared<ng::op::Reshape>(
+          make_shared<ng::op::Dot>(ng_lhs_slice, ng_rhs_slice),
+          ng::AxisVector{0, 1}, ng::Shape{1, m, n}));
+    }
+    return make_shared<ng::op::Concat>(ng_products, 0);
+  }
+
+  auto broadcast_dot = [m, k, n](shared_ptr<ng::Node> ng_lhs_group,
+                                 shared_ptr<ng::Node> ng_rhs_group) {
+    ng::Shape ng_product_shape{ng_lhs_group->get_shape()[0], m, k, n};
+    auto ng_lhs_broadcast = make_shared<ng::op::Broadcast>(
+        ng_lhs_group, ng_product_shape, ng::AxisSet{3});
+    auto ng_rhs_broadcast = make_shared<ng::op::Broadcast>(
+        ng_rhs_group, ng_product_shape, ng::AxisSet{1});
+    auto ng_product =
+        make_shared<ng::op::Multiply>(ng_lhs_broadcast, ng_rhs_broadcast);
+    return make_shared<ng::op::Sum>(ng_product, ng::AxisSet{2});
+  };
+  if (group >= batch) {
+    return broadcast_dot(ng_lhs, ng_rhs);
+  }
+
+  vector<shared_ptr<ng::Node>> ng_products;
+  for (size_t b = 0; b < batch; b += group) {
+    size_t end = std::min(b + group, batch);
+    ng_products.push_back(broadcast_dot(
+        make_shared<ng::op::Slice>(ng_lhs, ng::Coordinate{b, 0, 0},
+                                   ng::Coordinate{end, m, k}),
+        make_shared<ng::op::Slice>(ng_rhs, ng::Coordinate{b, 0, 0},
+                                   ng::Coordinate{end, k, n})));
+  }
+  return make_shared<ng::op::Concat>(ng_products, 0);
+}
+
 static Status TranslateBatchMatMulOp(
     const Node* op, const std::vector<const Tensor*>& static_input_map,
     Builder::OpMap& ng_op_map) {
@@ -793,21 +894,9 @@ static Status TranslateBatchMatMulOp(
     return errors::InvalidArgument(
         "Dimensions of two input args are not the same for BatchMatMul");
   }
-  size_t n_dims = ng_lhs_shape.size();
-  if (n_dims < 2) {
+  if (ng_lhs_shape.size() < 2 || ng_rhs_shape.size() < 2) {
     return errors::InvalidArgument(
-        "Dimensions of input args for BatchMatMul must be >=2", n_dims);
-  }
-
-  ng::AxisVector out_axes;
-  for (size_t i = 0; i < n_dims - 2; ++i) {
-    if (ng_lhs_shape[i] != ng_rhs_shape[i]) {
-      return errors::InvalidArgument(
-          "ng_lhs_shape and ng_rhs_shape must be the same for BatchMatMul "
-          "for each dimension",
-          i);
-    }
-    out_axes.push_back(i);
+        "Dimensions of input args for BatchMatMul must be >=2");
   }
 
   bool tf_adj_x = false;
@@ -815,78 +904,59 @@ static Status TranslateBatchMatMulOp(
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "adj_x", &tf_adj_x));
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "adj_y", &tf_adj_y));
 
-  auto ng_lhs_axes = out_axes;
-  auto ng_rhs_axes = out_axes;
+  // Swaps the two innermost dimensions.
+  auto transpose_matrices = [](shared_ptr<ng::Node> ng_input) {
+    auto ng_axes = ng::get_default_order(ng_input->get_shape());
+    std::swap(ng_axes[ng_axes.size() - 1], ng_axes[ng_axes.size() - 2]);
+    return ng::builder::numpy_transpose(ng_input, ng_axes);
+  };
   if (tf_adj_x) {
-    ng_lhs_axes.push_back(n_dims - 1);
-    ng_lhs_axes.push_back(n_dims - 2);
-    ng_lhs = ng::builder::numpy_transpose(ng_lhs, ng_lhs_axes);
+    ng_lhs = transpose_matrices(ng_lhs);
   }
   if (tf_adj_y) {
-    ng_rhs_axes.insert(ng_rhs_axes.begin(), n_dims - 2);
-    ng_rhs_axes.insert(ng_rhs_axes.begin(), n_dims - 1);
-    ng_rhs = ng::builder::numpy_transpose(ng_rhs, ng_rhs_axes);
-  } else {
-    ng_rhs_axes.insert(ng_rhs_axes.begin(), n_dims - 1);
-    ng_rhs_axes.insert(ng_rhs_axes.begin(), n_dims - 2);
-    ng_rhs = ng::builder::numpy_transpose(ng_rhs, ng_rhs_axes);
+    ng_rhs = transpose_matrices(ng_rhs);
   }
 
   ng_lhs_shape = ng_lhs->get_shape();
   ng_rhs_shape = ng_rhs->get_shape();
-
-  if (ng_lhs_shape[n_dims - 1] != ng_rhs_shape[0]) {
+  size_t m = ng_lhs_shape[ng_lhs_shape.size() - 2];
+  size_t k = ng_lhs_shape[ng_lhs_shape.size() - 1];
+  size_t n = ng_rhs_shape[ng_rhs_shape.size() - 1];
+  if (ng_rhs_shape[ng_rhs_shape.size() - 2] != k) {
     return errors::InvalidArgument(
         "The last dimension of ng_lhs and the first dimension of ng_rhs "
         "should have the same size");
   }
-  if (n_dims == 2) {
-    SaveNgOp(ng_op_map, op->name(),
-             make_shared<ngraph::op::Dot>(ng_lhs, ng_rhs));
-  } else {
-    auto output_shape = ng_lhs_shape;
-    output_shape[n_dims - 1] = ng_rhs_shape[1];
-    auto dot_output = make_shared<ngraph::op::Dot>(ng_lhs, ng_rhs);
-    size_t compound_size = 1;
-    for (int i = 0; i < out_axes.size(); i++) {
-      compound_size *= output_shape[i];
-    }
-    auto dot_axes = out_axes;
-    dot_axes.push_back(n_dims - 2);
-    dot_axes.push_back(n_dims - 1);
-    for (int i = 0; i < out_axes.size(); i++) {
-      dot_axes.push_back(n_dims + i);
-    }
-    ng::Shape dot_shape = {compound_size, ng_lhs_shape[n_dims - 2],
-                           ng_rhs_shape[1], compound_size};
-    std::shared_ptr<ng::Node> dot_reshape;
-    if (n_dims == 3) {
-      dot_reshape = dot_output;
-    } else {
-      dot_reshape =
-          make_shared<ngraph::op::Reshape>(dot_output, dot_axes, dot_shape);
-    }
-    ng::Shape tmp_shape = {1, ng_lhs_shape[n_dims - 2], ng_rhs_shape[1]};
-    vector<shared_ptr<ngraph::Node>> tmp_tensors;
-    for (size_t i = 0; i < dot_shape[0]; i++) {
-      const std::vector<size_t> lower_bound{i, 0, 0, i};
-      const std::vector<size_t> upper_bound{i + 1, dot_shape[1], dot_shape[2],
-                                            i + 1};
-      auto slice_out =
-          make_shared<ngraph::op::Slice>(dot_reshape, lower_bound, upper_bound);
-      auto reshape_out = make_shared<ngraph::op::Reshape>(
-          slice_out, ng::AxisVector{0, 1, 2, 3}, tmp_shape);
-      tmp_tensors.push_back(reshape_out);
-    }
-    auto concat_op = make_shared<ngraph::op::Concat>(tmp_tensors, 0);
-    if (n_dims == 3) {
-      SaveNgOp(ng_op_map, op->name(), concat_op);
-    } else {
-      SaveNgOp(ng_op_map, op->name(),
-               make_shared<ngraph::op::Reshape>(
-                   concat_op, ng::AxisVector{0, 1, 2}, output_shape));
-    }
+
+  ng::Shape ng_batch_shape(ng_lhs_shape.begin(), ng_lhs_shape.end() - 2);
+  if (ng_batch_shape !=
+      ng::Shape(ng_rhs_shape.begin(), ng_rhs_shape.end() - 2)) {
+    return errors::InvalidArgument(
+        "ng_lhs_shape and ng_rhs_shape must be the same for BatchMatMul "
+        "for each dimension");
   }
+
+  if (ng_batch_shape.empty()) {
+    SaveNgOp(ng_op_map, op, make_shared<ngraph::op::Dot>(ng_lhs, ng_rhs));
+    return Status::OK();
+  }
+
+  // Flatten the batch dimensions, multiply, and restore them.
+  size_t batch = ng::shape_size(ng_batch_shape);
+  auto ng_lhs_flat = make_shared<ng::op::Reshape>(
+      ng_lhs, ng::get_default_order(ng_lhs->get_shape()),
+      ng::Shape{batch, m, k});
+  auto ng_rhs_flat = make_shared<ng::op::Reshape>(
+      ng_rhs, ng::get_default_order(ng_rhs->get_shape()),
+      ng::Shape{batch, k, n});
+
+  ng::Shape ng_output_shape = ng_batch_shape;
+  ng_output_shape.push_back(m);
+  ng_output_shape.push_back(n);
+  SaveNgOp(ng_op_map, op,
+           make_shared<ng::op::Reshape>(BatchedDot(ng_lhs_flat, ng_rhs_flat),
+                                        ng::AxisVector{0, 1, 2},
+                                        ng_output_shape));
   return Status::OK();
 }
 
@@ -934,7 +1004,7 @@ static Status TranslateBiasAddOp(
       ng_bias, ng_input_shape, ng_broadcast_axes);
   auto ng_add = ng_input + ng_bias_broadcasted;
 
-  SaveNgOp(ng_op_map, op->name(), ng_add);
+  SaveNgOp(ng_op_map, op, ng_add);
   return Status::OK();
 }
 
@@ -983,7 +1053,7 @@ static Status TranslateBiasAddGradOp(
 
   ng_biasadd_backprop = make_shared<ng::op::Sum>(ng_input, reduction_axes);
 
-  SaveNgOp(ng_op_map, op->name(), ng_biasadd_backprop);
+  SaveNgOp(ng_op_map, op, ng_biasadd_backprop);
   return Status::OK();
 }
 
@@ -1000,8 +1070,7 @@ static Status TranslateCastOp(
   TF_RETURN_IF_ERROR(TFDataTypeToNGraphElementType(dtype, &ng_et));
 
   try {
-    SaveNgOp(ng_op_map, op->name(),
-             make_shared<ng::op::Convert>(ng_input, ng_et));
+    SaveNgOp(ng_op_map, op, make_shared<ng::op::Convert>(ng_input, ng_et));
   } catch (const std::out_of_range&) {
     return errors::Unimplemented("Unsupported TensorFlow data type: ",
                                  DataType_Name(dtype));
@@ -1035,7 +1104,7 @@ static Status TranslateConcatV2Op(
     ng_args.push_back(ng_arg);
   }
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Concat>(ng_args, size_t(concat_axis)));
   return Status::OK();
 }
@@ -1066,15 +1135,16 @@ static Status TranslateConstOp(
                                  DataType_Name(dtype));
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_node);
+  SaveNgOp(ng_op_map, op, ng_node);
   return Status::OK();
 }
 
-static Status TranslateConv2DOp(
-    const Node* op, const std::vector<const Tensor*>& static_input_map,
-    Builder::OpMap& ng_op_map) {
-  shared_ptr<ng::Node> ng_input, ng_filter;
-  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input, &ng_filter));
+// Builds the nGraph Convolution for the Conv2D "op" applied to "ng_input"
+// and the HWIO "ng_filter". The result is left in nGraph's NCHW layout;
+// "is_nhwc" tells whether it must be converted back.
+static Status MakeConv2D(const Node* op, shared_ptr<ng::Node> ng_input,
+                         shared_ptr<ng::Node> ng_filter, bool* is_nhwc,
+                         shared_ptr<ng::Node>* ng_conv) {
 
   std::vector<int32> tf_strides;
   std::vector<int32> tf_dilations;
@@ -1083,14 +1153,18 @@ static Status TranslateConv2DOp(
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "strides", &tf_strides));
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "dilations", &tf_dilations));
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "padding", &tf_padding_type));
-  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "data_format", &tf_data_format));
+  // Quantized convolutions have no data_format, and are always NHWC.
+  if (GetNodeAttr(op->attrs(), "data_format", &tf_data_format) !=
+      Status::OK()) {
+    tf_data_format = "NHWC";
+  }
 
   if (tf_data_format != "NHWC" && tf_data_format != "NCHW") {
     return errors::InvalidArgument(
         "Conv2D data format is neither NHWC nor NCHW");
   }
 
-  bool is_nhwc = (tf_data_format == "NHWC");
+  *is_nhwc = (tf_data_format == "NHWC");
 
   NGRAPH_VLOG(3) << ng::join(tf_strides);
   NGRAPH_VLOG(3) << ng::join(tf_dilations);
@@ -1102,10 +1176,10 @@ static Status TranslateConv2DOp(
   ng::Shape ng_image_shape(2);
   ng::Shape ng_kernel_shape(2);
 
-  BatchedOpParamToNGraph(is_nhwc, tf_strides, ng_strides);
-  BatchedOpParamToNGraph(is_nhwc, ng_input->get_shape(), ng_image_shape);
-  BatchedOpParamToNGraph(is_nhwc, tf_dilations, ng_dilations);
-  BatchToNGraph(is_nhwc, ng_input);
+  BatchedOpParamToNGraph(*is_nhwc, tf_strides, ng_strides);
+  BatchedOpParamToNGraph(*is_nhwc, ng_input->get_shape(), ng_image_shape);
+  BatchedOpParamToNGraph(*is_nhwc, tf_dilations, ng_dilations);
+  BatchToNGraph(*is_nhwc, ng_input);
 
   NGRAPH_VLOG(3) << "ng_strides: " << ng::join(ng_strides);
   NGRAPH_VLOG(3) << "ng_dilations: " << ng::join(ng_dilations);
@@ -1125,12 +1199,24 @@ static Status TranslateConv2DOp(
                        ng_strides, ng_dilations, ng_padding_below,
                        ng_padding_above);
 
-  std::shared_ptr<ng::Node> ng_conv = make_shared<ng::op::Convolution>(
-      ng_input, ng_filter, ng_strides, ng_dilations, ng_padding_below,
-      ng_padding_above);
+  *ng_conv = make_shared<ng::op::Convolution>(ng_input, ng_filter, ng_strides,
+                                              ng_dilations, ng_padding_below,
+                                              ng_padding_above);
+  return Status::OK();
+}
+
+static Status TranslateConv2DOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_input, ng_filter;
+  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input, &ng_filter));
+
+  bool is_nhwc;
+  shared_ptr<ng::Node> ng_conv;
+  TF_RETURN_IF_ERROR(MakeConv2D(op, ng_input, ng_filter, &is_nhwc, &ng_conv));
 
   BatchToTensorflow(is_nhwc, ng_conv);
-  SaveNgOp(ng_op_map, op->name(), ng_conv);
+  SaveNgOp(ng_op_map, op, ng_conv);
   return Status::OK();
 }
 
@@ -1259,7 +1345,7 @@ static Status TranslateConv2DBackpropFilterOp(
   // in_channels, out_channels]
   Reshape<2, 3, 1, 0>(ng_back_prop_filter);
 
-  SaveNgOp(ng_op_map, op->name(), ng_back_prop_filter);
+  SaveNgOp(ng_op_map, op, ng_back_prop_filter);
   return Status::OK();
 }
 
@@ -1351,7 +1437,7 @@ static Status TranslateConv2DBackpropInputOp(
 
   BatchToTensorflow(is_nhwc, ng_data);
 
-  SaveNgOp(ng_op_map, op->name(), ng_data);
+  SaveNgOp(ng_op_map, op, ng_data);
   return Status::OK();
 }
 
@@ -1500,17 +1586,16 @@ static Status TranslateDepthToSpaceOp(
 
   auto final_result = make_shared<ng::op::Reshape>(
       reshaped, ng_transpose_permutation, ng_output_shape);
-  SaveNgOp(ng_op_map, op->name(), final_result);
+  SaveNgOp(ng_op_map, op, final_result);
 
   return Status::OK();
 }
 
-static Status TranslateDepthwiseConv2dNativeOp(
-    const Node* op, const std::vector<const Tensor*>& static_input_map,
-    Builder::OpMap& ng_op_map) {
-  shared_ptr<ng::Node> ng_input, ng_filter;
-  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input, &ng_filter));
-
+// As MakeConv2D, for DepthwiseConv2dNative with an HWCM "ng_filter".
+static Status MakeDepthwiseConv2D(const Node* op,
+                                  shared_ptr<ng::Node> ng_input,
+                                  shared_ptr<ng::Node> ng_filter, bool* is_nhwc,
+                                  shared_ptr<ng::Node>* ng_result) {
   std::vector<int32> tf_strides;
   std::vector<int32> tf_dilations;
   std::string tf_padding_type;
@@ -1525,7 +1610,7 @@ static Status TranslateDepthwiseConv2dNativeOp(
         "DepthwiseConv2D data format is neither NHWC nor NCHW");
   }
 
-  bool is_nhwc = (tf_data_format == "NHWC");
+  *is_nhwc = (tf_data_format == "NHWC");
 
   NGRAPH_VLOG(3) << ng::join(tf_strides);
   NGRAPH_VLOG(3) << ng::join(tf_dilations);
@@ -1537,10 +1622,10 @@ static Status TranslateDepthwiseConv2dNativeOp(
   ng::Shape ng_image_shape(2);
   ng::Shape ng_kernel_shape(2);
 
-  BatchedOpParamToNGraph(is_nhwc, ng_input->get_shape(), ng_image_shape);
-  BatchedOpParamToNGraph(is_nhwc, tf_strides, ng_strides);
-  BatchedOpParamToNGraph(is_nhwc, tf_dilations, ng_dilations);
-  BatchToNGraph(is_nhwc, ng_input);
+  BatchedOpParamToNGraph(*is_nhwc, ng_input->get_shape(), ng_image_shape);
+  BatchedOpParamToNGraph(*is_nhwc, tf_strides, ng_strides);
+  BatchedOpParamToNGraph(*is_nhwc, tf_dilations, ng_dilations);
+  BatchToNGraph(*is_nhwc, ng_input);
 
   NGRAPH_VLOG(3) << "ng_strides: " << ng::join(ng_strides);
   NGRAPH_VLOG(3) << "ng_dilations: " << ng::join(ng_dilations);
@@ -1591,11 +1676,23 @@ static Status TranslateDepthwiseConv2dNativeOp(
   }
 
   size_t ng_concatenation_axis = 1;  // channel axis
-  std::shared_ptr<ng::Node> ng_concat =
-      make_shared<ng::op::Concat>(ng_args, ng_concatenation_axis);
+  *ng_result = make_shared<ng::op::Concat>(ng_args, ng_concatenation_axis);
+  return Status::OK();
+}
+
+static Status TranslateDepthwiseConv2dNativeOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_input, ng_filter;
+  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input, &ng_filter));
+
+  bool is_nhwc;
+  shared_ptr<ng::Node> ng_concat;
+  TF_RETURN_IF_ERROR(
+      MakeDepthwiseConv2D(op, ng_input, ng_filter, &is_nhwc, &ng_concat));
 
   BatchToTensorflow(is_nhwc, ng_concat);
-  SaveNgOp(ng_op_map, op->name(), ng_concat);
+  SaveNgOp(ng_op_map, op, ng_concat);
   return Status::OK();
 }
 
@@ -1627,7 +1724,7 @@ static Status TranslateExpandDimsOp(
   std::shared_ptr<ng::Node> ng_expand_dim =
       make_shared<ng::op::Reshape>(ng_input, shape_dimensions, out_shape);
 
-  SaveNgOp(ng_op_map, op->name(), ng_expand_dim);
+  SaveNgOp(ng_op_map, op, ng_expand_dim);
   return Status::OK();
 }
 
@@ -1646,7 +1743,7 @@ static Status TranslateFillOp(
     ng_output_shape[i] = dims_vec[i];
     ng_axis_set.insert(i);
   }
-  SaveNgOp(ng_op_map, op->name(), make_shared<ng::op::Broadcast>(
+  SaveNgOp(ng_op_map, op, make_shared<ng::op::Broadcast>(
                                       ng_value, ng_output_shape, ng_axis_set));
   return Status::OK();
 }
@@ -1727,24 +1824,24 @@ static Status TranslateFusedBatchNormOp(
 
     BatchToTensorflow(is_nhwc, ng_y);
 
-    SaveNgOp(ng_op_map, op->name(), ng_y);
-    SaveNgOp(ng_op_map, op->name(), ng_mean);
-    SaveNgOp(ng_op_map, op->name(), ng_variance);
+    SaveNgOp(ng_op_map, op, ng_y);
+    SaveNgOp(ng_op_map, op, ng_mean);
+    SaveNgOp(ng_op_map, op, ng_variance);
     // Output reserve_space_1: A 1D Tensor for the computed batch mean, to be
     // reused in the gradient computation.
-    SaveNgOp(ng_op_map, op->name(), ng_mean);
+    SaveNgOp(ng_op_map, op, ng_mean);
     // Output reserve_space_2: A 1D Tensor for the computed batch variance
     //(inverted variance in the cuDNN case), to be reused in the gradient
     // computation.
-    SaveNgOp(ng_op_map, op->name(), ng_variance);
+    SaveNgOp(ng_op_map, op, ng_variance);
   } else {
     ng_batch_norm = make_shared<ng::op::BatchNormInference>(
         tf_epsilon, ng_scale, ng_offset, ng_input, ng_mean, ng_variance);
     BatchToTensorflow(is_nhwc, ng_batch_norm);
-    SaveNgOp(ng_op_map, op->name(), ng_batch_norm);
+    SaveNgOp(ng_op_map, op, ng_batch_norm);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_batch_norm);
+  SaveNgOp(ng_op_map, op, ng_batch_norm);
   return Status::OK();
 }
 
@@ -1818,20 +1915,20 @@ static Status TranslateFusedBatchNormGradOp(
 
   BatchToTensorflow(is_nhwc, ng_input_delta_op);
 
-  SaveNgOp(ng_op_map, op->name(), ng_input_delta_op);
-  SaveNgOp(ng_op_map, op->name(), ng_scale_delta_op);
-  SaveNgOp(ng_op_map, op->name(), ng_beta_delta_op);
+  SaveNgOp(ng_op_map, op, ng_input_delta_op);
+  SaveNgOp(ng_op_map, op, ng_scale_delta_op);
+  SaveNgOp(ng_op_map, op, ng_beta_delta_op);
   // Output reserve_space_3: Unused placeholder to match the mean input
   // in FusedBatchNorm.
   std::shared_ptr<ng::Node> output_mean = make_shared<ngraph::op::Constant>(
       ng_mean->get_element_type(), ng::Shape{}, std::vector<std::string>{""});
-  SaveNgOp(ng_op_map, op->name(), output_mean);
+  SaveNgOp(ng_op_map, op, output_mean);
   // Output reserve_space_4: Unused placeholder to match the variance input
   // in FusedBatchNorm.
   std::shared_ptr<ng::Node> output_variance = make_shared<ngraph::op::Constant>(
       ng_variance->get_element_type(), ng::Shape{},
       std::vector<std::string>{""});
-  SaveNgOp(ng_op_map, op->name(), output_variance);
+  SaveNgOp(ng_op_map, op, output_variance);
 
   return Status::OK();
 }
@@ -1841,7 +1938,7 @@ static Status TranslateIdentityOp(
     Builder::OpMap& ng_op_map) {
   shared_ptr<ng::Node> ng_arg;
   TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_arg));
-  SaveNgOp(ng_op_map, op->name(), ng_arg);
+  SaveNgOp(ng_op_map, op, ng_arg);
   return Status::OK();
 }
 
@@ -1866,7 +1963,7 @@ static Status TranslateL2LossOp(
   std::shared_ptr<ng::Node> ng_sum = make_shared<ng::op::Sum>(ng_pow, axes);
   std::shared_ptr<ng::Node> ng_l2loss =
       make_shared<ng::op::Divide>(ng_sum, const_2);
-  SaveNgOp(ng_op_map, op->name(), ng_l2loss);
+  SaveNgOp(ng_op_map, op, ng_l2loss);
   return Status::OK();
 }
 
@@ -1891,7 +1988,7 @@ static Status TranslateMatMulOp(
 
   // The default axis count for nGraph's Dot op is 1, which is just what
   // we need here.
-  SaveNgOp(ng_op_map, op->name(), make_shared<ngraph::op::Dot>(ng_lhs, ng_rhs));
+  SaveNgOp(ng_op_map, op, make_shared<ngraph::op::Dot>(ng_lhs, ng_rhs));
   return Status::OK();
 }
 
@@ -1940,7 +2037,7 @@ static Status TranslateMaxOp(const Node* op,
                                           ng_result_shape_with_keep);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_max);
+  SaveNgOp(ng_op_map, op, ng_max);
   return Status::OK();
 }
 
@@ -2002,7 +2099,7 @@ static Status TranslateMaxPoolOp(
   NGRAPH_VLOG(3) << "maxpool outshape: {" << ng::join(ng_maxpool->get_shape())
                  << "}";
 
-  SaveNgOp(ng_op_map, op->name(), ng_maxpool);
+  SaveNgOp(ng_op_map, op, ng_maxpool);
   return Status::OK();
 }
 
@@ -2059,7 +2156,7 @@ static Status TranslateMaxPoolGradOp(
   BatchToTensorflow(is_nhwc, ng_maxpool_backprop);
   NGRAPH_VLOG(3) << "maxpoolbackprop outshape: {"
                  << ng::join(ng_maxpool_backprop->get_shape()) << "}";
-  SaveNgOp(ng_op_map, op->name(), ng_maxpool_backprop);
+  SaveNgOp(ng_op_map, op, ng_maxpool_backprop);
   return Status::OK();
 }
 
@@ -2108,7 +2205,7 @@ static Status TranslateMeanOp(
                                            ng_result_shape_with_keep);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_mean);
+  SaveNgOp(ng_op_map, op, ng_mean);
   return Status::OK();
 }
 
@@ -2157,7 +2254,7 @@ static Status TranslateMinOp(const Node* op,
                                           ng_result_shape_with_keep);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_min);
+  SaveNgOp(ng_op_map, op, ng_min);
   return Status::OK();
 }
 
@@ -2209,7 +2306,7 @@ static Status TranslatePackOp(
   }
 
   auto concat = make_shared<ng::op::Concat>(ng_concat_inputs, concat_axis);
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Reshape>(concat, ng_axis_order, output_shape));
   return Status::OK();
 }
@@ -2250,7 +2347,7 @@ static Status TranslatePadOp(const Node* op,
   auto pad_op = make_shared<ng::op::Pad>(ng_input, pad_val_op, padding_below,
                                          padding_above, padding_interior);
 
-  SaveNgOp(ng_op_map, op->name(), pad_op);
+  SaveNgOp(ng_op_map, op, pad_op);
   return Status::OK();
 }
 
@@ -2299,7 +2396,7 @@ static Status TranslateProdOp(
                                            ng_result_shape_with_keep);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_prod);
+  SaveNgOp(ng_op_map, op, ng_prod);
   return Status::OK();
 }
 
@@ -2447,6 +2544,32 @@ Status QuantizeAndDequantizeV2Helper(
   return Status::OK();
 }
 
+// Quantizes "ng_input" to "ng_q_et" with the inverse scale computed by
+// QuantizeAndDequantizeV2Helper, as QuantizeAndDequantizeV2 does.
+static shared_ptr<ng::Node> MakeQDQQuantize(shared_ptr<ng::Node> ng_input,
+                                            float scale,
+                                            ng::element::Type ng_q_et) {
+  auto ng_scale = std::make_shared<ng::op::Constant>(
+      ng_input->get_element_type(), ng::Shape(), std::vector<float>({scale}));
+  auto ng_offset = std::make_shared<ng::op::Constant>(ng_q_et, ng::Shape(),
+                                                      std::vector<int>({0}));
+  ng::op::Quantize::RoundMode ng_round_mode =
+      ng::op::Quantize::RoundMode::ROUND_NEAREST_TOWARD_INFINITY;
+  return make_shared<ng::op::Quantize>(ng_input, ng_scale, ng_offset, ng_q_et,
+                                       ng::AxisSet(), ng_round_mode);
+}
+
+static shared_ptr<ng::Node> MakeQDQDequantize(shared_ptr<ng::Node> ng_quant,
+                                              float scale,
+                                              ng::element::Type ng_r_et) {
+  auto ng_scale = std::make_shared<ng::op::Constant>(
+      ng_r_et, ng::Shape(), std::vector<float>({scale}));
+  auto ng_offset = std::make_shared<ng::op::Constant>(
+      ng_quant->get_element_type(), ng::Shape(), std::vector<int>({0}));
+  return make_shared<ng::op::Dequantize>(ng_quant, ng_scale, ng_offset,
+                                         ng_r_et, ng::AxisSet());
+}
+
 static Status TranslateQuantizeAndDequantizeV2Op(
     const Node* op, const std::vector<const Tensor*>& static_input_map,
     Builder::OpMap& ng_op_map) {
@@ -2494,87 +2617,595 @@ static Status TranslateQuantizeAndDequantizeV2Op(
           "Expected QuantizeAndDequantizeV2's num_bits to be 8, but got ",
           num_bits);
   }
-  auto ng_scale = std::make_shared<ng::op::Constant>(
-      ng_r_et, ng::Shape(), std::vector<float>({scale}));
-  auto ng_offset = std::make_shared<ng::op::Constant>(ng_q_et, ng::Shape(),
-                                                      std::vector<int>({0}));
-  ng::op::Quantize::RoundMode ng_round_mode =
-      ng::op::Quantize::RoundMode::ROUND_NEAREST_TOWARD_INFINITY;
-  auto ng_quant = make_shared<ng::op::Quantize>(
-      ng_input, ng_scale, ng_offset, ng_q_et, ng::AxisSet(), ng_round_mode);
-  SaveNgOp(ng_op_map, op->name(),
-           make_shared<ng::op::Dequantize>(ng_quant, ng_scale, ng_offset,
-                                           ng_r_et, ng::AxisSet()));
+  SaveNgOp(ng_op_map, op,
+           MakeQDQDequantize(MakeQDQQuantize(ng_input, scale, ng_q_et), scale,
+                             ng_r_et));
 
   // TODO: what of clamping?
   return Status::OK();
 }
 
-static Status TranslateQuantizedConv2DWithBiasAndReluAndRequantizeOp(
+//
+// Quantized ops other than QuantizeV2, Dequantize and QuantizedMaxPool take
+// their ranges as graph values: they are usually produced by the quantized op
+// upstream, and requiring them to be static would cut the graph into a
+// cluster per op. The fused convolutions, which only have MKL kernels, are in
+// SCALED mode like those kernels, i.e. real = quantized * scale with
+// scale = max(|min|, |max|) / (largest quantized value). Their ranges may be
+// per channel (along the last axis).
+//
+// Where nGraph has a native int8 kernel and the ranges turn out to be
+// constants, it is used. Otherwise the op is computed on the dequantized
+// values and requantized, which keeps the model in one cluster even if it
+// does not speed the op itself up.
+//
+
+// Returns the scale of SCALED mode values of type "dtype" with range
+// [ng_min, ng_max].
+static Status MakeScaledModeScale(shared_ptr<ng::Node> ng_min,
+                                  shared_ptr<ng::Node> ng_max, DataType dtype,
+                                  shared_ptr<ng::Node>* ng_scale) {
+  float levels;
+  switch (dtype) {
+    case DT_QUINT8:
+      levels = 255.0f;
+      break;
+    case DT_QINT8:
+      levels = 127.0f;
+      break;
+    case DT_QINT32:
+      levels = 2147483647.0f;
+      break;
+    default:
+      return errors::InvalidArgument("Unsupported quantized type ",
+                                     DataTypeString(dtype));
+  }
+  auto& ng_shape = ng_min->get_shape();
+  auto ng_levels = make_shared<ng::op::Constant>(
+      ng::element::f32, ng_shape,
+      std::vector<float>(ng::shape_size(ng_shape), levels));
+  *ng_scale = make_shared<ng::op::Maximum>(make_shared<ng::op::Abs>(ng_min),
+                                           make_shared<ng::op::Abs>(ng_max)) /
+              ng_levels;
+  return Status::OK();
+}
+
+// Broadcasts a scalar, or a vector along the last axis, to "ng_shape".
+static shared_ptr<ng::Node> BroadcastRange(shared_ptr<ng::Node> ng_range,
+                                           const ng::Shape& ng_shape) {
+  auto& ng_range_shape = ng_range->get_shape();
+  if (ng_range_shape.size() != 0 && ng::shape_size(ng_range_shape) == 1) {
+    ng_range = make_shared<ng::op::Reshape>(
+        ng_range, ng::get_default_order(ng_range_shape.size()), ng::Shape{});
+  }
+  ng::AxisSet ng_axes;
+  size_t kept = ng_range->get_shape().size();
+  for (size_t i = 0; i + kept < ng_shape.size(); i++) {
+    ng_axes.insert(i);
+  }
+  return make_shared<ng::op::Broadcast>(ng_range, ng_shape, ng_axes);
+}
+
+static shared_ptr<ng::Node> DequantizeScaledMode(
+    shared_ptr<ng::Node> ng_input, shared_ptr<ng::Node> ng_scale) {
+  return make_shared<ng::op::Convert>(ng_input, ng::element::f32) *
+         BroadcastRange(ng_scale, ng_input->get_shape());
+}
+
+static Status QuantizeScaledMode(shared_ptr<ng::Node> ng_input,
+                                 shared_ptr<ng::Node> ng_scale, DataType dtype,
+                                 shared_ptr<ng::Node>* ng_result) {
+  float lowest, highest;
+  switch (dtype) {
+    case DT_QUINT8:
+      lowest = 0.0f;
+      highest = 255.0f;
+      break;
+    case DT_QINT8:
+      lowest = -128.0f;
+      highest = 127.0f;
+      break;
+    case DT_QINT32:
+      // The largest floats that convert to int32 without overflow.
+      lowest = -2147483520.0f;
+      highest = 2147483520.0f;
+      break;
+    default:
+      return errors::InvalidArgument("Unsupported quantized type ",
+                                     DataTypeString(dtype));
+  }
+  ng::element::Type ng_et;
+  TF_RETURN_IF_ERROR(TFDataTypeToNGraphElementType(dtype, &ng_et));
+
+  auto& ng_shape = ng_input->get_shape();
+  auto constant = [&ng_shape](float value) {
+    return make_shared<ng::op::Constant>(
+        ng::element::f32, ng_shape,
+        std::vector<float>(ng::shape_size(ng_shape), value));
+  };
+  // Rounds half away from zero for the non-negative values that matter most
+  // (after a Relu), as TensorFlow's kernels do.
+  shared_ptr<ng::Node> ng_rounded = make_shared<ng::op::Floor>(
+      ng_input / BroadcastRange(ng_scale, ng_shape) + constant(0.5f));
+  *ng_result = make_shared<ng::op::Convert>(
+      make_shared<ng::op::Minimum>(
+          make_shared<ng::op::Maximum>(ng_rounded, constant(lowest)),
+          constant(highest)),
+      ng_et);
+  return Status::OK();
+}
+
+// Quantizes the float result of a quantized convolution or matmul, and saves
+// it with its range. With "requantize", the output range is given by inputs
+// "min_freezed_index" and "min_freezed_index + 1"; otherwise the result is
+// qint32, with the scale of the product of the inputs.
+static Status SaveQuantizedResult(const Node* op, Builder::OpMap& ng_op_map,
+                                  shared_ptr<ng::Node> ng_result,
+                                  shared_ptr<ng::Node> ng_product_scale,
+                                  bool requantize, int min_freezed_index,
+                                  const string& out_type_attr) {
+  DataType out_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), out_type_attr, &out_type));
+
+  shared_ptr<ng::Node> ng_out_min, ng_out_max, ng_out_scale;
+  if (requantize) {
+    TF_RETURN_IF_ERROR(
+        GetInputNode(ng_op_map, op, min_freezed_index, &ng_out_min));
+    TF_RETURN_IF_ERROR(
+        GetInputNode(ng_op_map, op, min_freezed_index + 1, &ng_out_max));
+    TF_RETURN_IF_ERROR(
+        MakeScaledModeScale(ng_out_min, ng_out_max, out_type, &ng_out_scale));
+  } else {
+    ng_out_scale = ng_product_scale;
+    auto& ng_shape = ng_out_scale->get_shape();
+    ng_out_max =
+        ng_out_scale *
+        make_shared<ng::op::Constant>(
+            ng::element::f32, ng_shape,
+            std::vector<float>(ng::shape_size(ng_shape), 2147483647.0f));
+    ng_out_min = make_shared<ng::op::Negative>(ng_out_max);
+  }
+
+  shared_ptr<ng::Node> ng_quantized;
+  TF_RETURN_IF_ERROR(
+      QuantizeScaledMode(ng_result, ng_out_scale, out_type, &ng_quantized));
+  SaveNgOp(ng_op_map, op, ng_quantized);
+  SaveNgOp(ng_op_map, op, ng_out_min);
+  SaveNgOp(ng_op_map, op, ng_out_max);
+  return Status::OK();
+}
+
+// Adds a bias along the last axis of "ng_result". A qint32 bias is in the
+// scale of the product of the inputs.
+static shared_ptr<ng::Node> AddQuantizedBias(
+    shared_ptr<ng::Node> ng_result, shared_ptr<ng::Node> ng_bias,
+    shared_ptr<ng::Node> ng_product_scale) {
+  if (ng_bias->get_element_type() != ng::element::f32) {
+    ng_bias = DequantizeScaledMode(ng_bias, ng_product_scale);
+  }
+  return ng_result + BroadcastRange(ng_bias, ng_result->get_shape());
+}
+
+static bool IsConstantNode(const shared_ptr<ng::Node>& ng_node) {
+  return dynamic_pointer_cast<ng::op::Constant>(ng_node) != nullptr;
+}
+
+static shared_ptr<ng::Node> MakeFilledConstant(const ng::Shape& ng_shape,
+                                               float value) {
+  return make_shared<ng::op::Constant>(
+      ng::element::f32, ng_shape,
+      std::vector<float>(ng::shape_size(ng_shape), value));
+}
+
+// The ops that stock TensorFlow has reference kernels for (QuantizedConv2D,
+// QuantizedMatMul, QuantizedConcat, Requantize and RequantizationRange)
+// use affine ranges instead: real = min + (quantized - lowest) * step, with
+// step = (max - min) / (highest - lowest). In quint8 [-1, 3], for example,
+// zero is 64. The helpers below follow quantization_utils.h.
+
+static Status GetQuantizedLimits(DataType dtype, float* lowest,
+                                 float* highest) {
+  switch (dtype) {
+    case DT_QUINT8:
+      *lowest = 0.0f;
+      *highest = 255.0f;
+      break;
+    case DT_QINT8:
+      *lowest = -128.0f;
+      *highest = 127.0f;
+      break;
+    case DT_QINT32:
+      *lowest = -2147483648.0f;
+      *highest = 2147483647.0f;
+      break;
+    default:
+      return errors::InvalidArgument("Unsupported quantized type ",
+                                     DataTypeString(dtype));
+  }
+  return Status::OK();
+}
+
+// Rounds half away from zero, like std::round.
+static shared_ptr<ng::Node> RoundHalfAwayFromZero(shared_ptr<ng::Node> ng_x) {
+  auto ng_half = MakeFilledConstant(ng_x->get_shape(), 0.5f);
+  return make_shared<ng::op::Sign>(ng_x) *
+         make_shared<ng::op::Floor>(make_shared<ng::op::Abs>(ng_x) + ng_half);
+}
+
+// Returns the number of quantized steps per unit of range [ng_min, ng_max],
+// or 0 if the range is empty.
+static Status MakeAffineModeStepsPerUnit(shared_ptr<ng::Node> ng_min,
+                                         shared_ptr<ng::Node> ng_max,
+                                         DataType dtype,
+                                         shared_ptr<ng::Node>* ng_result) {
+  float lowest, highest;
+  TF_RETURN_IF_ERROR(GetQuantizedLimits(dtype, &lowest, &highest));
+  auto& ng_shape = ng_min->get_shape();
+  *ng_result = make_shared<ng::op::Select>(
+      make_shared<ng::op::Equal>(ng_min, ng_max),
+      MakeFilledConstant(ng_shape, 0.0f),
+      MakeFilledConstant(ng_shape, highest - lowest) / (ng_max - ng_min));
+  return Status::OK();
+}
+
+static Status DequantizeAffineMode(shared_ptr<ng::Node> ng_input,
+                                   shared_ptr<ng::Node> ng_min,
+                                   shared_ptr<ng::Node> ng_max, DataType dtype,
+                                   shared_ptr<ng::Node>* ng_result) {
+  float lowest, highest;
+  TF_RETURN_IF_ERROR(GetQuantizedLimits(dtype, &lowest, &highest));
+  auto& ng_range_shape = ng_min->get_shape();
+  auto ng_step = (ng_max - ng_min) /
+                 MakeFilledConstant(ng_range_shape, highest - lowest);
+  // quantized - lowest is not exact in float for qint32, so qint32 values are
+  // taken relative to the middle of the range instead.
+  shared_ptr<ng::Node> ng_base = ng_min;
+  float base_quantized = lowest;
+  if (dtype == DT_QINT32) {
+    ng_base = (ng_min + ng_max) / MakeFilledConstant(ng_range_shape, 2.0f);
+    base_quantized = -0.5f;
+  }
+  auto& ng_shape = ng_input->get_shape();
+  *ng_result = BroadcastRange(ng_base, ng_shape) +
+               (make_shared<ng::op::Convert>(ng_input, ng::element::f32) -
+                MakeFilledConstant(ng_shape, base_quantized)) *
+                   BroadcastRange(ng_step, ng_shape);
+  return Status::OK();
+}
+
+// Returns the quantized value of "ng_real" in range [ng_min, ng_max], as a
+// float, before it is clamped to the quantized type.
+static Status QuantizeAffineModeUnclamped(shared_ptr<ng::Node> ng_real,
+                                          shared_ptr<ng::Node> ng_min,
+                                          shared_ptr<ng::Node> ng_max,
+                                          DataType dtype,
+                                          shared_ptr<ng::Node>* ng_result) {
+  float lowest, highest;
+  TF_RETURN_IF_ERROR(GetQuantizedLimits(dtype, &lowest, &highest));
+  shared_ptr<ng::Node> ng_steps_per_unit;
+  TF_RETURN_IF_ERROR(
+      MakeAffineModeStepsPerUnit(ng_min, ng_max, dtype, &ng_steps_per_unit));
+  auto ng_zero_point =
+      MakeFilledConstant(ng_min->get_shape(), lowest) -
+      RoundHalfAwayFromZero(ng_min * ng_steps_per_unit);
+  auto& ng_shape = ng_real->get_shape();
+  *ng_result =
+      RoundHalfAwayFromZero(ng_real *
+                            BroadcastRange(ng_steps_per_unit, ng_shape)) +
+      BroadcastRange(ng_zero_point, ng_shape);
+  return Status::OK();
+}
+
+static Status ClampToQuantizedType(shared_ptr<ng::Node> ng_quantized,
+                                   DataType dtype,
+                                   shared_ptr<ng::Node>* ng_result) {
+  float lowest, highest;
+  TF_RETURN_IF_ERROR(GetQuantizedLimits(dtype, &lowest, &highest));
+  if (dtype == DT_QINT32) {
+    // The largest floats that convert to int32 without overflow.
+    lowest = -2147483520.0f;
+    highest = 2147483520.0f;
+  }
+  ng::element::Type ng_et;
+  TF_RETURN_IF_ERROR(TFDataTypeToNGraphElementType(dtype, &ng_et));
+  auto& ng_shape = ng_quantized->get_shape();
+  *ng_result = make_shared<ng::op::Convert>(
+      make_shared<ng::op::Minimum>(
+          make_shared<ng::op::Maximum>(ng_quantized,
+                                       MakeFilledConstant(ng_shape, lowest)),
+          MakeFilledConstant(ng_shape, highest)),
+      ng_et);
+  return Status::OK();
+}
+
+// Returns the quantized values of "ng_input" minus the quantized value of
+// zero, as floats: the operands of TensorFlow's quantized convolution and
+// matmul kernels.
+static Status CenterAffineMode(shared_ptr<ng::Node> ng_input,
+                               shared_ptr<ng::Node> ng_min,
+                               shared_ptr<ng::Node> ng_max, DataType dtype,
+                               shared_ptr<ng::Node>* ng_result) {
+  shared_ptr<ng::Node> ng_zero;
+  TF_RETURN_IF_ERROR(QuantizeAffineModeUnclamped(
+      MakeFilledConstant(ng_min->get_shape(), 0.0f), ng_min, ng_max, dtype,
+      &ng_zero));
+  *ng_result = make_shared<ng::op::Convert>(ng_input, ng::element::f32) -
+               BroadcastRange(ng_zero, ng_input->get_shape());
+  return Status::OK();
+}
+
+// Saves the product of centered operands "a" and "b" as qint32, with the
+// range TensorFlow's QuantizationRangeForMultiplication gives it: one
+// quantized step is the product of the steps of the operands. The sums are
+// computed in float, so they are exact up to 2^24.
+static Status SaveAffineModeProduct(
+    const Node* op, Builder::OpMap& ng_op_map, shared_ptr<ng::Node> ng_product,
+    shared_ptr<ng::Node> ng_min_a, shared_ptr<ng::Node> ng_max_a,
+    DataType a_type, shared_ptr<ng::Node> ng_min_b,
+    shared_ptr<ng::Node> ng_max_b, DataType b_type,
+    const string& out_type_attr) {
+  DataType out_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), out_type_attr, &out_type));
+  if (out_type != DT_QINT32) {
+    return errors::InvalidArgument("Expected ", op->type_string(),
+                                   "'s output to be DT_QINT32 but got ",
+                                   DataTypeString(out_type));
+  }
+  float a_lowest, a_highest, b_lowest, b_highest;
+  TF_RETURN_IF_ERROR(GetQuantizedLimits(a_type, &a_lowest, &a_highest));
+  TF_RETURN_IF_ERROR(GetQuantizedLimits(b_type, &b_lowest, &b_highest));
+  auto ng_a_step = (ng_max_a - ng_min_a) /
+                   MakeFilledConstant(ng_min_a->get_shape(),
+                                      a_highest - a_lowest);
+  auto ng_b_step = (ng_max_b - ng_min_b) /
+                   MakeFilledConstant(ng_min_b->get_shape(),
+                                      b_highest - b_lowest);
+  auto ng_step = BroadcastRange(ng_a_step, ng_b_step->get_shape()) * ng_b_step;
+
+  shared_ptr<ng::Node> ng_quantized;
+  TF_RETURN_IF_ERROR(ClampToQuantizedType(ng_product, DT_QINT32,
+                                          &ng_quantized));
+  auto& ng_shape = ng_step->get_shape();
+  SaveNgOp(ng_op_map, op, ng_quantized);
+  SaveNgOp(ng_op_map, op,
+           ng_step * MakeFilledConstant(ng_shape, -2147483648.0f));
+  SaveNgOp(ng_op_map, op,
+           ng_step * MakeFilledConstant(ng_shape, 2147483647.0f));
+  return Status::OK();
+}
+
+// Translates the QuantizedConv2D family. The op type spells out the inputs
+// and the fused epilogue, e.g. QuantizedConv2DWithBiasSumAndReluAndRequantize
+// takes input, filter, bias, min_input, max_input, min_filter, max_filter,
+// min_freezed_output, max_freezed_output, summand, min_summand, max_summand.
+static Status TranslateQuantizedConv2DOp(
     const Node* op, const std::vector<const Tensor*>& static_input_map,
     Builder::OpMap& ng_op_map) {
+  const string& op_type = op->type_string();
+  auto has = [&op_type](const string& part) {
+    return op_type.find(part) != string::npos;
+  };
+  const bool with_bias = has("WithBias");
+  const bool with_sum = has("Sum");
+  const bool with_relu = has("Relu");
+  const bool requantize = has("Requantize");
+
+  int index = 2;
+  const int bias_index = with_bias ? index++ : -1;
+  const int min_input_index = index;
+  index += 4;
+  const int min_freezed_index = requantize ? index : -1;
+  if (requantize) index += 2;
+  const int summand_index = with_sum ? index++ : -1;
+  const int min_summand_index = (with_sum && requantize) ? index : -1;
+  if (with_sum && requantize) index += 2;
+  TF_RETURN_IF_ERROR(ValidateInputCount(op, index));
+
   shared_ptr<ng::Node> ng_input, ng_filter, ng_bias;
   TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, op, 0, &ng_input));
   TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, op, 1, &ng_filter));
-  TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, op, 2, &ng_bias));
-  std::vector<std::shared_ptr<ng::op::Constant>> static_inps(6);
-  for (int i = 0; i < static_inps.size(); i++) {
-    std::vector<float> tmp_vect;
+  if (with_bias) {
+    TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, op, bias_index, &ng_bias));
+  }
+  std::vector<shared_ptr<ng::Node>> ng_ranges(requantize ? 6 : 4);
+  for (int i = 0; i < ng_ranges.size(); i++) {
+    int input_index = i < 4 ? min_input_index + i : min_freezed_index + i - 4;
     TF_RETURN_IF_ERROR(
-        GetStaticInputVector(op, 3 + i, static_input_map, &tmp_vect));
-    if (tmp_vect.size() != 1) {
-      return errors::InvalidArgument(
-          "QuantizedConv2DWithBiasAndReluAndRequantize Op: Input number ",
-          (3 + i), " must be scalar. Got a vector of size, ", tmp_vect.size());
+        GetInputNode(ng_op_map, op, input_index, &ng_ranges[i]));
+  }
+
+  // Stock TensorFlow only has a kernel for the plain op, which uses affine
+  // ranges. The fused ops are MKL kernels, which use SCALED mode.
+  if (op_type == "QuantizedConv2D") {
+    DataType input_type, filter_type;
+    TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "Tinput", &input_type));
+    TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "Tfilter", &filter_type));
+    shared_ptr<ng::Node> ng_lhs, ng_rhs;
+    TF_RETURN_IF_ERROR(CenterAffineMode(ng_input, ng_ranges[0], ng_ranges[1],
+                                        input_type, &ng_lhs));
+    TF_RETURN_IF_ERROR(CenterAffineMode(ng_filter, ng_ranges[2],
+                                        ng_ranges[3], filter_type, &ng_rhs));
+    bool is_nhwc;
+    shared_ptr<ng::Node> ng_result;
+    TF_RETURN_IF_ERROR(MakeConv2D(op, ng_lhs, ng_rhs, &is_nhwc, &ng_result));
+    BatchToTensorflow(is_nhwc, ng_result);
+    return SaveAffineModeProduct(op, ng_op_map, ng_result, ng_ranges[0],
+                                 ng_ranges[1], input_type, ng_ranges[2],
+                                 ng_ranges[3], filter_type, "out_type");
+  }
+
+  // nGraph's int8 convolution, if the ranges are known.
+  if (with_bias && requantize && !with_sum &&
+      std::all_of(ng_ranges.begin(), ng_ranges.end(), IsConstantNode) &&
+      std::all_of(ng_ranges.begin(), ng_ranges.end(),
+                  [](const shared_ptr<ng::Node>& ng_range) {
+                    return ng::shape_size(ng_range->get_shape()) == 1;
+                  })) {
+    std::vector<int32> tf_strides;
+    std::vector<int32> tf_dilations;
+    std::string tf_padding_type;
+    TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "strides", &tf_strides));
+    TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "dilations", &tf_dilations));
+    TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "padding", &tf_padding_type));
+    bool is_nhwc = true;
+    ng::Strides ng_strides(2);
+    ng::Strides ng_dilations(2);
+    ng::Strides ng_data_dilations({1, 1});
+    ng::Shape ng_image_shape(2);
+    ng::Shape ng_kernel_shape(2);
+    BatchedOpParamToNGraph(is_nhwc, tf_strides, ng_strides);
+    BatchedOpParamToNGraph(is_nhwc, ng_input->get_shape(), ng_image_shape);
+    BatchedOpParamToNGraph(is_nhwc, tf_dilations, ng_dilations);
+    BatchToNGraph(is_nhwc, ng_input);
+    auto& ng_filter_shape = ng_filter->get_shape();
+    ng_kernel_shape[0] = ng_filter_shape[0];
+    ng_kernel_shape[1] = ng_filter_shape[1];
+    Reshape<3, 2, 0, 1>(ng_filter);
+    ng::CoordinateDiff ng_padding_below{0, 0};
+    ng::CoordinateDiff ng_padding_above{0, 0};
+    Builder::MakePadding(tf_padding_type, ng_image_shape, ng_kernel_shape,
+                         ng_strides, ng_dilations, ng_padding_below,
+                         ng_padding_above);
+    // ScaledQuantizedConvolutionBias expects the ranges to be Constants.
+    std::shared_ptr<ng::Node> ng_quant_conv_bias =
+        ng::builder::ScaledQuantizedConvolutionBias(
+            ng_input, ng_filter, ng_bias, ng_strides, ng_dilations,
+            ng_padding_below, ng_padding_above, ng_data_dilations,
+            ng_ranges[0], ng_ranges[1], ng_ranges[2], ng_ranges[3],
+            ng_ranges[4], ng_ranges[5], with_relu);
+    BatchToTensorflow(is_nhwc, ng_quant_conv_bias);
+    SaveNgOp(ng_op_map, op, ng_quant_conv_bias);
+    // The output range is the frozen one.
+    SaveNgOp(ng_op_map, op, ng_ranges[4]);
+    SaveNgOp(ng_op_map, op, ng_ranges[5]);
+    return Status::OK();
+  }
+
+  DataType input_type, filter_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "Tinput", &input_type));
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "Tfilter", &filter_type));
+  shared_ptr<ng::Node> ng_input_scale, ng_filter_scale;
+  TF_RETURN_IF_ERROR(MakeScaledModeScale(ng_ranges[0], ng_ranges[1],
+                                         input_type, &ng_input_scale));
+  TF_RETURN_IF_ERROR(MakeScaledModeScale(ng_ranges[2], ng_ranges[3],
+                                         filter_type, &ng_filter_scale));
+  // Scalar, or per output channel.
+  shared_ptr<ng::Node> ng_product_scale =
+      BroadcastRange(ng_input_scale, ng_filter_scale->get_shape()) *
+      ng_filter_scale;
+
+  bool is_nhwc;
+  shared_ptr<ng::Node> ng_result;
+  TF_RETURN_IF_ERROR(MakeConv2D(
+      op, DequantizeScaledMode(ng_input, ng_input_scale),
+      DequantizeScaledMode(ng_filter, ng_filter_scale), &is_nhwc, &ng_result));
+  BatchToTensorflow(is_nhwc, ng_result);
+
+  if (with_bias) {
+    ng_result = AddQuantizedBias(ng_result, ng_bias, ng_product_scale);
+  }
+  if (with_sum) {
+    shared_ptr<ng::Node> ng_summand;
+    TF_RETURN_IF_ERROR(
+        GetInputNode(ng_op_map, op, summand_index, &ng_summand));
+    if (requantize) {
+      DataType summand_type;
+      TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "Tsummand", &summand_type));
+      shared_ptr<ng::Node> ng_min_summand, ng_max_summand, ng_summand_scale;
+      TF_RETURN_IF_ERROR(
+          GetInputNode(ng_op_map, op, min_summand_index, &ng_min_summand));
+      TF_RETURN_IF_ERROR(
+          GetInputNode(ng_op_map, op, min_summand_index + 1, &ng_max_summand));
+      TF_RETURN_IF_ERROR(MakeScaledModeScale(ng_min_summand, ng_max_summand,
+                                             summand_type, &ng_summand_scale));
+      ng_summand = DequantizeScaledMode(ng_summand, ng_summand_scale);
     }
-    static_inps[i] = std::make_shared<ng::op::Constant>(
-        ng::element::f32, ng::Shape({}), tmp_vect);
+    ng_result = ng_result + ng_summand;
+  }
+  if (with_relu) {
+    ng_result = make_shared<ng::op::Relu>(ng_result);
+  }
+
+  return SaveQuantizedResult(op, ng_op_map, ng_result, ng_product_scale,
+                             requantize, min_freezed_index, "out_type");
+}
+
+static Status TranslateQuantizedMatMulOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_a, ng_b, ng_min_a, ng_max_a, ng_min_b, ng_max_b;
+  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_a, &ng_b, &ng_min_a,
+                                   &ng_max_a, &ng_min_b, &ng_max_b));
+  DataType a_type, b_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "T1", &a_type));
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "T2", &b_type));
+
+  shared_ptr<ng::Node> ng_lhs, ng_rhs;
+  TF_RETURN_IF_ERROR(
+      CenterAffineMode(ng_a, ng_min_a, ng_max_a, a_type, &ng_lhs));
+  TF_RETURN_IF_ERROR(
+      CenterAffineMode(ng_b, ng_min_b, ng_max_b, b_type, &ng_rhs));
+  bool transpose_a = false;
+  bool transpose_b = false;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "transpose_a", &transpose_a));
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "transpose_b", &transpose_b));
+  if (transpose_a) {
+    ng_lhs = ng::builder::numpy_transpose(ng_lhs, ng::AxisVector{1, 0});
+  }
+  if (transpose_b) {
+    ng_rhs = ng::builder::numpy_transpose(ng_rhs, ng::AxisVector{1, 0});
   }
+  return SaveAffineModeProduct(op, ng_op_map,
+                               make_shared<ng::op::Dot>(ng_lhs, ng_rhs),
+                               ng_min_a, ng_max_a, a_type, ng_min_b, ng_max_b,
+                               b_type, "Toutput");
+}
+
+static Status TranslateQuantizedMaxPoolOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_input, ng_min, ng_max;
+  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input, &ng_min, &ng_max));
   std::vector<int32> tf_strides;
-  std::vector<int32> tf_dilations;
+  std::vector<int32> tf_ksize;
   std::string tf_padding_type;
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "strides", &tf_strides));
-  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "dilations", &tf_dilations));
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "ksize", &tf_ksize));
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "padding", &tf_padding_type));
-  bool is_nhwc = true;  // TODO: Assuming this data format for now
+  bool is_nhwc = true;  // TODO, is this correct?
   ng::Strides ng_strides(2);
-  ng::Strides ng_dilations(2);
-  ng::Strides ng_data_dilations({1, 1});
   ng::Shape ng_image_shape(2);
   ng::Shape ng_kernel_shape(2);
   BatchedOpParamToNGraph(is_nhwc, tf_strides, ng_strides);
-  BatchedOpParamToNGraph(is_nhwc, ng_input->get_shape(), ng_image_shape);
-  BatchedOpParamToNGraph(is_nhwc, tf_dilations, ng_dilations);
+  BatchedOpParamToNGraph(is_nhwc, ng_input->get_output_shape(0),
+                         ng_image_shape);
+  BatchedOpParamToNGraph(is_nhwc, tf_ksize, ng_kernel_shape);
   BatchToNGraph(is_nhwc, ng_input);
-  auto& ng_filter_shape = ng_filter->get_shape();
-  ng_kernel_shape[0] = ng_filter_shape[0];
-  ng_kernel_shape[1] = ng_filter_shape[1];
-  Reshape<3, 2, 0, 1>(ng_filter);
-  ng::CoordinateDiff ng_padding_below{0, 0};
-  ng::CoordinateDiff ng_padding_above{0, 0};
+  ng::Shape ng_padding_below{0, 0};
+  ng::Shape ng_padding_above{0, 0};
   Builder::MakePadding(tf_padding_type, ng_image_shape, ng_kernel_shape,
-                       ng_strides, ng_dilations, ng_padding_below,
-                       ng_padding_above);
-  // It is expected by ScaledQuantizedConvolutionBias that the min max inputs be
-  // constant nodes
-  // Hence declaring them static, reading their values and converting to
-  // constant nodes
-  std::shared_ptr<ng::Node> ng_quant_conv_bias =
-      ng::builder::ScaledQuantizedConvolutionBias(
-          ng_input, ng_filter, ng_bias, ng_strides, ng_dilations,
-          ng_padding_below, ng_padding_above, ng_data_dilations, static_inps[0],
-          static_inps[1], static_inps[2], static_inps[3], static_inps[4],
-          static_inps[5], true);
-  BatchToTensorflow(is_nhwc, ng_quant_conv_bias);
-  SaveNgOp(ng_op_map, op->name(), ng_quant_conv_bias);
-  // Forward the min_freezed_output input to output min
-  SaveNgOp(ng_op_map, op->name(), static_inps[4]);
-  // Forward the max_freezed_output input to output max
-  SaveNgOp(ng_op_map, op->name(), static_inps[5]);
+                       ng_strides, ng_padding_below, ng_padding_above);
+
+  // Creating and passing dummy nodes to ScaledQuantizedMaxPool because it does
+  // not use them. If it ever starts using min/max, the dummy min-max would
+  // cause it to fail
+  shared_ptr<ng::Node> dummy_min(nullptr), dummy_max(nullptr);
+  std::shared_ptr<ng::Node> ng_quant_maxpool =
+      ng::builder::ScaledQuantizedMaxPool(ng_input, ng_kernel_shape, ng_strides,
+                                          ng_padding_below, ng_padding_above,
+                                          dummy_min, dummy_max);
+  BatchToTensorflow(is_nhwc, ng_quant_maxpool);
+  SaveNgOp(ng_op_map, op, ng_quant_maxpool);
+  // For maxpool input min-max remains unchanged and is just propagated along
+  // https://github.com/tensorflow/tensorflow/blob/9590c4c32dd4346ea5c35673336f5912c6072bf2/tensorflow/core/kernels/quantized_pooling_ops.cc#L99
+  SaveNgOp(ng_op_map, op, ng_min);
+  SaveNgOp(ng_op_map, op, ng_max);
   return Status::OK();
 }
 
-static Status TranslateQuantizedMaxPoolOp(
+// The average of values that share a range is computed on the quantized
+// values directly; the range is passed through.
+static Status TranslateQuantizedAvgPoolOp(
     const Node* op, const std::vector<const Tensor*>& static_input_map,
     Builder::OpMap& ng_op_map) {
   shared_ptr<ng::Node> ng_input, ng_min, ng_max;
@@ -2585,13 +3216,13 @@ static Status TranslateQuantizedMaxPoolOp(
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "strides", &tf_strides));
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "ksize", &tf_ksize));
   TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "padding", &tf_padding_type));
-  bool is_nhwc = true;  // TODO, is this correct?
+  bool is_nhwc = true;
+  ng::element::Type ng_et = ng_input->get_element_type();
   ng::Strides ng_strides(2);
   ng::Shape ng_image_shape(2);
   ng::Shape ng_kernel_shape(2);
   BatchedOpParamToNGraph(is_nhwc, tf_strides, ng_strides);
-  BatchedOpParamToNGraph(is_nhwc, ng_input->get_output_shape(0),
-                         ng_image_shape);
+  BatchedOpParamToNGraph(is_nhwc, ng_input->get_shape(), ng_image_shape);
   BatchedOpParamToNGraph(is_nhwc, tf_ksize, ng_kernel_shape);
   BatchToNGraph(is_nhwc, ng_input);
   ng::Shape ng_padding_below{0, 0};
@@ -2599,20 +3230,151 @@ static Status TranslateQuantizedMaxPoolOp(
   Builder::MakePadding(tf_padding_type, ng_image_shape, ng_kernel_shape,
                        ng_strides, ng_padding_below, ng_padding_above);
 
-  // Creating and passing dummy nodes to ScaledQuantizedMaxPool because it does
-  // not use them. If it ever starts using min/max, the dummy min-max would
-  // cause it to fail
-  shared_ptr<ng::Node> dummy_min(nullptr), dummy_max(nullptr);
-  std::shared_ptr<ng::Node> ng_quant_maxpool =
-      ng::builder::ScaledQuantizedMaxPool(ng_input, ng_kernel_shape, ng_strides,
-                                          ng_padding_below, ng_padding_above,
-                                          dummy_min, dummy_max);
-  BatchToTensorflow(is_nhwc, ng_quant_maxpool);
-  SaveNgOp(ng_op_map, op->name(), ng_quant_maxpool);
-  // For maxpool input min-max remains unchanged and is just propagated along
-  // https://github.com/tensorflow/tensorflow/blob/9590c4c32dd4346ea5c35673336f5912c6072bf2/tensorflow/core/kernels/quantized_pooling_ops.cc#L99
-  SaveNgOp(ng_op_map, op->name(), ng_min);
-  SaveNgOp(ng_op_map, op->name(), ng_max);
+  shared_ptr<ng::Node> ng_avgpool = make_shared<ng::op::AvgPool>(
+      make_shared<ng::op::Convert>(ng_input, ng::element::f32),
+      ng_kernel_shape, ng_strides, ng_padding_below, ng_padding_above, false);
+  auto& ng_shape = ng_avgpool->get_shape();
+  auto ng_half = make_shared<ng::op::Constant>(
+      ng::element::f32, ng_shape,
+      std::vector<float>(ng::shape_size(ng_shape), 0.5f));
+  ng_avgpool = make_shared<ng::op::Convert>(
+      make_shared<ng::op::Floor>(ng_avgpool + ng_half), ng_et);
+  BatchToTensorflow(is_nhwc, ng_avgpool);
+  SaveNgOp(ng_op_map, op, ng_avgpool);
+  SaveNgOp(ng_op_map, op, ng_min);
+  SaveNgOp(ng_op_map, op, ng_max);
+  return Status::OK();
+}
+
+// QuantizedConcat takes concat_dim, values, input_mins, input_maxes. The
+// output range is the union of the input ranges and zero, and values in a
+// different range are requantized to it.
+static Status TranslateQuantizedConcatOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  int num_values;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "N", &num_values));
+  TF_RETURN_IF_ERROR(ValidateInputCount(op, 3 * num_values + 1));
+  DataType dtype;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "T", &dtype));
+
+  const int first_min_index = num_values + 1;
+  const int first_max_index = 2 * num_values + 1;
+
+  std::vector<int64> tf_concat_axis_vec;
+  TF_RETURN_IF_ERROR(
+      GetStaticInputVector(op, 0, static_input_map, &tf_concat_axis_vec));
+  int64 concat_axis = tf_concat_axis_vec[0];
+
+  // The ranges are scalars.
+  auto to_scalar = [](shared_ptr<ng::Node> ng_range) {
+    auto& ng_shape = ng_range->get_shape();
+    return make_shared<ng::op::Reshape>(
+        ng_range, ng::get_default_order(ng_shape.size()), ng::Shape{});
+  };
+  ng::NodeVector ng_values, ng_mins, ng_maxes;
+  shared_ptr<ng::Node> ng_out_min = MakeFilledConstant(ng::Shape{}, 0.0f);
+  shared_ptr<ng::Node> ng_out_max;
+  for (int i = 0; i < num_values; i++) {
+    shared_ptr<ng::Node> ng_value, ng_min, ng_max;
+    TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, op, 1 + i, &ng_value));
+    TF_RETURN_IF_ERROR(
+        GetInputNode(ng_op_map, op, first_min_index + i, &ng_min));
+    TF_RETURN_IF_ERROR(
+        GetInputNode(ng_op_map, op, first_max_index + i, &ng_max));
+    ng_min = to_scalar(ng_min);
+    ng_max = to_scalar(ng_max);
+    ng_values.push_back(ng_value);
+    ng_mins.push_back(ng_min);
+    ng_maxes.push_back(ng_max);
+    ng_out_min = make_shared<ng::op::Minimum>(ng_out_min, ng_min);
+    ng_out_max = (i == 0) ? ng_max
+                          : make_shared<ng::op::Maximum>(ng_out_max, ng_max);
+  }
+  if (concat_axis < 0) {
+    concat_axis += int64(ng_values[0]->get_shape().size());
+  }
+
+  for (int i = 0; i < num_values; i++) {
+    shared_ptr<ng::Node> ng_real, ng_requantized;
+    TF_RETURN_IF_ERROR(DequantizeAffineMode(ng_values[i], ng_mins[i],
+                                            ng_maxes[i], dtype, &ng_real));
+    TF_RETURN_IF_ERROR(QuantizeAffineModeUnclamped(
+        ng_real, ng_out_min, ng_out_max, dtype, &ng_requantized));
+    TF_RETURN_IF_ERROR(
+        ClampToQuantizedType(ng_requantized, dtype, &ng_requantized));
+    // Values already in the output range are copied, as TensorFlow does.
+    auto ng_same_range = make_shared<ng::op::And>(
+        make_shared<ng::op::Equal>(ng_mins[i], ng_out_min),
+        make_shared<ng::op::Equal>(ng_maxes[i], ng_out_max));
+    ng_values[i] = make_shared<ng::op::Select>(
+        BroadcastRange(ng_same_range, ng_values[i]->get_shape()),
+        ng_values[i], ng_requantized);
+  }
+
+  SaveNgOp(ng_op_map, op,
+           make_shared<ng::op::Concat>(ng_values, size_t(concat_axis)));
+  SaveNgOp(ng_op_map, op, ng_out_min);
+  SaveNgOp(ng_op_map, op, ng_out_max);
+  return Status::OK();
+}
+
+// Follows TensorFlow's fixed point requantization of qint32 values:
+// quantized = floor((real - min_output) * steps_per_unit + 0.5).
+static Status TranslateRequantizeOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_input, ng_input_min, ng_input_max, ng_out_min,
+      ng_out_max;
+  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input, &ng_input_min,
+                                   &ng_input_max, &ng_out_min, &ng_out_max));
+  DataType input_type, out_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "Tinput", &input_type));
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "out_type", &out_type));
+  float out_lowest, out_highest;
+  TF_RETURN_IF_ERROR(GetQuantizedLimits(out_type, &out_lowest, &out_highest));
+
+  shared_ptr<ng::Node> ng_real, ng_steps_per_unit, ng_result;
+  TF_RETURN_IF_ERROR(DequantizeAffineMode(ng_input, ng_input_min,
+                                          ng_input_max, input_type, &ng_real));
+  TF_RETURN_IF_ERROR(MakeAffineModeStepsPerUnit(ng_out_min, ng_out_max,
+                                                out_type, &ng_steps_per_unit));
+  auto& ng_shape = ng_real->get_shape();
+  auto ng_quantized = make_shared<ng::op::Floor>(
+      (ng_real - BroadcastRange(ng_out_min, ng_shape)) *
+          BroadcastRange(ng_steps_per_unit, ng_shape) +
+      MakeFilledConstant(ng_shape, out_lowest + 0.5f));
+  TF_RETURN_IF_ERROR(
+      ClampToQuantizedType(ng_quantized, out_type, &ng_result));
+  SaveNgOp(ng_op_map, op, ng_result);
+  SaveNgOp(ng_op_map, op, ng_out_min);
+  SaveNgOp(ng_op_map, op, ng_out_max);
+  return Status::OK();
+}
+
+// The range of the values actually used, widened to include zero from below.
+static Status TranslateRequantizationRangeOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_input, ng_input_min, ng_input_max;
+  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input, &ng_input_min,
+                                   &ng_input_max));
+  DataType input_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "Tinput", &input_type));
+
+  shared_ptr<ng::Node> ng_values;
+  TF_RETURN_IF_ERROR(DequantizeAffineMode(ng_input, ng_input_min,
+                                          ng_input_max, input_type,
+                                          &ng_values));
+  ng::AxisSet ng_all_axes;
+  for (size_t i = 0; i < ng_values->get_shape().size(); i++) {
+    ng_all_axes.insert(i);
+  }
+  SaveNgOp(ng_op_map, op,
+           make_shared<ng::op::Minimum>(
+               make_shared<ng::op::Min>(ng_values, ng_all_axes),
+               MakeFilledConstant(ng::Shape{}, 0.0f)));
+  SaveNgOp(ng_op_map, op, make_shared<ng::op::Max>(ng_values, ng_all_axes));
   return Status::OK();
 }
 
@@ -2703,15 +3465,15 @@ static Status TranslateQuantizeV2Op(
   ng::op::Quantize::RoundMode ng_round_mode =
       ng::op::Quantize::RoundMode::ROUND_NEAREST_TOWARD_INFINITY;
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Quantize>(ng_input, ng_scale, ng_offset, ng_et,
                                          ng::AxisSet(), ng_round_mode));
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Constant>(ng::element::f32, ng::Shape(),
                                          std::vector<float>({ng_min[0]})));
   // TODO: For quantizev2 revisit output min-max (which would change in case
   // input min-max are too close. For now just propagating inputs
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Constant>(ng::element::f32, ng::Shape(),
                                          std::vector<float>({ng_max[0]})));
   return Status::OK();
@@ -2790,7 +3552,7 @@ static Status TranslateDequantizeOp(
   auto ng_offset = std::make_shared<ng::op::Constant>(
       ng_et, ng::Shape(), std::vector<int>({ng_offset_val}));
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Dequantize>(ng_input, ng_scale, ng_offset,
                                            ng::element::f32, ng::AxisSet()));
   return Status::OK();
@@ -2802,23 +3564,25 @@ static Status TranslateReluOp(
   shared_ptr<ng::Node> ng_input;
   TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input));
 
-  SaveNgOp(ng_op_map, op->name(), make_shared<ng::op::Relu>(ng_input));
+  SaveNgOp(ng_op_map, op, make_shared<ng::op::Relu>(ng_input));
   return Status::OK();
 }
 
+static shared_ptr<ng::Node> MakeRelu6(const shared_ptr<ng::Node>& ng_input) {
+  auto constant_6 = make_shared<ng::op::Constant>(
+      ng_input->get_element_type(), ng_input->get_shape(),
+      std::vector<std::string>(ng::shape_size(ng_input->get_shape()), "6"));
+  return make_shared<ng::op::Minimum>(make_shared<ng::op::Relu>(ng_input),
+                                      constant_6);
+}
+
 static Status TranslateRelu6Op(
     const Node* op, const std::vector<const Tensor*>& static_input_map,
     Builder::OpMap& ng_op_map) {
   shared_ptr<ng::Node> ng_input;
   TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_input));
 
-  auto constant_6 = make_shared<ng::op::Constant>(
-      ng_input->get_element_type(), ng_input->get_shape(),
-      std::vector<std::string>(ng::shape_size(ng_input->get_shape()), "6"));
-  auto relu6_op = make_shared<ng::op::Minimum>(
-      make_shared<ng::op::Relu>(ng_input), constant_6);
-
-  SaveNgOp(ng_op_map, op->name(), relu6_op);
+  SaveNgOp(ng_op_map, op, MakeRelu6(ng_input));
   return Status::OK();
 }
 
@@ -2829,7 +3593,7 @@ static Status TranslateReluGradOp(
   TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_delta, &ng_arg));
 
   auto ng_relu_grad = std::make_shared<ng::op::ReluBackprop>(ng_arg, ng_delta);
-  SaveNgOp(ng_op_map, op->name(), ng_relu_grad);
+  SaveNgOp(ng_op_map, op, ng_relu_grad);
   return Status::OK();
 }
 
@@ -2894,7 +3658,7 @@ static Status TranslateReshapeOp(
   ng::AxisVector ng_axis_order(ng_input->get_shape().size());
   std::iota(ng_axis_order.begin(), ng_axis_order.end(), 0);
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Reshape>(ng_input, ng_axis_order, ng_shape));
   return Status::OK();
 }
@@ -2917,6 +3681,49 @@ static Status TranslateRsqrtOp(
       });
 }
 
+static Status TranslateSelectOp(
+    const Node* op, const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_condition, ng_then, ng_else;
+  TF_RETURN_IF_ERROR(
+      GetInputNodes(ng_op_map, op, &ng_condition, &ng_then, &ng_else));
+
+  auto ng_condition_shape = ng_condition->get_shape();
+  auto ng_then_shape = ng_then->get_shape();
+
+  if (ng_then_shape != ng_else->get_shape()) {
+    return errors::InvalidArgument(
+        "Select requires both branches to have the same shape, got ",
+        ng::join(ng_then_shape), " and ", ng::join(ng_else->get_shape()));
+  }
+
+  // TensorFlow allows the condition to be a scalar, or a vector matching the
+  // first dimension of the branches; nGraph wants identical shapes.
+  if (ng_condition_shape != ng_then_shape) {
+    ng::AxisSet ng_broadcast_axes;
+    if (ng_condition_shape.size() == 0) {
+      for (size_t i = 0; i < ng_then_shape.size(); i++) {
+        ng_broadcast_axes.insert(i);
+      }
+    } else if (ng_condition_shape.size() == 1 && ng_then_shape.size() > 1 &&
+               ng_condition_shape[0] == ng_then_shape[0]) {
+      for (size_t i = 1; i < ng_then_shape.size(); i++) {
+        ng_broadcast_axes.insert(i);
+      }
+    } else {
+      return errors::InvalidArgument(
+          "Select condition of shape ", ng::join(ng_condition_shape),
+          " is incompatible with branches of shape ", ng::join(ng_then_shape));
+    }
+    ng_condition = make_shared<ng::op::Broadcast>(ng_condition, ng_then_shape,
+                                                  ng_broadcast_axes);
+  }
+
+  SaveNgOp(ng_op_map, op,
+           make_shared<ng::op::Select>(ng_condition, ng_then, ng_else));
+  return Status::OK();
+}
+
 static Status TranslateShapeOp(
     const Node* op, const std::vector<const Tensor*>& static_input_map,
     Builder::OpMap& ng_op_map) {
@@ -2942,8 +3749,7 @@ static Status TranslateShapeOp(
   for (int i = 0; i < rank; i++) {
     values[i] = input_shape[i];
   }
-  SaveNgOp(ng_op_map, op->name(),
-           make_shared<ng::op::Constant>(type, shape, values));
+  SaveNgOp(ng_op_map, op, make_shared<ng::op::Constant>(type, shape, values));
   return Status::OK();
 }
 
@@ -2961,7 +3767,7 @@ static Status TranslateSigmoidGradOp(
                      ng_input;
   auto ng_result = ng_mul * ng_subtract;
 
-  SaveNgOp(ng_op_map, op->name(), ng_result);
+  SaveNgOp(ng_op_map, op, ng_result);
   return Status::OK();
 }
 
@@ -2979,7 +3785,7 @@ static Status TranslateSigmoidOp(
 
   auto denominator_op = make_shared<ng::op::Add>(constant_1, exp_op);
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Divide>(constant_1, denominator_op));
   return Status::OK();
 }
@@ -3008,7 +3814,7 @@ static Status TranslateSizeOp(
   auto ng_result = make_shared<ng::op::Constant>(type, ng::Shape(0),
                                                  std::vector<int64>({result}));
 
-  SaveNgOp(ng_op_map, op->name(), ng_result);
+  SaveNgOp(ng_op_map, op, ng_result);
   return Status::OK();
 }
 
@@ -3065,7 +3871,7 @@ static Status TranslateSliceOp(
   std::vector<size_t> l(lower_vec.begin(), lower_vec.end());
   std::vector<size_t> u(upper_vec.begin(), upper_vec.end());
   auto ng_slice = make_shared<ng::op::Slice>(ng_input, l, u);
-  SaveNgOp(ng_op_map, op->name(), ng_slice);
+  SaveNgOp(ng_op_map, op, ng_slice);
   return Status::OK();
 }
 
@@ -3075,7 +3881,7 @@ static Status TranslateSnapshotOp(
   shared_ptr<ng::Node> ng_arg;
   TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, op, &ng_arg));
 
-  SaveNgOp(ng_op_map, op->name(), ng_arg);
+  SaveNgOp(ng_op_map, op, ng_arg);
   return Status::OK();
 }
 
@@ -3094,7 +3900,7 @@ static Status TranslateSoftmaxOp(
 
   ng_axes_softmax.insert(1);
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Softmax>(ng_input, ng_axes_softmax));
   return Status::OK();
 }
@@ -3172,7 +3978,7 @@ static Status TranslateSpaceToDepthOp(
     }
   }
 
-  SaveNgOp(ng_op_map, op->name(), make_shared<ngraph::op::Concat>(
+  SaveNgOp(ng_op_map, op, make_shared<ngraph::op::Concat>(
                                       strided_slice_result, channel_index));
   return Status::OK();
 }
@@ -3279,8 +4085,8 @@ static Status TranslateSparseSoftmaxCrossEntropyWithLogitsOp(
   auto ng_backprop =
       make_shared<ng::op::Subtract>(predicted_prob, ng_onehot_labels_float);
 
-  SaveNgOp(ng_op_map, op->name(), ng_loss);
-  SaveNgOp(ng_op_map, op->name(), ng_backprop);
+  SaveNgOp(ng_op_map, op, ng_loss);
+  SaveNgOp(ng_op_map, op, ng_backprop);
   return Status::OK();
 }
 
@@ -3315,8 +4121,7 @@ static Status TranslateSplitOp(
     upper[split_dim] = cursor;
 
     std::string output_name = op->name();
-    SaveNgOp(ng_op_map, op->name(),
-             make_shared<ng::op::Slice>(ng_input, lower, upper));
+    SaveNgOp(ng_op_map, op, make_shared<ng::op::Slice>(ng_input, lower, upper));
   }
   return Status::OK();
 }
@@ -3363,11 +4168,11 @@ static Status TranslateSplitVOp(
       lower[split_dim] = cursor;
       cursor += lengths[i];
       upper[split_dim] = cursor;
-      SaveNgOp(ng_op_map, op->name(),
+      SaveNgOp(ng_op_map, op,
                make_shared<ng::op::Slice>(ng_input, lower, upper));
     }
   } else {
-    SaveNgOp(ng_op_map, op->name(), ng_input);
+    SaveNgOp(ng_op_map, op, ng_input);
   }
 
   return Status::OK();
@@ -3441,7 +4246,7 @@ static Status TranslateSqueezeOp(
   ng::AxisVector ng_axis_order(ng_input->get_shape().size());
   std::iota(ng_axis_order.begin(), ng_axis_order.end(), 0);
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            make_shared<ng::op::Reshape>(ng_input, ng_axis_order, output_shape));
   return Status::OK();
 }
@@ -3731,7 +4536,7 @@ static Status TranslateStridedSliceOp(
   // time?
   // TODO: tf_new_axis_mask can exceed rank
 
-  SaveNgOp(ng_op_map, op->name(), ng_strided_slice);
+  SaveNgOp(ng_op_map, op, ng_strided_slice);
   return Status::OK();
 }
 
@@ -3780,7 +4585,7 @@ static Status TranslateSumOp(const Node* op,
                                           ng_result_shape_with_keep);
   }
 
-  SaveNgOp(ng_op_map, op->name(), ng_sum);
+  SaveNgOp(ng_op_map, op, ng_sum);
   return Status::OK();
 }
 
@@ -3801,7 +4606,7 @@ static Status TranslateTanhGradOp(
   auto ng_sub = make_shared<ng::op::Subtract>(ng_const, ng_sq);
   auto ng_result = make_shared<ng::op::Multiply>(ng_delta, ng_sub);
 
-  SaveNgOp(ng_op_map, op->name(), ng_result);
+  SaveNgOp(ng_op_map, op, ng_result);
   return Status::OK();
 }
 
@@ -3829,24 +4634,34 @@ static Status TranslateTileOp(
     output_shape[i] = ng_input_shape[i] * multiples[i];
   }
   if (is_empty) {
-    SaveNgOp(ng_op_map, op->name(),
+    SaveNgOp(ng_op_map, op,
              make_shared<ngraph::op::Constant>(
                  ng_input->get_element_type(), output_shape,
                  std::vector<std::string>(ng::shape_size(output_shape), "0")));
   } else {
+    // Broadcast [d0, d1, ...] to [m0, d0, m1, d1, ...], then collapse each
+    // (mi, di) pair, so the node count does not depend on the multiples.
+    ng::Shape ng_broadcast_shape;
+    ng::AxisSet ng_broadcast_axes;
     for (int i = 0; i < ng_input_shape.size(); i++) {
       if (multiples[i] < 0) {
         return errors::InvalidArgument("Expected multiples[", i,
                                        "] >= 0, but got ", multiples[i]);
       }
-      vector<shared_ptr<ng::Node>> tmp_tensors;
-      for (int k = 0; k < multiples[i]; k++) {
-        tmp_tensors.push_back(ng_output);
+      if (multiples[i] != 1) {
+        ng_broadcast_axes.insert(ng_broadcast_shape.size());
+        ng_broadcast_shape.push_back(multiples[i]);
       }
-      auto ng_concat = make_shared<ngraph::op::Concat>(tmp_tensors, i);
-      ng_output = ng_concat;
+      ng_broadcast_shape.push_back(ng_input_shape[i]);
+    }
+    if (!ng_broadcast_axes.empty()) {
+      auto ng_broadcast = make_shared<ng::op::Broadcast>(
+          ng_input, ng_broadcast_shape, ng_broadcast_axes);
+      ng_output = make_shared<ng::op::Reshape>(
+          ng_broadcast, ng::get_default_order(ng_broadcast_shape),
+          output_shape);
     }
-    SaveNgOp(ng_op_map, op->name(), ng_output);
+    SaveNgOp(ng_op_map, op, ng_output);
   }
   return Status::OK();
 }
@@ -3873,7 +4688,7 @@ static Status TranslateTransposeOp(
 
   NGRAPH_VLOG(3) << ng::join(ng_axis_order);
 
-  SaveNgOp(ng_op_map, op->name(),
+  SaveNgOp(ng_op_map, op,
            ng::builder::numpy_transpose(ng_input, ng_axis_order));
   return Status::OK();
 }
@@ -3926,7 +4741,7 @@ static Status TranslateUnpackOp(
         make_shared<ngraph::op::Slice>(ng_input, lower_bound, upper_bound);
     auto reshaped =
         make_shared<ng::op::Reshape>(slice, ng_axis_order, output_shape);
-    SaveNgOp(ng_op_map, op->name(), reshaped);
+    SaveNgOp(ng_op_map, op, reshaped);
   }
   return Status::OK();
 }
@@ -3942,7 +4757,827 @@ static Status TranslateZerosLikeOp(
   auto ng_result = make_shared<ng::op::Constant>(ng_input->get_element_type(),
                                                  input_shape, const_values);
 
-  SaveNgOp(ng_op_map, op->name(), ng_result);
+  SaveNgOp(ng_op_map, op, ng_result);
+  return Status::OK();
+}
+
+//
+// Convolution epilogues. A Conv2D or DepthwiseConv2dNative followed by a
+// BiasAdd or an inference-mode FusedBatchNorm, and optionally by a Relu or
+// Relu6, is translated as a unit: the whole chain is built in nGraph's NCHW
+// layout, with one layout conversion at the end. Translated op by op, every
+// NHWC op in the chain would get its own conversions, which keeps the
+// backend's fusion passes (e.g. ConvolutionBias on CPU) from recognizing it.
+//
+// An inference-mode batch norm is folded into the convolution: with
+// s = scale / sqrt(variance + epsilon), each output channel k of the filter
+// is multiplied by s[k], and offset - mean * s is added as a bias. When the
+// filter and the batch norm parameters are all constants, the folded filter
+// and bias are computed here, and no trace of the batch norm is left at run
+// time. Otherwise (e.g. they come from variables) the folding is done by the
+// function itself, on every call, at the cost of a pass over the filter
+// instead of a pass over the convolution's output.
+//
+// Each op in the chain other than the last must be the only consumer of the
+// one before. The chain is translated when its last op is reached; the
+// others are skipped.
+//
+struct ConvEpilogue {
+  const Node* conv = nullptr;
+  const Node* bias_add = nullptr;
+  const Node* batch_norm = nullptr;
+  const Node* activation = nullptr;
+
+  const Node* Last() const {
+    if (activation != nullptr) return activation;
+    return bias_add != nullptr ? bias_add : batch_norm;
+  }
+};
+
+static bool EpilogueFusionEnabled() {
+  return std::getenv("NGRAPH_TF_DISABLE_EPILOGUE_FUSION") == nullptr;
+}
+
+// Returns the only consumer of "node", if it has exactly one and that
+// consumer reads output 0 of "node" as its input 0.
+static const Node* GetSoleConsumer(const Node* node) {
+  const Node* consumer = nullptr;
+  for (auto edge : node->out_edges()) {
+    if (edge->IsControlEdge()) {
+      continue;
+    }
+    if (consumer != nullptr || edge->src_output() != 0 ||
+        edge->dst_input() != 0) {
+      return nullptr;
+    }
+    consumer = edge->dst();
+  }
+  return consumer;
+}
+
+// Gets the node feeding input "index" of "node", provided it is output 0.
+static const Node* GetInputOp(const Node* node, int index) {
+  for (auto edge : node->in_edges()) {
+    if (!edge->IsControlEdge() && edge->dst_input() == index) {
+      return edge->src_output() == 0 ? edge->src() : nullptr;
+    }
+  }
+  return nullptr;
+}
+
+static bool OnlyFirstOutputUsed(const Node* node) {
+  for (auto edge : node->out_edges()) {
+    if (!edge->IsControlEdge() && edge->src_output() != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static string DataFormat(const Node* node) {
+  string data_format;
+  if (GetNodeAttr(node->attrs(), "data_format", &data_format) !=
+      Status::OK()) {
+    return "NHWC";
+  }
+  return data_format;
+}
+
+static bool MatchConvEpilogue(const Node* conv, ConvEpilogue* epilogue) {
+  if (conv->type_string() != "Conv2D" &&
+      conv->type_string() != "DepthwiseConv2dNative") {
+    return false;
+  }
+
+  const Node* next = GetSoleConsumer(conv);
+  if (next == nullptr || DataFormat(next) != DataFormat(conv)) {
+    return false;
+  }
+  if (next->type_string() == "BiasAdd") {
+    epilogue->bias_add = next;
+  } else if (next->type_string() == "FusedBatchNorm") {
+    bool is_training;
+    if (GetNodeAttr(next->attrs(), "is_training", &is_training) !=
+            Status::OK() ||
+        is_training || !OnlyFirstOutputUsed(next)) {
+      return false;
+    }
+    epilogue->batch_norm = next;
+  } else {
+    return false;
+  }
+  epilogue->conv = conv;
+
+  const Node* activation = GetSoleConsumer(next);
+  if (activation != nullptr && (activation->type_string() == "Relu" ||
+                                activation->type_string() == "Relu6")) {
+    epilogue->activation = activation;
+  }
+  return true;
+}
+
+// Gets the values of a Const float input of "op", if it is one.
+static bool GetConstFloatInput(const Node* op, int index, Tensor* value) {
+  const Node* input = GetInputOp(op, index);
+  return input != nullptr && input->type_string() == "Const" &&
+         GetStaticNodeTensor(input, {}, value) == Status::OK() &&
+         value->dtype() == DT_FLOAT;
+}
+
+// Folds the batch norm of "epilogue" into its convolution's filter on the
+// host. In both the HWIO and the HWCM layouts, the output channel varies
+// fastest. Returns false if any of the inputs is not a constant.
+static bool FoldConstantBatchNorm(const ConvEpilogue& epilogue, float epsilon,
+                                  shared_ptr<ng::Node>* ng_filter,
+                                  shared_ptr<ng::Node>* ng_bias) {
+  Tensor filter, scale, offset, mean, variance;
+  if (!GetConstFloatInput(epilogue.conv, 1, &filter) ||
+      !GetConstFloatInput(epilogue.batch_norm, 1, &scale) ||
+      !GetConstFloatInput(epilogue.batch_norm, 2, &offset) ||
+      !GetConstFloatInput(epilogue.batch_norm, 3, &mean) ||
+      !GetConstFloatInput(epilogue.batch_norm, 4, &variance) ||
+      filter.dims() != 4) {
+    return false;
+  }
+
+  int64 channels = filter.dim_size(3);
+  if (epilogue.conv->type_string() == "DepthwiseConv2dNative") {
+    channels *= filter.dim_size(2);
+  }
+  if (scale.NumElements() != channels || offset.NumElements() != channels ||
+      mean.NumElements() != channels || variance.NumElements() != channels) {
+    return false;
+  }
+
+  std::vector<float> channel_scale(channels);
+  std::vector<float> folded_bias(channels);
+  for (int64 k = 0; k < channels; k++) {
+    channel_scale[k] =
+        scale.flat<float>()(k) / std::sqrt(variance.flat<float>()(k) + epsilon);
+    folded_bias[k] =
+        offset.flat<float>()(k) - mean.flat<float>()(k) * channel_scale[k];
+  }
+
+  auto filter_values = filter.flat<float>();
+  std::vector<float> folded_filter(filter_values.size());
+  for (int64 i = 0; i < filter_values.size(); i++) {
+    folded_filter[i] = filter_values(i) * channel_scale[i % channels];
+  }
+
+  ng::Shape ng_filter_shape;
+  TF_CHECK_OK(TFTensorShapeToNGraphShape(filter.shape(), &ng_filter_shape));
+  *ng_filter = make_shared<ng::op::Constant>(ng::element::f32, ng_filter_shape,
+                                             folded_filter);
+  *ng_bias = make_shared<ng::op::Constant>(
+      ng::element::f32, ng::Shape{size_t(channels)}, folded_bias);
+  return true;
+}
+
+// As FoldConstantBatchNorm, but builds the folding into the function.
+static Status FoldBatchNorm(const ConvEpilogue& epilogue, float epsilon,
+                            const Builder::OpMap& ng_op_map,
+                            shared_ptr<ng::Node>* ng_filter,
+                            shared_ptr<ng::Node>* ng_bias) {
+  shared_ptr<ng::Node> ng_scale, ng_offset, ng_mean, ng_variance;
+  TF_RETURN_IF_ERROR(GetInputNodes(ng_op_map, epilogue.batch_norm, nullptr,
+                                   &ng_scale, &ng_offset, &ng_mean,
+                                   &ng_variance));
+
+  ng::element::Type ng_et = ng_variance->get_element_type();
+  const ng::Shape& ng_channel_shape = ng_variance->get_shape();
+  auto channel_constant = [&](float value) {
+    return make_shared<ng::op::Constant>(
+        ng_et, ng_channel_shape,
+        std::vector<float>(ng::shape_size(ng_channel_shape), value));
+  };
+  shared_ptr<ng::Node> ng_channel_scale =
+      ng_scale *
+      make_shared<ng::op::Power>(ng_variance + channel_constant(epsilon),
+                                 channel_constant(-0.5f));
+  *ng_bias = ng_offset - ng_mean * ng_channel_scale;
+
+  // Conv2D filters are HWIO, so the scale is broadcast along everything but
+  // O. Depthwise filters are HWCM, with output channel c * M + m.
+  const ng::Shape& ng_filter_shape = (*ng_filter)->get_shape();
+  if (ng_filter_shape.size() != 4 || ng_channel_shape.size() != 1) {
+    return errors::InvalidArgument("Unexpected filter or batch norm shape in ",
+                                   epilogue.conv->name());
+  }
+  ng::AxisSet ng_broadcast_axes{0, 1, 2};
+  size_t channels = ng_filter_shape[3];
+  if (epilogue.conv->type_string() == "DepthwiseConv2dNative") {
+    ng_broadcast_axes = ng::AxisSet{0, 1};
+    channels *= ng_filter_shape[2];
+    if (channels == ng_channel_shape[0]) {
+      ng_channel_scale = make_shared<ng::op::Reshape>(
+          ng_channel_scale, ng::AxisVector{0},
+          ng::Shape{ng_filter_shape[2], ng_filter_shape[3]});
+    }
+  }
+  if (channels != ng_channel_shape[0]) {
+    return errors::InvalidArgument(
+        "Batch norm does not match the output channels of ",
+        epilogue.conv->name());
+  }
+  *ng_filter = *ng_filter * make_shared<ng::op::Broadcast>(ng_channel_scale,
+                                                          ng_filter_shape,
+                                                          ng_broadcast_axes);
+  return Status::OK();
+}
+
+static Status TranslateConvEpilogue(const ConvEpilogue& epilogue,
+                                    Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_input, ng_filter, ng_bias;
+  TF_RETURN_IF_ERROR(
+      GetInputNodes(ng_op_map, epilogue.conv, &ng_input, &ng_filter));
+
+  if (epilogue.bias_add != nullptr) {
+    TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, epilogue.bias_add, 1, &ng_bias));
+    if (ng_bias->get_shape().size() != 1) {
+      return errors::InvalidArgument(
+          "Bias argument to BiasAdd does not have one dimension");
+    }
+  } else {
+    float tf_epsilon;
+    if (GetNodeAttr(epilogue.batch_norm->attrs(), "epsilon", &tf_epsilon) !=
+        Status::OK()) {
+      // TensorFlow default
+      tf_epsilon = 0.0001;
+    }
+    if (FoldConstantBatchNorm(epilogue, tf_epsilon, &ng_filter, &ng_bias)) {
+      NGRAPH_VLOG(2) << "Folded constant batch norm "
+                     << epilogue.batch_norm->name() << " into "
+                     << epilogue.conv->name();
+    } else {
+      TF_RETURN_IF_ERROR(FoldBatchNorm(epilogue, tf_epsilon, ng_op_map,
+                                       &ng_filter, &ng_bias));
+    }
+  }
+
+  bool is_nhwc;
+  shared_ptr<ng::Node> ng_result;
+  if (epilogue.conv->type_string() == "Conv2D") {
+    TF_RETURN_IF_ERROR(MakeConv2D(epilogue.conv, ng_input, ng_filter,
+                                  &is_nhwc, &ng_result));
+  } else {
+    TF_RETURN_IF_ERROR(MakeDepthwiseConv2D(epilogue.conv, ng_input,
+                                           ng_filter, &is_nhwc, &ng_result));
+  }
+  ng_result = ng_result + make_shared<ng::op::Broadcast>(
+                              ng_bias, ng_result->get_shape(),
+                              ng::AxisSet{0, 2, 3});
+
+  if (epilogue.activation != nullptr) {
+    if (epilogue.activation->type_string() == "Relu") {
+      ng_result = make_shared<ng::op::Relu>(ng_result);
+    } else {
+      ng_result = MakeRelu6(ng_result);
+    }
+  }
+
+  BatchToTensorflow(is_nhwc, ng_result);
+  SaveNgOp(ng_op_map, epilogue.Last(), ng_result);
+  if (epilogue.Last() == epilogue.batch_norm) {
+    // As in TranslateFusedBatchNormOp.
+    SaveNgOp(ng_op_map, epilogue.batch_norm, ng_result);
+  }
+  return Status::OK();
+}
+
+//
+// Normalizations. tf.nn.moments followed by tf.nn.batch_normalization, which
+// is how TF 1.x expresses layer norm (e.g. in BERT) and instance norm, is
+//
+//   mean     = Mean(x, axes, keep_dims=True)
+//   variance = Mean(SquaredDifference(x, StopGradient(mean)), axes,
+//                   keep_dims=True)
+//   inv      = Rsqrt(variance + epsilon) * gamma
+//   y        = x * inv + (beta - mean * inv)
+//
+// Translated op by op, this reads x four times and broadcasts the moments
+// three times. It is recognized at its final Add and emitted as
+//
+//   centered = x - mean
+//   y        = centered * Rsqrt(Mean(centered^2) + epsilon) * gamma + beta
+//
+// with each moment broadcast once. The ops that computed the moments the
+// long way become dead, unless something outside the pattern uses them.
+//
+struct NormalizationMatch {
+  const Node* mean = nullptr;
+  const Node* variance = nullptr;
+  // variance + epsilon, and the index of epsilon among its inputs.
+  const Node* variance_add = nullptr;
+  int epsilon_index = 0;
+  // Rsqrt * gamma and the index of gamma among its inputs; null if there is
+  // no gamma.
+  const Node* scale_mul = nullptr;
+  int gamma_index = 0;
+  // beta - mean * inv
+  const Node* offset_sub = nullptr;
+};
+
+static bool NormalizationFusionEnabled() {
+  return std::getenv("NGRAPH_TF_DISABLE_NORMALIZATION_FUSION") == nullptr;
+}
+
+static bool IsOp(const Node* node, const char* type) {
+  return node != nullptr && node->type_string() == type;
+}
+
+// Returns true if input "index" of "a" and input "index_b" of "b" are fed by
+// the same output.
+static bool SameInput(const Node* a, int index_a, const Node* b, int index_b) {
+  const Edge* edge_a;
+  const Edge* edge_b;
+  if (!a->input_edge(index_a, &edge_a).ok() ||
+      !b->input_edge(index_b, &edge_b).ok()) {
+    return false;
+  }
+  return edge_a->src() == edge_b->src() &&
+         edge_a->src_output() == edge_b->src_output();
+}
+
+static bool KeepsDims(const Node* mean) {
+  bool keep_dims;
+  return GetNodeAttr(mean->attrs(), "keep_dims", &keep_dims) == Status::OK() &&
+         keep_dims;
+}
+
+static bool MatchNormalization(const Node* add, NormalizationMatch* match) {
+  if (add->type_string() != "Add") {
+    return false;
+  }
+
+  for (int order = 0; order < 2; order++) {
+    const Node* x_mul = GetInputOp(add, order);
+    const Node* offset_sub = GetInputOp(add, 1 - order);
+    if (!IsOp(x_mul, "Mul") || !IsOp(offset_sub, "Sub")) {
+      continue;
+    }
+    const Node* mean_mul = GetInputOp(offset_sub, 1);
+    if (!IsOp(mean_mul, "Mul")) {
+      continue;
+    }
+
+    for (int mean_index = 0; mean_index < 2; mean_index++) {
+      const Node* mean = GetInputOp(mean_mul, mean_index);
+      const Node* inv = GetInputOp(mean_mul, 1 - mean_index);
+      if (!IsOp(mean, "Mean") || !KeepsDims(mean) || inv == nullptr) {
+        continue;
+      }
+
+      // x * inv, where x also feeds the mean.
+      if (!(GetInputOp(x_mul, 1) == inv && SameInput(x_mul, 0, mean, 0)) &&
+          !(GetInputOp(x_mul, 0) == inv && SameInput(x_mul, 1, mean, 0))) {
+        continue;
+      }
+
+      // inv is Rsqrt(...) or Rsqrt(...) * gamma.
+      NormalizationMatch candidate;
+      const Node* rsqrt = inv;
+      if (IsOp(inv, "Mul")) {
+        for (int i = 0; i < 2; i++) {
+          if (IsOp(GetInputOp(inv, i), "Rsqrt")) {
+            rsqrt = GetInputOp(inv, i);
+            candidate.scale_mul = inv;
+            candidate.gamma_index = 1 - i;
+            break;
+          }
+        }
+      }
+      if (!IsOp(rsqrt, "Rsqrt")) {
+        continue;
+      }
+
+      const Node* variance_add = GetInputOp(rsqrt, 0);
+      if (!IsOp(variance_add, "Add")) {
+        continue;
+      }
+      for (int i = 0; i < 2; i++) {
+        const Node* variance = GetInputOp(variance_add, i);
+        if (!IsOp(variance, "Mean") || !KeepsDims(variance)) {
+          continue;
+        }
+        const Node* sq_diff = GetInputOp(variance, 0);
+        if (!IsOp(sq_diff, "SquaredDifference")) {
+          continue;
+        }
+        // SquaredDifference(x, mean), in either order, possibly with the
+        // mean behind a StopGradient or Identity.
+        for (int j = 0; j < 2; j++) {
+          const Node* moment = GetInputOp(sq_diff, 1 - j);
+          if (IsOp(moment, "StopGradient") || IsOp(moment, "Identity")) {
+            moment = GetInputOp(moment, 0);
+          }
+          if (moment == mean && SameInput(sq_diff, j, mean, 0)) {
+            candidate.mean = mean;
+            candidate.variance = variance;
+            candidate.variance_add = variance_add;
+            candidate.epsilon_index = 1 - i;
+            candidate.offset_sub = offset_sub;
+            *match = candidate;
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+
+// Builds the normalization described by "match". Sets "*fused" to false,
+// without building anything, if the shapes involved are not the expected
+// ones, in which case the ops are translated one by one.
+static Status TranslateNormalization(
+    const NormalizationMatch& match,
+    const std::vector<const Tensor*>& static_input_map,
+    Builder::OpMap& ng_op_map, const Node* op, bool* fused) {
+  *fused = false;
+
+  shared_ptr<ng::Node> ng_x, ng_epsilon, ng_beta, ng_gamma;
+  TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, match.mean, 0, &ng_x));
+  TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, match.variance_add,
+                                  match.epsilon_index, &ng_epsilon));
+  TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, match.offset_sub, 0, &ng_beta));
+  if (match.scale_mul != nullptr) {
+    TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, match.scale_mul,
+                                    match.gamma_index, &ng_gamma));
+  }
+
+  ng::element::Type ng_et = ng_x->get_element_type();
+  if (!ng_et.is_real() || ng::shape_size(ng_epsilon->get_shape()) != 1) {
+    return Status::OK();
+  }
+
+  std::vector<int64> mean_axes, variance_axes;
+  TF_RETURN_IF_ERROR(
+      GetStaticInputVector(match.mean, 1, static_input_map, &mean_axes));
+  TF_RETURN_IF_ERROR(GetStaticInputVector(match.variance, 1,
+                                          static_input_map, &variance_axes));
+
+  const ng::Shape& ng_x_shape = ng_x->get_shape();
+  int64 rank = ng_x_shape.size();
+  ng::AxisSet ng_axes, ng_variance_axes;
+  for (auto axis : mean_axes) {
+    ng_axes.insert(axis < 0 ? axis + rank : axis);
+  }
+  for (auto axis : variance_axes) {
+    ng_variance_axes.insert(axis < 0 ? axis + rank : axis);
+  }
+  if (ng_axes.empty() || ng_axes != ng_variance_axes) {
+    return Status::OK();
+  }
+
+  ng::Shape ng_reduced_shape;
+  size_t count = 1;
+  for (size_t i = 0; i < rank; i++) {
+    if (ng_axes.count(i) == 0) {
+      ng_reduced_shape.push_back(ng_x_shape[i]);
+    } else {
+      count *= ng_x_shape[i];
+    }
+  }
+  ng::AxisSet ng_all_axes;
+  for (size_t i = 0; i < ng_reduced_shape.size(); i++) {
+    ng_all_axes.insert(i);
+  }
+  auto reduced_constant = [&](const string& value) {
+    return make_shared<ng::op::Broadcast>(
+        make_shared<ng::op::Constant>(ng_et, ng::Shape{},
+                                      std::vector<std::string>{value}),
+        ng_reduced_shape, ng_all_axes);
+  };
+
+  // Moments, over the reduced shape.
+  auto ng_mean = make_shared<ng::op::Sum>(ng_x, ng_axes) /
+                 reduced_constant(to_string(count));
+  auto ng_centered =
+      ng_x - make_shared<ng::op::Broadcast>(ng_mean, ng_x_shape, ng_axes);
+  auto ng_variance =
+      make_shared<ng::op::Sum>(ng_centered * ng_centered, ng_axes) /
+      reduced_constant(to_string(count));
+
+  // Rsqrt(variance + epsilon)
+  shared_ptr<ng::Node> ng_scalar_epsilon = make_shared<ng::op::Reshape>(
+      ng_epsilon, ng::get_default_order(ng_epsilon->get_shape()),
+      ng::Shape{});
+  auto ng_inv = make_shared<ng::op::Power>(
+      ng_variance + make_shared<ng::op::Broadcast>(
+                        ng_scalar_epsilon, ng_reduced_shape, ng_all_axes),
+      reduced_constant("-0.5"));
+
+  shared_ptr<ng::Node> ng_result =
+      ng_centered *
+      make_shared<ng::op::Broadcast>(ng_inv, ng_x_shape, ng_axes);
+  if (ng_gamma != nullptr) {
+    std::tie(ng_result, ng_gamma) =
+        ng::builder::numpy_broadcast(std::make_pair(ng_result, ng_gamma));
+    ng_result = ng_result * ng_gamma;
+  }
+  std::tie(ng_result, ng_beta) =
+      ng::builder::numpy_broadcast(std::make_pair(ng_result, ng_beta));
+  if (ng_result->get_shape() != ng_x_shape) {
+    return Status::OK();
+  }
+  ng_result = ng_result + ng_beta;
+
+  NGRAPH_VLOG(2) << "Fusing normalization ending at " << op->name();
+  SaveNgOp(ng_op_map, op, ng_result);
+  *fused = true;
+  return Status::OK();
+}
+
+//
+// Fake quantization. Quantization-aware training leaves QuantizeAndDequantizeV2
+// ops (fake quants) on the input and the weights of each convolution and
+// matmul, and on its output (after the bias and the activation, if any).
+// Translated op by op, the convolution still runs in f32 on values that
+// happen to be quantized. When the ranges are static, such a sandwich is
+// translated as a unit instead:
+//
+//   Conv2D - the input is quantized to u8 and the filter to i8, and nGraph's
+//            int8 convolution computes the biased, rectified result and
+//            requantizes it with the output range. This takes an unsigned
+//            input fake quant, a signed filter fake quant, and an output fake
+//            quant that is unsigned exactly when there is a Relu.
+//   MatMul - the product of the quantized values is computed in i32, and
+//            rescaled before the bias and the activation are applied.
+//
+// In both cases the result is dequantized to f32 with the output's scale,
+// which is the value the output fake quant would have produced. The input
+// and weight fake quants are translated as usual, and their values are
+// quantized again; when a value is the output of a preceding sandwich, its
+// quantized form is used directly, so consecutive layers stay in int8. Each
+// op between the convolution or matmul and the output fake quant must be the
+// only consumer of the one before.
+//
+
+struct FakeQuant {
+  const Node* node = nullptr;
+  // The inverse scale, i.e. the value of one quantization step.
+  float scale = 0.0f;
+  bool is_signed = false;
+
+  ng::element::Type QuantizedType() const {
+    return is_signed ? ng::element::i8 : ng::element::u8;
+  }
+};
+
+struct QuantizedSandwich {
+  FakeQuant input;
+  FakeQuant weights;
+  const Node* op = nullptr;
+  const Node* bias_add = nullptr;
+  const Node* relu = nullptr;
+  FakeQuant output;
+};
+
+static bool QDQFoldingEnabled() {
+  return std::getenv("NGRAPH_TF_DISABLE_QDQ_FOLDING") == nullptr;
+}
+
+// Matches an 8 bit, f32 fake quant with a static range.
+static bool MatchFakeQuant(const Node* node,
+                           const std::vector<const Tensor*>& static_input_map,
+                           FakeQuant* fake_quant) {
+  if (!IsOp(node, "QuantizeAndDequantizeV2")) {
+    return false;
+  }
+  DataType dtype;
+  bool range_given, signed_input;
+  int num_bits;
+  if (GetNodeAttr(node->attrs(), "T", &dtype) != Status::OK() ||
+      GetNodeAttr(node->attrs(), "range_given", &range_given) !=
+          Status::OK() ||
+      GetNodeAttr(node->attrs(), "signed_input", &signed_input) !=
+          Status::OK() ||
+      GetNodeAttr(node->attrs(), "num_bits", &num_bits) != Status::OK() ||
+      dtype != DT_FLOAT || !range_given || num_bits != 8) {
+    return false;
+  }
+  float scale;
+  if (QuantizeAndDequantizeV2Helper<float>(node, static_input_map,
+                                           range_given, signed_input,
+                                           num_bits, &scale) != Status::OK() ||
+      !(scale > 0.0f)) {
+    return false;
+  }
+  fake_quant->node = node;
+  fake_quant->scale = scale;
+  fake_quant->is_signed = signed_input;
+  return true;
+}
+
+// Matches the sandwich whose output fake quant is "node".
+static bool MatchQuantizedSandwich(
+    const Node* node, const std::vector<const Tensor*>& static_input_map,
+    QuantizedSandwich* sandwich) {
+  if (!MatchFakeQuant(node, static_input_map, &sandwich->output)) {
+    return false;
+  }
+
+  // Walks up from the output fake quant, through the optional Relu and
+  // BiasAdd, to the convolution or matmul.
+  const Node* consumer = node;
+  const Node* producer = GetInputOp(consumer, 0);
+  auto advance = [&consumer, &producer]() {
+    consumer = producer;
+    producer = GetInputOp(consumer, 0);
+  };
+  auto feeds_only = [](const Node* from, const Node* to) {
+    return from != nullptr && GetSoleConsumer(from) == to;
+  };
+  if (IsOp(producer, "Relu") && feeds_only(producer, consumer)) {
+    sandwich->relu = producer;
+    advance();
+  }
+  if (IsOp(producer, "BiasAdd") && feeds_only(producer, consumer)) {
+    sandwich->bias_add = producer;
+    advance();
+  }
+  if ((!IsOp(producer, "Conv2D") && !IsOp(producer, "MatMul")) ||
+      !feeds_only(producer, consumer)) {
+    return false;
+  }
+  sandwich->op = producer;
+
+  DataType dtype;
+  if (GetNodeAttr(sandwich->op->attrs(), "T", &dtype) != Status::OK() ||
+      dtype != DT_FLOAT ||
+      !MatchFakeQuant(GetInputOp(sandwich->op, 0), static_input_map,
+                      &sandwich->input) ||
+      !MatchFakeQuant(GetInputOp(sandwich->op, 1), static_input_map,
+                      &sandwich->weights)) {
+    return false;
+  }
+
+  if (IsOp(sandwich->op, "Conv2D")) {
+    if (sandwich->bias_add != nullptr &&
+        DataFormat(sandwich->bias_add) != DataFormat(sandwich->op)) {
+      return false;
+    }
+    // The combinations nGraph's int8 convolution supports.
+    return !sandwich->input.is_signed && sandwich->weights.is_signed &&
+           sandwich->output.is_signed == (sandwich->relu == nullptr);
+  }
+  return true;
+}
+
+static shared_ptr<ng::Node> MakeScalarConstant(float value) {
+  return make_shared<ng::op::Constant>(ng::element::f32, ng::Shape{},
+                                       std::vector<float>({value}));
+}
+
+// Quantizes the value of "fake_quant", as the input of a sandwich. The value
+// may be the dequantized output of another sandwich, or of the fake quant's
+// own translation; either way, it is dequantized with this scale.
+static shared_ptr<ng::Node> QuantizeFakeQuantValue(
+    shared_ptr<ng::Node> ng_value, const FakeQuant& fake_quant) {
+  if (dynamic_pointer_cast<ng::op::Dequantize>(ng_value) != nullptr &&
+      ng_value->get_argument(0)->get_element_type() ==
+          fake_quant.QuantizedType()) {
+    return ng_value->get_argument(0);
+  }
+  return MakeQDQQuantize(ng_value, fake_quant.scale,
+                         fake_quant.QuantizedType());
+}
+
+// Builds the requantized int8 convolution of a sandwich, in f32.
+static Status MakeQuantizedSandwichConv(const QuantizedSandwich& sandwich,
+                                        shared_ptr<ng::Node> ng_q_input,
+                                        shared_ptr<ng::Node> ng_q_filter,
+                                        shared_ptr<ng::Node> ng_bias,
+                                        shared_ptr<ng::Node>* ng_result) {
+  const Node* op = sandwich.op;
+  std::vector<int32> tf_strides;
+  std::vector<int32> tf_dilations;
+  std::string tf_padding_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "strides", &tf_strides));
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "dilations", &tf_dilations));
+  TF_RETURN_IF_ERROR(GetNodeAttr(op->attrs(), "padding", &tf_padding_type));
+
+  bool is_nhwc = DataFormat(op) == "NHWC";
+  ng::Strides ng_strides(2);
+  ng::Strides ng_dilations(2);
+  ng::Strides ng_data_dilations({1, 1});
+  ng::Shape ng_image_shape(2);
+  ng::Shape ng_kernel_shape(2);
+  BatchedOpParamToNGraph(is_nhwc, tf_strides, ng_strides);
+  BatchedOpParamToNGraph(is_nhwc, ng_q_input->get_shape(), ng_image_shape);
+  BatchedOpParamToNGraph(is_nhwc, tf_dilations, ng_dilations);
+
+  BatchToNGraph(is_nhwc, ng_q_input);
+  auto ng_filter_shape = ng_q_filter->get_shape();
+  ng_kernel_shape[0] = ng_filter_shape[0];
+  ng_kernel_shape[1] = ng_filter_shape[1];
+  size_t channels = ng_filter_shape[3];
+  Reshape<3, 2, 0, 1>(ng_q_filter);
+
+  ng::CoordinateDiff ng_padding_below{0, 0};
+  ng::CoordinateDiff ng_padding_above{0, 0};
+  Builder::MakePadding(tf_padding_type, ng_image_shape, ng_kernel_shape,
+                       ng_strides, ng_dilations, ng_padding_below,
+                       ng_padding_above);
+
+  // The bias is added to the i32 accumulator, in the scale of the product.
+  const float product_scale = sandwich.input.scale * sandwich.weights.scale;
+  shared_ptr<ng::Node> ng_q_bias;
+  if (ng_bias != nullptr) {
+    ng_q_bias = make_shared<ng::op::Quantize>(
+        ng_bias, MakeScalarConstant(product_scale),
+        make_shared<ng::op::Constant>(ng::element::i32, ng::Shape{},
+                                      std::vector<int>({0})),
+        ng::element::i32, ng::AxisSet(),
+        ng::op::Quantize::RoundMode::ROUND_NEAREST_TOWARD_INFINITY);
+  } else {
+    ng_q_bias = make_shared<ng::op::Constant>(
+        ng::element::i32, ng::Shape{channels}, std::vector<int>(channels, 0));
+  }
+
+  // The SCALED mode ranges whose scales are those of the fake quants.
+  const float input_max = 255.0f * sandwich.input.scale;
+  const float filter_max = 127.0f * sandwich.weights.scale;
+  const float output_max = (sandwich.output.is_signed ? 127.0f : 255.0f) *
+                           sandwich.output.scale;
+  const float output_min = sandwich.output.is_signed ? -output_max : 0.0f;
+  shared_ptr<ng::Node> ng_conv = ng::builder::ScaledQuantizedConvolutionBias(
+      ng_q_input, ng_q_filter, ng_q_bias, ng_strides, ng_dilations,
+      ng_padding_below, ng_padding_above, ng_data_dilations,
+      MakeScalarConstant(0.0f), MakeScalarConstant(input_max),
+      MakeScalarConstant(-filter_max), MakeScalarConstant(filter_max),
+      MakeScalarConstant(output_min), MakeScalarConstant(output_max),
+      sandwich.relu != nullptr);
+  BatchToTensorflow(is_nhwc, ng_conv);
+
+  *ng_result =
+      MakeQDQDequantize(ng_conv, sandwich.output.scale, ng::element::f32);
+  return Status::OK();
+}
+
+// Builds the integer matmul of a sandwich, followed by its bias, activation
+// and output fake quant.
+static Status MakeQuantizedSandwichMatMul(const QuantizedSandwich& sandwich,
+                                          shared_ptr<ng::Node> ng_q_lhs,
+                                          shared_ptr<ng::Node> ng_q_rhs,
+                                          shared_ptr<ng::Node> ng_bias,
+                                          shared_ptr<ng::Node>* ng_result) {
+  const Node* op = sandwich.op;
+  bool transpose_a = false;
+  bool transpose_b = false;
+  if (GetNodeAttr(op->attrs(), "transpose_a", &transpose_a) == Status::OK() &&
+      transpose_a) {
+    ng_q_lhs = ng::builder::numpy_transpose(ng_q_lhs, ng::AxisVector{1, 0});
+  }
+  if (GetNodeAttr(op->attrs(), "transpose_b", &transpose_b) == Status::OK() &&
+      transpose_b) {
+    ng_q_rhs = ng::builder::numpy_transpose(ng_q_rhs, ng::AxisVector{1, 0});
+  }
+
+  shared_ptr<ng::Node> ng_product = make_shared<ng::op::Dot>(
+      make_shared<ng::op::Convert>(ng_q_lhs, ng::element::i32),
+      make_shared<ng::op::Convert>(ng_q_rhs, ng::element::i32));
+
+  auto& ng_shape = ng_product->get_shape();
+  shared_ptr<ng::Node> ng_value =
+      make_shared<ng::op::Convert>(ng_product, ng::element::f32) *
+      BroadcastRange(
+          MakeScalarConstant(sandwich.input.scale * sandwich.weights.scale),
+          ng_shape);
+  if (ng_bias != nullptr) {
+    ng_value = ng_value + BroadcastRange(ng_bias, ng_shape);
+  }
+  if (sandwich.relu != nullptr) {
+    ng_value = make_shared<ng::op::Relu>(ng_value);
+  }
+
+  *ng_result = MakeQDQDequantize(
+      MakeQDQQuantize(ng_value, sandwich.output.scale,
+                      sandwich.output.QuantizedType()),
+      sandwich.output.scale, ng::element::f32);
+  return Status::OK();
+}
+
+static Status TranslateQuantizedSandwich(const QuantizedSandwich& sandwich,
+                                         Builder::OpMap& ng_op_map) {
+  shared_ptr<ng::Node> ng_input, ng_weights, ng_bias;
+  TF_RETURN_IF_ERROR(
+      GetInputNodes(ng_op_map, sandwich.op, &ng_input, &ng_weights));
+  if (sandwich.bias_add != nullptr) {
+    TF_RETURN_IF_ERROR(GetInputNode(ng_op_map, sandwich.bias_add, 1, &ng_bias));
+  }
+  ng_input = QuantizeFakeQuantValue(ng_input, sandwich.input);
+  ng_weights = QuantizeFakeQuantValue(ng_weights, sandwich.weights);
+
+  shared_ptr<ng::Node> ng_result;
+  if (sandwich.op->type_string() == "Conv2D") {
+    TF_RETURN_IF_ERROR(MakeQuantizedSandwichConv(
+        sandwich, ng_input, ng_weights, ng_bias, &ng_result));
+  } else {
+    TF_RETURN_IF_ERROR(MakeQuantizedSandwichMatMul(
+        sandwich, ng_input, ng_weights, ng_bias, &ng_result));
+  }
+  SaveNgOp(ng_op_map, sandwich.output.node, ng_result);
   return Status::OK();
 }
 
@@ -4013,8 +5648,23 @@ const static std::map<
         {"PreventGradient", TranslateIdentityOp},
         {"Prod", TranslateProdOp},
         {"QuantizeAndDequantizeV2", TranslateQuantizeAndDequantizeV2Op},
+        {"QuantizedAvgPool", TranslateQuantizedAvgPoolOp},
+        {"QuantizedConcat", TranslateQuantizedConcatOp},
+        {"QuantizedConv2D", TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DAndRelu", TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DAndReluAndRequantize", TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DAndRequantize", TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DWithBias", TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DWithBiasAndRelu", TranslateQuantizedConv2DOp},
         {"QuantizedConv2DWithBiasAndReluAndRequantize",
-         TranslateQuantizedConv2DWithBiasAndReluAndRequantizeOp},
+         TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DWithBiasAndRequantize", TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DWithBiasSignedSumAndReluAndRequantize",
+         TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DWithBiasSumAndRelu", TranslateQuantizedConv2DOp},
+        {"QuantizedConv2DWithBiasSumAndReluAndRequantize",
+         TranslateQuantizedConv2DOp},
+        {"QuantizedMatMul", TranslateQuantizedMatMulOp},
         {"QuantizedMaxPool", TranslateQuantizedMaxPoolOp},
         {"QuantizeV2", TranslateQuantizeV2Op},
         {"RealDiv", TranslateBinaryOp<ngraph::op::Divide>},
@@ -4022,8 +5672,11 @@ const static std::map<
         {"Relu", TranslateReluOp},
         {"Relu6", TranslateRelu6Op},
         {"ReluGrad", TranslateReluGradOp},
+        {"RequantizationRange", TranslateRequantizationRangeOp},
+        {"Requantize", TranslateRequantizeOp},
         {"Reshape", TranslateReshapeOp},
         {"Rsqrt", TranslateRsqrtOp},
+        {"Select", TranslateSelectOp},
         {"Shape", TranslateShapeOp},
         {"Sigmoid", TranslateSigmoidOp},
         {"SigmoidGrad", TranslateSigmoidGradOp},
@@ -4041,6 +5694,8 @@ const static std::map<
         {"Square", TranslateSquareOp},
         {"SquaredDifference", TranslateSquaredDifferenceOp},
         {"Squeeze", TranslateSqueezeOp},
+        // StopGradient is just Identity in data-flow terms, so reuse that.
+        {"StopGradient", TranslateIdentityOp},
         {"StridedSlice", TranslateStridedSliceOp},
         {"Sub", TranslateBinaryOp<ngraph::op::Subtract>},
         {"Sum", TranslateSumOp},
@@ -4091,10 +5746,10 @@ Status Builder::TranslateGraph(
   }
 
   //
-  // The op map holds a mapping from TensorFlow op names (strings) to
-  // vector of generated nGraph nodes.
+  // The op map holds, for each TensorFlow node, the vector of generated
+  // nGraph nodes.
   //
-  Builder::OpMap ng_op_map;
+  Builder::OpMap ng_op_map(*input_graph);
 
   //
   // Populate the parameter list, and also put parameters into the op map.
@@ -4118,14 +5773,57 @@ Status Builder::TranslateGraph(
     TF_RETURN_IF_ERROR(TFTensorShapeToNGraphShape(inputs[index], &ng_shape));
 
     auto ng_param = make_shared<ng::op::Parameter>(ng_et, ng_shape);
-    SaveNgOp(ng_op_map, parm->name(), ng_param);
+    SaveNgOp(ng_op_map, parm, ng_param);
     ng_parameter_list[index] = ng_param;
   }
 
+  //
+  // Find the fake quantized sandwiches, keyed by their output fake quant, and
+  // the convolution epilogues, keyed by their last op. A convolution in a
+  // sandwich is not also part of an epilogue.
+  //
+  std::map<const Node*, QuantizedSandwich> sandwiches;
+  std::set<const Node*> fused_ops;
+  if (QDQFoldingEnabled()) {
+    for (auto op : tf_ops) {
+      QuantizedSandwich sandwich;
+      if (!MatchQuantizedSandwich(op, static_input_map, &sandwich)) {
+        continue;
+      }
+      for (auto fused_op : {sandwich.op, sandwich.bias_add, sandwich.relu}) {
+        if (fused_op != nullptr) {
+          fused_ops.insert(fused_op);
+        }
+      }
+      sandwiches[op] = sandwich;
+    }
+  }
+
+  std::map<const Node*, ConvEpilogue> epilogues;
+  if (EpilogueFusionEnabled()) {
+    for (auto op : tf_ops) {
+      ConvEpilogue epilogue;
+      if (fused_ops.count(op) != 0 || !MatchConvEpilogue(op, &epilogue)) {
+        continue;
+      }
+      for (auto fused_op : {epilogue.conv, epilogue.bias_add,
+                            epilogue.batch_norm, epilogue.activation}) {
+        if (fused_op != nullptr && fused_op != epilogue.Last()) {
+          fused_ops.insert(fused_op);
+        }
+      }
+      epilogues[epilogue.Last()] = epilogue;
+    }
+  }
+
   //
   // Now create the nGraph ops from TensorFlow ops.
   //
   for (auto op : tf_ops) {
+    if (fused_ops.count(op) != 0) {
+      continue;
+    }
+
     NGRAPH_VLOG(2) << "Constructing op " << op->name() << " which is "
                    << op->type_string();
 
@@ -4146,7 +5844,30 @@ Status Builder::TranslateGraph(
     }
 
     try {
-      TF_RETURN_IF_ERROR((*op_fun)(op, static_input_map, ng_op_map));
+      auto sandwich = sandwiches.find(op);
+      auto epilogue = epilogues.find(op);
+      NormalizationMatch normalization;
+      bool fused = false;
+      if (sandwich != sandwiches.end()) {
+        NGRAPH_VLOG(2) << "Folding the fake quants around "
+                       << sandwich->second.op->name() << " into "
+                       << op->name();
+        TF_RETURN_IF_ERROR(TranslateQuantizedSandwich(sandwich->second,
+                                                      ng_op_map));
+        fused = true;
+      } else if (epilogue != epilogues.end()) {
+        NGRAPH_VLOG(2) << "Fusing " << op->name() << " into the epilogue of "
+                       << epilogue->second.conv->name();
+        TF_RETURN_IF_ERROR(TranslateConvEpilogue(epilogue->second, ng_op_map));
+        fused = true;
+      } else if (NormalizationFusionEnabled() &&
+                 MatchNormalization(op, &normalization)) {
+        TF_RETURN_IF_ERROR(TranslateNormalization(
+            normalization, static_input_map, ng_op_map, op, &fused));
+      }
+      if (!fused) {
+        TF_RETURN_IF_ERROR((*op_fun)(op, static_input_map, ng_op_map));
+      }
     } catch (const std::exception& e) {
       return errors::Internal("Unhandled exception in op handler: ", op->name(),
                               " (", op->type_string(), ")\n",
@@ -4183,6 +5904,18 @@ Status Builder::TranslateGraph(
   //
   ng_function = make_shared<ng::Function>(ng_result_list, ng_parameter_list);
 
+  //
+  // Remove layout transposes that cancel out.
+  //
+  TF_RETURN_IF_ERROR(SinkTransposes(ng_function));
+
+  //
+  // Run convolutions and dot products in bf16, if requested.
+  //
+  if (config::IsMixedPrecisionEnabled()) {
+    TF_RETURN_IF_ERROR(ApplyMixedPrecision(ng_function));
+  }
+
   //
   // Request row-major layout on results.
   //
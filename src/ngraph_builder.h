@@ -37,8 +37,35 @@ class Builder {
       const std::vector<const Tensor*>& static_input_map, const Graph* tf_graph,
       std::shared_ptr<ngraph::Function>& ng_function);
 
-  using OpMap = std::unordered_map<std::string,
-                                   std::vector<std::shared_ptr<ngraph::Node>>>;
+  //
+  // Holds the nGraph nodes generated for each output of each TF node. Nodes
+  // are indexed by id, and the data inputs of every node are tabulated up
+  // front, so that translators can fetch their inputs without hashing node
+  // names or collecting edges.
+  //
+  class OpMap {
+   public:
+    explicit OpMap(const Graph& graph);
+
+    // Appends the nGraph node for the next output of "node".
+    void Save(const Node* node, const std::shared_ptr<ngraph::Node>& output);
+
+    // Gets the nGraph node feeding input "input_index" of "node".
+    Status GetInput(const Node* node, size_t input_index,
+                    std::shared_ptr<ngraph::Node>* result) const;
+
+   private:
+    struct Input {
+      int src_id;
+      int src_output;
+    };
+
+    std::vector<std::vector<std::shared_ptr<ngraph::Node>>> m_outputs;
+    // The inputs of node n are m_inputs[m_input_offsets[n]] up to (but not
+    // including) m_inputs[m_input_offsets[n + 1]].
+    std::vector<int> m_input_offsets;
+    std::vector<Input> m_inputs;
+  };
 
   template <typename T>
   static void MakePadding(const std::string& tf_padding_type,
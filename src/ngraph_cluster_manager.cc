@@ -14,6 +14,7 @@
  * limitations under the License.
  *******************************************************************************/
 #include "ngraph_cluster_manager.h"
+#include "ngraph_const_store.h"
 
 using namespace std;
 
@@ -37,6 +38,12 @@ GraphDef* NGraphClusterManager::GetClusterGraph(int idx) {
   return s_cluster_graphs[idx];
 }
 
+void NGraphClusterManager::ReleaseClusterGraph(int idx) {
+  std::lock_guard<std::mutex> guard(s_cluster_graphs_mutex);
+  NGraphConstStore::Release(*s_cluster_graphs[idx]);
+  s_cluster_graphs[idx]->Clear();
+}
+
 }  // namespace ngraph_bridge
 
 }  // namespace tensorflow
@@ -29,6 +29,9 @@ class NGraphClusterManager {
  public:
   static int NewCluster();
   static tensorflow::GraphDef* GetClusterGraph(int idx);
+  // Empties the graph of cluster "idx", dropping the references it holds on
+  // externalized Consts. Only for clusters no kernel or rewrite refers to.
+  static void ReleaseClusterGraph(int idx);
 
  private:
   static std::vector<tensorflow::GraphDef*> s_cluster_graphs;
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+#include "ngraph_cluster_profile.h"
+#include "ngraph_log.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+// Static initializers
+std::map<string, ClusterProfileEntry> NGraphClusterProfile::s_entries;
+std::mutex NGraphClusterProfile::s_entries_mutex;
+
+string NGraphClusterProfile::ComputeKey(std::vector<string> node_names) {
+  std::sort(node_names.begin(), node_names.end());
+
+  std::stringstream ss;
+  for (auto& name : node_names) {
+    ss << name << ";";
+  }
+  return strings::FpToString(Fingerprint64(ss.str()));
+}
+
+void NGraphClusterProfile::RecordStep(const string& key, double ngraph_us,
+                                      double tf_us, double transfer_us) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  ClusterProfileEntry& entry = s_entries[key];
+  entry.steps++;
+  entry.ngraph_us += ngraph_us;
+  entry.tf_us += tf_us;
+  entry.transfer_us += transfer_us;
+}
+
+// The profile file holds one cluster per line:
+//
+//   <key> <steps> <ngraph_us> <tf_us> <transfer_us>
+//
+// Lines starting with '#' are ignored.
+Status NGraphClusterProfile::Load(const string& path) {
+  std::ifstream f(path);
+  if (!f.is_open()) {
+    return errors::NotFound("Cannot open cluster profile ", path);
+  }
+
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  string line;
+  while (std::getline(f, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream iss(line);
+    string key;
+    ClusterProfileEntry entry;
+    if (!(iss >> key >> entry.steps >> entry.ngraph_us >> entry.tf_us >>
+          entry.transfer_us)) {
+      return errors::InvalidArgument("Malformed line in cluster profile ",
+                                     path, ": ", line);
+    }
+    s_entries[key] = entry;
+  }
+
+  return Status::OK();
+}
+
+Status NGraphClusterProfile::Save(const string& path) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  std::ofstream f(path);
+  if (!f.is_open()) {
+    return errors::Unavailable("Cannot write cluster profile ", path);
+  }
+
+  f << "# key steps ngraph_us tf_us transfer_us" << std::endl;
+  for (auto& kv : s_entries) {
+    const ClusterProfileEntry& entry = kv.second;
+    f << kv.first << " " << entry.steps << " " << entry.ngraph_us << " "
+      << entry.tf_us << " " << entry.transfer_us << std::endl;
+  }
+
+  return Status::OK();
+}
+
+bool NGraphClusterProfile::Lookup(const string& key,
+                                  ClusterProfileEntry* entry) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  auto it = s_entries.find(key);
+  if (it == s_entries.end()) {
+    return false;
+  }
+  *entry = it->second;
+  return true;
+}
+
+void NGraphClusterProfile::Clear() {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+  s_entries.clear();
+}
+
+bool NGraphClusterProfile::IsSlowerThanTF(const string& key) {
+  ClusterProfileEntry entry;
+  if (!Lookup(key, &entry) || entry.steps == 0) {
+    return false;
+  }
+  return entry.ngraph_us + entry.transfer_us > entry.tf_us;
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#ifndef NGRAPH_TF_CLUSTER_PROFILE_H_
+#define NGRAPH_TF_CLUSTER_PROFILE_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Runtime measurements of clusters, used for profile-guided declustering.
+//
+// While recording (config::IsRecordingClusterProfile()), every
+// NGraphEncapsulate op times a number of its steps twice: once on nGraph, and
+// once by running the same cluster graph with native TF kernels. Both times
+// cover the execution of the cluster alone; the transfer of inputs and
+// outputs that nGraph needs on top of that is timed separately. The totals
+// are written to the profile file (config::GetClusterProfilePath()).
+//
+// When a profile is given but we are not recording, DeassignClusters loads it
+// and busts every cluster that was measured to be slower on nGraph than on TF.
+//
+// Clusters are identified across sessions by a fingerprint of the sorted
+// names of the nodes they contain, since cluster indices are not stable.
+//
+struct ClusterProfileEntry {
+  ClusterProfileEntry() : steps(0), ngraph_us(0), tf_us(0), transfer_us(0) {}
+
+  int64 steps;
+  // Totals over all recorded steps.
+  double ngraph_us;
+  double tf_us;
+  double transfer_us;
+};
+
+class NGraphClusterProfile {
+ public:
+  static string ComputeKey(std::vector<string> node_names);
+
+  static void RecordStep(const string& key, double ngraph_us, double tf_us,
+                         double transfer_us);
+
+  // Loads the entries in "path", replacing any we already hold for the same
+  // keys.
+  static Status Load(const string& path);
+  static Status Save(const string& path);
+
+  static bool Lookup(const string& key, ClusterProfileEntry* entry);
+
+  // Forgets all entries.
+  static void Clear();
+
+  // Returns true if the profile holds a measurement for "key" in which nGraph,
+  // counting the transfers, was slower than TF.
+  static bool IsSlowerThanTF(const string& key);
+
+ private:
+  static std::map<string, ClusterProfileEntry> s_entries;
+  static std::mutex s_entries_mutex;
+};
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
+
+#endif  // NGRAPH_TF_CLUSTER_PROFILE_H_
@@ -0,0 +1,189 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+#include <vector>
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+#include "ngraph_const_store.h"
+#include "ngraph_log.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+static const char* const CONST_STORE_KEY_ATTR = "_ngraph_const_store_key";
+static const int64 DEFAULT_CONST_STORE_MIN_BYTES = 1 << 20;
+
+std::map<string, NGraphConstStore::Entry> NGraphConstStore::s_values;
+std::mutex NGraphConstStore::s_values_mutex;
+
+static int64 ConstStoreMinBytes() {
+  const char* min_bytes = std::getenv("NGRAPH_TF_CONST_STORE_MIN_BYTES");
+  return min_bytes == nullptr ? DEFAULT_CONST_STORE_MIN_BYTES
+                              : strtoll(min_bytes, nullptr, 10);
+}
+
+// The builder copies externalized values into nGraph Constants verbatim, so
+// only types whose TF and nGraph representations agree are stored.
+static bool CanExternalize(DataType dtype) {
+  switch (dtype) {
+    case DT_FLOAT:
+    case DT_DOUBLE:
+    case DT_INT8:
+    case DT_INT16:
+    case DT_INT32:
+    case DT_INT64:
+    case DT_UINT8:
+    case DT_UINT16:
+      return true;
+    default:
+      return false;
+  }
+}
+
+Status NGraphConstStore::Externalize(NodeDef* node_def) {
+  if (node_def->op() != "Const" || IsExternalized(*node_def)) {
+    return Status::OK();
+  }
+  int64 min_bytes = ConstStoreMinBytes();
+  auto it = node_def->attr().find("value");
+  if (min_bytes <= 0 || it == node_def->attr().end()) {
+    return Status::OK();
+  }
+
+  const TensorProto& proto = it->second.tensor();
+  if (!CanExternalize(proto.dtype()) ||
+      TensorShape(proto.tensor_shape()).num_elements() *
+              DataTypeSize(proto.dtype()) <
+          min_bytes) {
+    return Status::OK();
+  }
+
+  Tensor value;
+  if (!value.FromProto(proto)) {
+    return errors::Internal("Cannot parse value of Const ", node_def->name());
+  }
+  StringPiece data = value.tensor_data();
+  string key = strings::StrCat(DataTypeString(value.dtype()), "/",
+                               value.shape().DebugString(), "/",
+                               strings::FpToString(Fingerprint64(data)));
+
+  {
+    std::lock_guard<std::mutex> lock(s_values_mutex);
+    // Identical values share the tensor stored first.
+    Entry& entry = s_values[key];
+    if (!entry.value.IsInitialized()) {
+      entry.value = value;
+    }
+    entry.refs++;
+  }
+  NGRAPH_VLOG(3) << "Externalized " << data.size() << " bytes of Const "
+                 << node_def->name();
+
+  TensorProto stripped;
+  stripped.set_dtype(proto.dtype());
+  *stripped.mutable_tensor_shape() = proto.tensor_shape();
+  *(*node_def->mutable_attr())["value"].mutable_tensor() = stripped;
+  SetAttrValue(key, &(*node_def->mutable_attr())[CONST_STORE_KEY_ATTR]);
+  return Status::OK();
+}
+
+bool NGraphConstStore::IsExternalized(const NodeDef& node_def) {
+  return node_def.attr().count(CONST_STORE_KEY_ATTR) != 0;
+}
+
+bool NGraphConstStore::Lookup(const NodeDef& node_def, Tensor* value) {
+  auto attr = node_def.attr().find(CONST_STORE_KEY_ATTR);
+  if (attr == node_def.attr().end()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(s_values_mutex);
+  auto it = s_values.find(attr->second.s());
+  if (it == s_values.end()) {
+    return false;
+  }
+  // Tensor copies share the underlying buffer.
+  *value = it->second.value;
+  return true;
+}
+
+Status NGraphConstStore::Internalize(GraphDef* graph_def) {
+  for (auto& node_def : *graph_def->mutable_node()) {
+    if (!IsExternalized(node_def)) {
+      continue;
+    }
+    Tensor value;
+    if (!Lookup(node_def, &value)) {
+      return errors::Internal("Value of Const ", node_def.name(),
+                              " is missing from the constant store");
+    }
+    value.AsProtoTensorContent(
+        (*node_def.mutable_attr())["value"].mutable_tensor());
+    node_def.mutable_attr()->erase(CONST_STORE_KEY_ATTR);
+  }
+  return Status::OK();
+}
+
+Status NGraphConstStore::Acquire(const GraphDef& graph_def) {
+  std::lock_guard<std::mutex> lock(s_values_mutex);
+  std::vector<Entry*> entries;
+  for (auto& node_def : graph_def.node()) {
+    auto attr = node_def.attr().find(CONST_STORE_KEY_ATTR);
+    if (attr == node_def.attr().end()) {
+      continue;
+    }
+    auto it = s_values.find(attr->second.s());
+    if (it == s_values.end()) {
+      return errors::Internal("Value of Const ", node_def.name(),
+                              " is missing from the constant store");
+    }
+    entries.push_back(&it->second);
+  }
+  for (auto entry : entries) {
+    entry->refs++;
+  }
+  return Status::OK();
+}
+
+void NGraphConstStore::Release(const GraphDef& graph_def) {
+  std::lock_guard<std::mutex> lock(s_values_mutex);
+  for (auto& node_def : graph_def.node()) {
+    auto attr = node_def.attr().find(CONST_STORE_KEY_ATTR);
+    if (attr == node_def.attr().end()) {
+      continue;
+    }
+    auto it = s_values.find(attr->second.s());
+    if (it != s_values.end() && --it->second.refs <= 0) {
+      NGRAPH_VLOG(3) << "Releasing " << it->second.value.TotalBytes()
+                     << " bytes of externalized Const " << node_def.name();
+      s_values.erase(it);
+    }
+  }
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#ifndef NGRAPH_TF_CONST_STORE_H_
+#define NGRAPH_TF_CONST_STORE_H_
+
+#include <map>
+#include <mutex>
+
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Process-wide store for the values of large Const nodes in cluster graphs.
+//
+// Without it, a weight tensor is held as a TensorProto in the cluster
+// GraphDef kept by NGraphClusterManager, again in the NodeDef of every
+// kernel's copy of the cluster graph, and is unpacked into a temporary
+// std::vector before being copied into an nGraph Constant.
+//
+// When a Const is copied into a cluster GraphDef, Externalize moves its
+// value into a Tensor held here, keyed by a fingerprint of its contents (so
+// identical weights are only stored once). The NodeDef keeps its dtype and
+// shape, so shape inference still works, and records the key in the
+// "_ngraph_const_store_key" attribute. The builder then creates the nGraph
+// Constant straight from the Tensor's buffer.
+//
+// Consts smaller than NGRAPH_TF_CONST_STORE_MIN_BYTES (default 1MiB) are
+// left alone; setting it to 0 disables the store.
+//
+// Values are reference counted. Externalize takes a reference on behalf of
+// the graph that holds "node_def", which NGraphClusterManager drops when it
+// releases that cluster graph. Every NGraphEncapsulateOp kernel, and every
+// memoized rewrite, also acquires the values its cluster graph refers to and
+// releases them when it goes away; a value is freed once its last reference
+// is released.
+//
+class NGraphConstStore {
+ public:
+  // Moves the value of "node_def" into the store if it is a large enough
+  // Const, taking a reference owned by the graph that holds "node_def".
+  static Status Externalize(NodeDef* node_def);
+
+  static bool IsExternalized(const NodeDef& node_def);
+
+  // Gets the value of an externalized Const. Returns false if "node_def" is
+  // not one.
+  static bool Lookup(const NodeDef& node_def, Tensor* value);
+
+  // Puts the values of all externalized Consts in "graph_def" back, for
+  // consumers that run the graph through TensorFlow.
+  static Status Internalize(GraphDef* graph_def);
+
+  // Takes a reference on the value of every externalized Const in
+  // "graph_def". Returns an error, and takes no references, if any of them is
+  // missing from the store.
+  static Status Acquire(const GraphDef& graph_def);
+
+  // Drops the references taken by Acquire, or by Externalize for the nodes
+  // of "graph_def", freeing the values that are no longer referenced.
+  static void Release(const GraphDef& graph_def);
+
+ private:
+  struct Entry {
+    Tensor value;
+    int refs = 0;
+  };
+
+  static std::map<string, Entry> s_values;
+  static std::mutex s_values_mutex;
+};
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
+
+#endif  // NGRAPH_TF_CONST_STORE_H_
@@ -0,0 +1,468 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <set>
+
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+
+#include "ngraph_convert_conditionals.h"
+#include "ngraph_cost_model.h"
+#include "ngraph_log.h"
+#include "ngraph_mark_for_clustering.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// The if-conversion pass replaces small tf.cond constructs by straight-line
+// code: both branches are computed unconditionally, and each Merge becomes a
+// Select on the predicate. Without the Switch and Merge nodes the branches
+// no longer carry a deadness predicate of their own, so they can be
+// clustered together with the code around the conditional.
+//
+// A conditional (all Switch nodes sharing one predicate) is converted only if
+//
+//   - every node downstream of its Switches, up to its Merges, is marked for
+//     clustering, stateless, and assigned to a single backend;
+//   - no such node is consumed outside the conditional other than through a
+//     Merge, and each Merge has exactly one input from each side;
+//   - every such node is of an op type that cannot fail at run time once its
+//     shapes check out (so no asserts, gathers, slices or integer division),
+//     and all of its output shapes are statically known;
+//   - the two inputs of each Merge have the same, statically known, shape,
+//     since Select needs both of its values to agree;
+//   - the estimated cost of the speculated branches, in flops, does not
+//     exceed NGRAPH_TF_MAX_SPECULATED_FLOPS (default 65536). Setting it to 0
+//     disables the pass.
+//
+// Conditionals nested in other conditionals are converted inside-out. Each
+// Merge is replaced by a Select of the same name, so that anything referring
+// to the conditional's outputs by name still finds them.
+//
+// This pass must run after MarkForClustering.
+//
+
+static const int64 DEFAULT_MAX_SPECULATED_FLOPS = 65536;
+
+// Ops that are safe to run on the branch that was not taken: none of them has
+// side effects, and with statically known shapes none of them can fail. Ops
+// that can still fail on integer operands (division by zero, negative
+// exponents) are only safe on floating point types.
+static const std::set<string> SPECULATABLE_OPS{
+    "Abs", "Add", "AddN", "All", "Any", "AvgPool", "BiasAdd", "Cast", "Ceil",
+    "ConcatV2", "Const", "Conv2D", "Cos", "Equal", "Exp", "ExpandDims", "Floor",
+    "Greater", "GreaterEqual", "Identity", "Less", "LessEqual", "Log",
+    "LogicalAnd", "LogicalNot", "LogicalOr", "MatMul", "Max", "MaxPool",
+    "Maximum", "Mean", "Min", "Minimum", "Mul", "Neg", "NotEqual", "OnesLike",
+    "Pack", "Prod", "Relu", "Relu6", "Rsqrt", "Select", "Sigmoid", "Sign",
+    "Sin", "Snapshot", "Softmax", "Sqrt", "Square", "SquaredDifference",
+    "Squeeze", "StopGradient", "Sub", "Sum", "Tanh", "Transpose", "ZerosLike"};
+static const std::set<string> FLOAT_SPECULATABLE_OPS{"Div", "Pow",
+                                                     "RealDiv", "Reciprocal"};
+
+namespace {
+
+using Endpoint = std::pair<Node*, int>;
+
+struct Conditional {
+  Endpoint predicate;
+  std::vector<Node*> switches;
+  // Nodes that only run on one side of the conditional, mapped to that side
+  // (the output of the Switch they descend from: 0 is false, 1 is true).
+  std::map<Node*, int> branch_nodes;
+  // The false-side and true-side inputs of each Merge.
+  std::map<Node*, std::vector<Endpoint>> merges;
+  string backend;
+};
+
+int64 MaxSpeculatedFlops() {
+  const char* max_flops = std::getenv("NGRAPH_TF_MAX_SPECULATED_FLOPS");
+  return max_flops == nullptr ? DEFAULT_MAX_SPECULATED_FLOPS
+                              : strtoll(max_flops, nullptr, 10);
+}
+
+const Edge* GetDataInput(const Node* node, int index) {
+  for (auto edge : node->in_edges()) {
+    if (!edge->IsControlEdge() && edge->dst_input() == index) {
+      return edge;
+    }
+  }
+  return nullptr;
+}
+
+// Walks forward from the Switches of "cond" to its Merges, assigning a side
+// to every node in between. Returns false if the conditional cannot be
+// converted.
+bool AnalyzeConditional(Conditional* cond) {
+  std::deque<Node*> queue;
+
+  // Records that "edge" carries a value that only exists on "side".
+  auto visit = [&](const Edge* edge, int side) -> bool {
+    Node* dst = edge->dst();
+    if (dst->IsSink()) {
+      return true;
+    }
+    if (dst->IsMerge()) {
+      if (edge->IsControlEdge()) {
+        return false;
+      }
+      auto& inputs = cond->merges[dst];
+      inputs.resize(2, Endpoint(nullptr, 0));
+      if (inputs[side].first != nullptr) {
+        return false;
+      }
+      inputs[side] = Endpoint(edge->src(), edge->src_output());
+      return true;
+    }
+    auto it = cond->branch_nodes.find(dst);
+    if (it != cond->branch_nodes.end()) {
+      return it->second == side;
+    }
+    cond->branch_nodes[dst] = side;
+    queue.push_back(dst);
+    return true;
+  };
+
+  for (auto switch_node : cond->switches) {
+    for (auto edge : switch_node->out_edges()) {
+      if (edge->IsControlEdge()) {
+        if (!edge->dst()->IsSink()) {
+          return false;
+        }
+        continue;
+      }
+      if (!visit(edge, edge->src_output())) {
+        return false;
+      }
+    }
+  }
+
+  while (!queue.empty()) {
+    Node* node = queue.front();
+    queue.pop_front();
+
+    if (node->IsControlFlow() || !NodeIsMarkedForClustering(node) ||
+        node->op_def().is_stateful()) {
+      NGRAPH_VLOG(3) << "Not converting conditional on "
+                     << cond->predicate.first->name() << ": cannot speculate "
+                     << node->name();
+      return false;
+    }
+
+    string backend;
+    if (!GetNodeBackend(node, &backend).ok()) {
+      return false;
+    }
+    if (cond->backend.empty()) {
+      cond->backend = backend;
+    } else if (cond->backend != backend) {
+      return false;
+    }
+
+    int side = cond->branch_nodes[node];
+    for (auto edge : node->out_edges()) {
+      if (!visit(edge, side)) {
+        return false;
+      }
+    }
+  }
+
+  // Without any speculated nodes there is no backend to run the Select on,
+  // and nothing to be gained from clustering.
+  if (cond->merges.empty() || cond->branch_nodes.empty()) {
+    return false;
+  }
+
+  for (auto& kv : cond->merges) {
+    Node* merge = kv.first;
+    if (kv.second[0].first == nullptr || kv.second[1].first == nullptr ||
+        merge->num_inputs() != 2) {
+      return false;
+    }
+    // The value_index output tells which branch ran; it has no equivalent
+    // once both have.
+    for (auto edge : merge->out_edges()) {
+      if (!edge->IsControlEdge() && edge->src_output() != 0) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool CanSpeculate(const Node* node) {
+  if (SPECULATABLE_OPS.count(node->type_string()) != 0) {
+    return true;
+  }
+  DataType dtype;
+  return FLOAT_SPECULATABLE_OPS.count(node->type_string()) != 0 &&
+         GetNodeAttr(node->attrs(), "T", &dtype).ok() &&
+         DataTypeIsFloating(dtype);
+}
+
+// Checks the conditions on what "cond" computes: that every speculated node
+// can run unconditionally, and that each Merge can become a Select.
+bool BranchesAreSafe(const NGraphCostModel& cost_model,
+                     const Conditional& cond) {
+  for (auto& kv : cond.branch_nodes) {
+    Node* node = kv.first;
+    if (!CanSpeculate(node)) {
+      NGRAPH_VLOG(3) << "Not converting conditional on "
+                     << cond.predicate.first->name() << ": " << node->name()
+                     << " may fail when speculated";
+      return false;
+    }
+    for (int i = 0; i < node->num_outputs(); i++) {
+      if (!cost_model.GetOutputShape(node, i).IsFullyDefined()) {
+        NGRAPH_VLOG(3) << "Not converting conditional on "
+                       << cond.predicate.first->name() << ": shape of "
+                       << node->name() << " is not static";
+        return false;
+      }
+    }
+  }
+
+  for (auto& kv : cond.merges) {
+    PartialTensorShape else_shape =
+        cost_model.GetOutputShape(kv.second[0].first, kv.second[0].second);
+    PartialTensorShape then_shape =
+        cost_model.GetOutputShape(kv.second[1].first, kv.second[1].second);
+    if (!else_shape.IsFullyDefined() || !then_shape.IsFullyDefined() ||
+        !else_shape.IsIdenticalTo(then_shape)) {
+      NGRAPH_VLOG(3) << "Not converting conditional on "
+                     << cond.predicate.first->name() << ": branches of "
+                     << kv.first->name() << " have different shapes";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int64 EstimateSpeculatedFlops(const NGraphCostModel& cost_model,
+                              const Conditional& cond) {
+  int64 flops = 0;
+  for (auto& kv : cond.branch_nodes) {
+    flops += cost_model.GetNodeCost(kv.first).flops;
+  }
+  return flops;
+}
+
+// Every node that converting "cond" reads or removes.
+std::set<Node*> TouchedNodes(const Conditional& cond) {
+  std::set<Node*> touched{cond.predicate.first};
+  for (auto switch_node : cond.switches) {
+    touched.insert(switch_node);
+    touched.insert(GetDataInput(switch_node, 0)->src());
+  }
+  for (auto& kv : cond.branch_nodes) {
+    touched.insert(kv.first);
+  }
+  for (auto& kv : cond.merges) {
+    touched.insert(kv.first);
+    for (auto& endpoint : kv.second) {
+      touched.insert(endpoint.first);
+    }
+  }
+  return touched;
+}
+
+Status ConvertConditional(Graph* graph, const Conditional& cond) {
+  NGRAPH_VLOG(2) << "Converting conditional on " << cond.predicate.first->name()
+                 << " (" << cond.merges.size() << " outputs)";
+
+  std::map<Node*, Endpoint> switch_inputs;
+  for (auto switch_node : cond.switches) {
+    const Edge* edge = GetDataInput(switch_node, 0);
+    switch_inputs[switch_node] = Endpoint(edge->src(), edge->src_output());
+  }
+
+  // Feed both branches from the Switch inputs directly, so that they always
+  // run.
+  for (auto switch_node : cond.switches) {
+    std::vector<const Edge*> out_edges(switch_node->out_edges().begin(),
+                                       switch_node->out_edges().end());
+    for (auto edge : out_edges) {
+      if (edge->IsControlEdge() || edge->dst()->IsMerge()) {
+        continue;
+      }
+      const Endpoint& input = switch_inputs[switch_node];
+      TF_RETURN_IF_ERROR(graph->UpdateEdge(input.first, input.second,
+                                           edge->dst(), edge->dst_input()));
+    }
+  }
+
+  auto resolve = [&](const Endpoint& endpoint) {
+    auto it = switch_inputs.find(endpoint.first);
+    return it == switch_inputs.end() ? endpoint : it->second;
+  };
+
+  struct Replacement {
+    string name;
+    string device;
+    Endpoint else_value;
+    Endpoint then_value;
+    std::vector<Node*> control_inputs;
+    std::vector<std::pair<Node*, int>> consumers;
+  };
+
+  std::vector<Replacement> replacements;
+  for (auto& kv : cond.merges) {
+    Node* merge = kv.first;
+    Replacement replacement;
+    replacement.name = merge->name();
+    replacement.device = merge->assigned_device_name();
+    replacement.else_value = resolve(kv.second[0]);
+    replacement.then_value = resolve(kv.second[1]);
+    for (auto edge : merge->in_edges()) {
+      if (edge->IsControlEdge() && edge->src()->IsOp()) {
+        replacement.control_inputs.push_back(edge->src());
+      }
+    }
+    for (auto edge : merge->out_edges()) {
+      replacement.consumers.push_back(
+          std::make_pair(edge->dst(), edge->dst_input()));
+    }
+    replacements.push_back(replacement);
+  }
+
+  for (auto& kv : cond.merges) {
+    graph->RemoveNode(kv.first);
+  }
+  for (auto switch_node : cond.switches) {
+    graph->RemoveNode(switch_node);
+  }
+
+  string backend = cond.backend;
+  for (auto& replacement : replacements) {
+    Node* select;
+    TF_RETURN_IF_ERROR(
+        NodeBuilder(replacement.name, "Select")
+            .Input(cond.predicate.first, cond.predicate.second)
+            .Input(replacement.then_value.first,
+                   replacement.then_value.second)
+            .Input(replacement.else_value.first,
+                   replacement.else_value.second)
+            .ControlInputs(replacement.control_inputs)
+            .Finalize(graph, &select));
+    select->set_assigned_device_name(replacement.device);
+    // TODO(amprocte): move attr name to a constant
+    select->AddAttr("_ngraph_marked_for_clustering", true);
+    SetNodeBackend(select, backend);
+
+    for (auto& consumer : replacement.consumers) {
+      if (consumer.second == Graph::kControlSlot) {
+        graph->AddControlEdge(select, consumer.first);
+      } else {
+        graph->AddEdge(select, 0, consumer.first, consumer.second);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+Status ConvertConditionalsToSelect(Graph* graph) {
+  int64 max_speculated_flops = MaxSpeculatedFlops();
+  if (max_speculated_flops <= 0) {
+    return Status::OK();
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    // Switches of while-loops are predicated on a LoopCond; leave those to
+    // the loop unrolling pass.
+    std::map<Endpoint, Conditional> conditionals;
+    for (auto node : graph->op_nodes()) {
+      if (!node->IsSwitch()) {
+        continue;
+      }
+      const Edge* pred_edge = GetDataInput(node, 1);
+      if (pred_edge == nullptr || GetDataInput(node, 0) == nullptr ||
+          pred_edge->src()->IsLoopCond()) {
+        continue;
+      }
+      Endpoint predicate(pred_edge->src(), pred_edge->src_output());
+      conditionals[predicate].predicate = predicate;
+      conditionals[predicate].switches.push_back(node);
+    }
+
+    if (conditionals.empty()) {
+      break;
+    }
+
+    std::unique_ptr<NGraphCostModel> cost_model;
+    TF_RETURN_IF_ERROR(NGraphCostModel::Build(*graph, &cost_model));
+
+    // Analyze everything before changing anything; conditionals converted in
+    // the same round must not share nodes, since converting one removes
+    // nodes the other may refer to.
+    std::vector<const Conditional*> to_convert;
+    std::set<Node*> touched;
+    for (auto& kv : conditionals) {
+      Conditional& cond = kv.second;
+      if (!AnalyzeConditional(&cond) || !BranchesAreSafe(*cost_model, cond)) {
+        continue;
+      }
+
+      int64 flops = EstimateSpeculatedFlops(*cost_model, cond);
+      if (flops > max_speculated_flops) {
+        NGRAPH_VLOG(3) << "Not converting conditional on "
+                       << cond.predicate.first->name() << ": " << flops
+                       << " flops is too expensive to speculate";
+        continue;
+      }
+
+      std::set<Node*> cond_touched = TouchedNodes(cond);
+      bool overlaps = false;
+      for (auto node : cond_touched) {
+        if (touched.count(node) != 0) {
+          overlaps = true;
+          break;
+        }
+      }
+      if (overlaps) {
+        continue;
+      }
+      touched.insert(cond_touched.begin(), cond_touched.end());
+      to_convert.push_back(&cond);
+    }
+
+    for (auto cond : to_convert) {
+      TF_RETURN_IF_ERROR(ConvertConditional(graph, *cond));
+      changed = true;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
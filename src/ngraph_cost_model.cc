@@ -0,0 +1,381 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <mutex>
+
+#include "tensorflow/core/common_runtime/shape_refiner.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+
+#include "ngraph_api.h"
+#include "ngraph_cost_model.h"
+#include "ngraph_log.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace {
+
+int64 TensorBytes(DataType dtype, const TensorShape& shape) {
+  return DataTypeSize(dtype) * shape.num_elements();
+}
+
+int64 IOBytes(const Node* node, const std::vector<TensorShape>& input_shapes,
+              const std::vector<TensorShape>& output_shapes) {
+  int64 bytes = 0;
+  for (size_t i = 0; i < input_shapes.size(); i++) {
+    bytes += TensorBytes(node->input_type(i), input_shapes[i]);
+  }
+  for (size_t i = 0; i < output_shapes.size(); i++) {
+    bytes += TensorBytes(node->output_type(i), output_shapes[i]);
+  }
+  return bytes;
+}
+
+int64 MaxOutputElements(const std::vector<TensorShape>& output_shapes) {
+  int64 elements = 0;
+  for (auto& shape : output_shapes) {
+    elements = std::max(elements, shape.num_elements());
+  }
+  return elements;
+}
+
+// Returns dimension "dim" of "shape", counting from the back if negative, or
+// 1 if the shape does not have that dimension.
+int64 DimOrOne(const TensorShape& shape, int dim) {
+  if (dim < 0) dim += shape.dims();
+  if (dim < 0 || dim >= shape.dims()) return 1;
+  return shape.dim_size(dim);
+}
+
+OpCost ElementwiseCost(const Node* node, const std::vector<TensorShape>& in,
+                       const std::vector<TensorShape>& out) {
+  return OpCost(MaxOutputElements(out), IOBytes(node, in, out));
+}
+
+// Ops that only reinterpret or forward their input.
+OpCost FreeCost(const Node*, const std::vector<TensorShape>&,
+                const std::vector<TensorShape>&) {
+  return OpCost(0, 0);
+}
+
+// Ops that do a handful of transcendental operations per output element.
+OpCost TranscendentalCost(const Node* node, const std::vector<TensorShape>& in,
+                          const std::vector<TensorShape>& out) {
+  return OpCost(4 * MaxOutputElements(out), IOBytes(node, in, out));
+}
+
+// Ops that read every input element once and produce a smaller output.
+OpCost ReductionCost(const Node* node, const std::vector<TensorShape>& in,
+                     const std::vector<TensorShape>& out) {
+  int64 elements = in.empty() ? 0 : in[0].num_elements();
+  return OpCost(elements, IOBytes(node, in, out));
+}
+
+OpCost MatMulCost(const Node* node, const std::vector<TensorShape>& in,
+                  const std::vector<TensorShape>& out) {
+  bool transpose_a = false;
+  GetNodeAttr(node->attrs(), "transpose_a", &transpose_a);
+  int64 k = in.empty() ? 1 : DimOrOne(in[0], transpose_a ? 0 : 1);
+  return OpCost(2 * MaxOutputElements(out) * k, IOBytes(node, in, out));
+}
+
+OpCost BatchMatMulCost(const Node* node, const std::vector<TensorShape>& in,
+                       const std::vector<TensorShape>& out) {
+  bool adj_x = false;
+  GetNodeAttr(node->attrs(), "adj_x", &adj_x);
+  int64 k = in.empty() ? 1 : DimOrOne(in[0], adj_x ? -2 : -1);
+  return OpCost(2 * MaxOutputElements(out) * k, IOBytes(node, in, out));
+}
+
+// Filter is input 1 in [H, W, Cin, Cout] layout.
+OpCost Conv2DCost(const Node* node, const std::vector<TensorShape>& in,
+                  const std::vector<TensorShape>& out) {
+  if (in.size() < 2) return ElementwiseCost(node, in, out);
+  int64 window = DimOrOne(in[1], 0) * DimOrOne(in[1], 1) * DimOrOne(in[1], 2);
+  return OpCost(2 * MaxOutputElements(out) * window, IOBytes(node, in, out));
+}
+
+// Filter is input 1 in [H, W, Cin, multiplier] layout; every output element
+// only sees one input channel.
+OpCost DepthwiseConv2DCost(const Node* node, const std::vector<TensorShape>& in,
+                           const std::vector<TensorShape>& out) {
+  if (in.size() < 2) return ElementwiseCost(node, in, out);
+  int64 window = DimOrOne(in[1], 0) * DimOrOne(in[1], 1);
+  return OpCost(2 * MaxOutputElements(out) * window, IOBytes(node, in, out));
+}
+
+// Conv2DBackpropInput and Conv2DBackpropFilter: input 1 is the filter (or its
+// sizes) and input 2 is the backpropagated gradient. Each gradient element is
+// spread over a full H x W x Cin window.
+OpCost Conv2DBackpropCost(const Node* node, const std::vector<TensorShape>& in,
+                          const std::vector<TensorShape>& out) {
+  if (in.size() < 3) return ElementwiseCost(node, in, out);
+  const TensorShape& filter =
+      node->type_string() == "Conv2DBackpropFilter" ? out[0] : in[1];
+  int64 window = DimOrOne(filter, 0) * DimOrOne(filter, 1) *
+                 DimOrOne(filter, 2);
+  return OpCost(2 * in[2].num_elements() * window, IOBytes(node, in, out));
+}
+
+OpCost PoolCost(const Node* node, const std::vector<TensorShape>& in,
+                const std::vector<TensorShape>& out) {
+  std::vector<int32> ksize;
+  int64 window = 1;
+  if (GetNodeAttr(node->attrs(), "ksize", &ksize).ok()) {
+    for (auto k : ksize) window *= k;
+  }
+  return OpCost(MaxOutputElements(out) * window, IOBytes(node, in, out));
+}
+
+std::mutex& OpCostFunctionsMutex() {
+  static std::mutex mu;
+  return mu;
+}
+
+std::map<string, OpCostFunction>& OpCostFunctions() {
+  static std::map<string, OpCostFunction> cost_functions{
+      {"AvgPool", PoolCost},
+      {"AvgPoolGrad", PoolCost},
+      {"BatchMatMul", BatchMatMulCost},
+      {"BiasAddGrad", ReductionCost},
+      {"Const", FreeCost},
+      {"Conv2D", Conv2DCost},
+      {"Conv2DBackpropFilter", Conv2DBackpropCost},
+      {"Conv2DBackpropInput", Conv2DBackpropCost},
+      {"DepthwiseConv2dNative", DepthwiseConv2DCost},
+      {"Exp", TranscendentalCost},
+      {"ExpandDims", FreeCost},
+      {"Identity", FreeCost},
+      {"L2Loss", ReductionCost},
+      {"Log", TranscendentalCost},
+      {"LogSoftmax", TranscendentalCost},
+      {"MatMul", MatMulCost},
+      {"Max", ReductionCost},
+      {"MaxPool", PoolCost},
+      {"MaxPoolGrad", PoolCost},
+      {"Mean", ReductionCost},
+      {"Min", ReductionCost},
+      {"NoOp", FreeCost},
+      {"PreventGradient", FreeCost},
+      {"Prod", ReductionCost},
+      {"Rank", FreeCost},
+      {"Reshape", FreeCost},
+      {"Rsqrt", TranscendentalCost},
+      {"Shape", FreeCost},
+      {"Sigmoid", TranscendentalCost},
+      {"Size", FreeCost},
+      {"Snapshot", FreeCost},
+      {"Softmax", TranscendentalCost},
+      {"SparseSoftmaxCrossEntropyWithLogits", TranscendentalCost},
+      {"Sqrt", TranscendentalCost},
+      {"Squeeze", FreeCost},
+      {"StopGradient", FreeCost},
+      {"Sum", ReductionCost},
+      {"Tanh", TranscendentalCost},
+  };
+  return cost_functions;
+}
+
+}  // namespace
+
+OpCostFunction NGraphCostModel::RegisterOpCostFunction(const string& op_type,
+                                                       OpCostFunction fn) {
+  std::lock_guard<std::mutex> lock(OpCostFunctionsMutex());
+  auto& cost_functions = OpCostFunctions();
+  OpCostFunction previous;
+  auto it = cost_functions.find(op_type);
+  if (it != cost_functions.end()) {
+    previous = it->second;
+    cost_functions.erase(it);
+  }
+  if (fn) {
+    cost_functions[op_type] = fn;
+  }
+  return previous;
+}
+
+bool NGraphCostModel::ClusterIsProfitable(const ClusterCost& cost) {
+  return cost.flops >=
+         config::GetMinClusterFlopsPerByte() * cost.boundary_bytes;
+}
+
+Status NGraphCostModel::Build(const Graph& graph,
+                              std::unique_ptr<NGraphCostModel>* result) {
+  std::unique_ptr<NGraphCostModel> model(new NGraphCostModel());
+  model->m_unknown_dim = config::GetCostModelUnknownDimSize();
+
+  //
+  // Run shape inference in topological order. Failures are not fatal: the
+  // outputs of a node we cannot infer simply have unknown rank, and the
+  // estimate falls back on the unknown dimension size.
+  //
+  ShapeRefiner refiner(graph.versions(), graph.op_registry());
+  refiner.set_require_shape_inference_fns(false);
+
+  std::vector<Node*> ordered;
+  GetReversePostOrder(graph, &ordered);
+
+  for (auto node : ordered) {
+    if (!node->IsOp()) {
+      continue;
+    }
+
+    std::vector<PartialTensorShape>& shapes = model->m_output_shapes[node];
+    shapes.resize(node->num_outputs());
+
+    Status status = refiner.AddNode(node);
+    if (!status.ok()) {
+      NGRAPH_VLOG(5) << "Cost model: shape inference failed for "
+                     << node->name() << ": " << status.error_message();
+      continue;
+    }
+
+    shape_inference::InferenceContext* ctx = refiner.GetContext(node);
+    for (int i = 0; i < node->num_outputs(); i++) {
+      shape_inference::ShapeHandle handle = ctx->output(i);
+      if (!ctx->RankKnown(handle)) {
+        continue;
+      }
+      std::vector<int64> dims(ctx->Rank(handle));
+      for (int d = 0; d < dims.size(); d++) {
+        dims[d] = ctx->Value(ctx->Dim(handle, d));
+      }
+      shapes[i] = PartialTensorShape(dims);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(OpCostFunctionsMutex());
+  auto& cost_functions = OpCostFunctions();
+
+  for (auto node : graph.op_nodes()) {
+    std::vector<TensorShape> input_shapes(node->num_inputs());
+    for (auto edge : node->in_edges()) {
+      if (edge->IsControlEdge()) {
+        continue;
+      }
+      input_shapes[edge->dst_input()] = model->ResolveShape(
+          model->GetOutputShape(edge->src(), edge->src_output()));
+    }
+
+    std::vector<TensorShape> output_shapes(node->num_outputs());
+    for (int i = 0; i < node->num_outputs(); i++) {
+      output_shapes[i] = model->ResolveShape(model->GetOutputShape(node, i));
+    }
+
+    auto it = cost_functions.find(node->type_string());
+    OpCost cost = (it != cost_functions.end())
+                      ? it->second(node, input_shapes, output_shapes)
+                      : ElementwiseCost(node, input_shapes, output_shapes);
+    model->m_node_costs[node] = cost;
+
+    NGRAPH_VLOG(5) << "Cost model: " << node->name() << " ["
+                   << node->type_string() << "] flops " << cost.flops
+                   << " bytes " << cost.bytes;
+  }
+
+  *result = std::move(model);
+  return Status::OK();
+}
+
+TensorShape NGraphCostModel::ResolveShape(
+    const PartialTensorShape& shape) const {
+  if (shape.unknown_rank()) {
+    return TensorShape({m_unknown_dim});
+  }
+
+  TensorShape resolved;
+  for (int d = 0; d < shape.dims(); d++) {
+    int64 dim = shape.dim_size(d);
+    resolved.AddDim(dim < 0 ? m_unknown_dim : dim);
+  }
+  return resolved;
+}
+
+OpCost NGraphCostModel::GetNodeCost(const Node* node) const {
+  auto it = m_node_costs.find(node);
+  return it == m_node_costs.end() ? OpCost() : it->second;
+}
+
+PartialTensorShape NGraphCostModel::GetOutputShape(const Node* node,
+                                                   int output_index) const {
+  auto it = m_output_shapes.find(node);
+  if (it == m_output_shapes.end() || output_index < 0 ||
+      output_index >= it->second.size()) {
+    return PartialTensorShape();
+  }
+  return it->second[output_index];
+}
+
+int64 NGraphCostModel::GetOutputBytes(const Node* node,
+                                      int output_index) const {
+  if (output_index < 0 || output_index >= node->num_outputs()) {
+    return 0;
+  }
+  return TensorBytes(node->output_type(output_index),
+                     ResolveShape(GetOutputShape(node, output_index)));
+}
+
+int64 NGraphCostModel::GetEdgeBytes(const Edge* edge) const {
+  if (edge->IsControlEdge()) {
+    return 0;
+  }
+  return GetOutputBytes(edge->src(), edge->src_output());
+}
+
+ClusterCost NGraphCostModel::ComputeClusterCost(
+    const std::set<Node*>& nodes) const {
+  ClusterCost cost;
+
+  // A tensor consumed several times inside the cluster (or produced once and
+  // consumed several times outside it) is only marshalled once.
+  std::set<std::pair<const Node*, int>> boundary_tensors;
+
+  for (auto node : nodes) {
+    cost.flops += GetNodeCost(node).flops;
+
+    for (auto edge : node->in_edges()) {
+      if (edge->IsControlEdge() || !edge->src()->IsOp() ||
+          nodes.count(edge->src()) != 0) {
+        continue;
+      }
+      boundary_tensors.insert(std::make_pair(edge->src(), edge->src_output()));
+    }
+
+    for (auto edge : node->out_edges()) {
+      if (edge->IsControlEdge() || !edge->dst()->IsOp() ||
+          nodes.count(edge->dst()) != 0) {
+        continue;
+      }
+      boundary_tensors.insert(std::make_pair(node, edge->src_output()));
+    }
+  }
+
+  for (auto& tensor : boundary_tensors) {
+    cost.boundary_bytes += GetOutputBytes(tensor.first, tensor.second);
+  }
+
+  return cost;
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#ifndef NGRAPH_TF_COST_MODEL_H_
+#define NGRAPH_TF_COST_MODEL_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// A coarse static cost model used to decide whether a cluster is worth
+// handing to nGraph. Every op node gets an estimate of the arithmetic it
+// performs (flops) and of the bytes it reads and writes, derived from the
+// shapes TensorFlow's shape inference can tell us about. Unknown dimensions
+// are replaced by a configurable default (config::SetCostModelUnknownDimSize).
+//
+// A cluster is considered profitable when its compute is large relative to
+// the bytes that have to be marshalled across its boundary, i.e. when
+//
+//     flops >= min_flops_per_byte * boundary_bytes
+//
+// where min_flops_per_byte is tunable through the config API.
+//
+// Per-op estimates are pluggable: RegisterOpCostFunction installs (or
+// replaces) the estimator for a given op type, and returns the one it
+// replaced, if any. Registering an empty function removes the estimator. Ops
+// without a registered estimator are treated as elementwise.
+//
+struct OpCost {
+  OpCost() : flops(0), bytes(0) {}
+  OpCost(int64 f, int64 b) : flops(f), bytes(b) {}
+
+  int64 flops;
+  int64 bytes;
+};
+
+struct ClusterCost {
+  ClusterCost() : flops(0), boundary_bytes(0) {}
+
+  int64 flops;
+  int64 boundary_bytes;
+};
+
+// Input and output shapes are fully defined by the time a cost function is
+// called; unknown dimensions have already been replaced.
+using OpCostFunction =
+    std::function<OpCost(const Node* node, const std::vector<TensorShape>&,
+                         const std::vector<TensorShape>&)>;
+
+class NGraphCostModel {
+ public:
+  // Runs shape inference over "graph" and estimates the cost of each op.
+  static Status Build(const Graph& graph,
+                      std::unique_ptr<NGraphCostModel>* result);
+
+  static OpCostFunction RegisterOpCostFunction(const string& op_type,
+                                               OpCostFunction fn);
+
+  // Returns true if the cost of "cluster" justifies running it on nGraph.
+  static bool ClusterIsProfitable(const ClusterCost& cost);
+
+  OpCost GetNodeCost(const Node* node) const;
+
+  // Returns the size in bytes of the tensor carried by a data edge, or zero
+  // for control edges.
+  int64 GetEdgeBytes(const Edge* edge) const;
+
+  int64 GetOutputBytes(const Node* node, int output_index) const;
+
+  // Returns the shape inferred for output "output_index" of "node", which may
+  // be only partially known.
+  PartialTensorShape GetOutputShape(const Node* node, int output_index) const;
+
+  // Sums the flops of "nodes" and the bytes of every distinct tensor that
+  // flows into or out of the set.
+  ClusterCost ComputeClusterCost(const std::set<Node*>& nodes) const;
+
+ private:
+  NGraphCostModel() {}
+
+  TensorShape ResolveShape(const PartialTensorShape& shape) const;
+
+  std::map<const Node*, std::vector<PartialTensorShape>> m_output_shapes;
+  std::map<const Node*, OpCost> m_node_costs;
+  int64 m_unknown_dim;
+};
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
+
+#endif  // NGRAPH_TF_COST_MODEL_H_
@@ -28,6 +28,8 @@
 
 #include "ngraph_api.h"
 #include "ngraph_assign_clusters.h"
+#include "ngraph_cluster_profile.h"
+#include "ngraph_cost_model.h"
 #include "ngraph_deassign_clusters.h"
 #include "ngraph_log.h"
 #include "ngraph_mark_for_clustering.h"
@@ -47,15 +49,22 @@ namespace ngraph_bridge {
 // two non-trivial ops in the graph, where a "trivial op" means "Const" or
 // "Identity".
 //
+// If the cost model is enabled (see ngraph_cost_model.h), we also deassign
+// clusters whose estimated compute does not pay for marshalling the tensors
+// crossing their boundary.
+//
+// If a cluster profile is given and we are not recording one (see
+// ngraph_cluster_profile.h), we also deassign clusters that were measured to
+// run slower on nGraph than on native TF.
+//
 // For unit testing purposes, this pass can be bypassed by setting
 // NGRAPH_TF_DISABLE_DEASSIGN_CLUSTERS=1.
 //
 
 static const int MIN_NONTRIVIAL_NODES = 2;
 
-static void MaybeLogPlacement(const Graph* graph) {
-  if (!config::IsLoggingPlacement()) return;
-
+string PlacementLog(const Graph* graph) {
+  std::stringstream log;
   std::map<int, std::set<const Node*>> final_cluster_map;
   int number_of_nodes = 0, nodes_marked_for_clustering = 0,
       nodes_assigned_a_cluster = 0;
@@ -86,24 +95,23 @@ static void MaybeLogPlacement(const Graph* graph) {
                   nodes_marked_for_clustering)
           : 0;
 
-  std::cout << "Number of nodes in the graph: " << number_of_nodes << std::endl;
-  std::cout << "Number of nodes marked for clustering: "
-            << nodes_marked_for_clustering << " ("
-            << perc_marked_for_clustering_of_total << "% of total nodes)"
-            << std::endl;
-  std::cout << "Number of nodes assigned a cluster: "
-            << nodes_assigned_a_cluster << " ("
-            << perc_assigned_clusters_of_total << "% of total nodes) \t"
-            << " (" << perc_assigned_clusters_of_marked
-            << "% of nodes marked for clustering) \t" << std::endl;
-  std::cout << "Number of ngraph clusters :" << final_cluster_map.size() - 1
-            << std::endl;
+  log << "Number of nodes in the graph: " << number_of_nodes << std::endl;
+  log << "Number of nodes marked for clustering: "
+      << nodes_marked_for_clustering << " ("
+      << perc_marked_for_clustering_of_total << "% of total nodes)"
+      << std::endl;
+  log << "Number of nodes assigned a cluster: " << nodes_assigned_a_cluster
+      << " (" << perc_assigned_clusters_of_total << "% of total nodes) \t"
+      << " (" << perc_assigned_clusters_of_marked
+      << "% of nodes marked for clustering) \t" << std::endl;
+  log << "Number of ngraph clusters :" << final_cluster_map.size() - 1
+      << std::endl;
 
   for (auto kv : final_cluster_map) {
     int cluster_idx = kv.first;
     if (cluster_idx != -1) {
-      std::cout << "Size of nGraph Cluster[" << cluster_idx << "]\t"
-                << kv.second.size() << std::endl;
+      log << "Size of nGraph Cluster[" << cluster_idx << "]\t"
+          << kv.second.size() << std::endl;
     }
   }
 
@@ -119,9 +127,15 @@ static void MaybeLogPlacement(const Graph* graph) {
         placement_dev << "nGraph[" << cluster_idx << "]\t";
       }
       placement_dev << node->name() << " (" << node->type_string() << ")";
-      std::cout << placement_dev.str() << std::endl;
+      log << placement_dev.str() << std::endl;
     }
   }
+  return log.str();
+}
+
+static void MaybeLogPlacement(const Graph* graph) {
+  if (!config::IsLoggingPlacement()) return;
+  std::cout << PlacementLog(graph);
 }
 
 Status DeassignClusters(Graph* graph) {
@@ -146,6 +160,22 @@ Status DeassignClusters(Graph* graph) {
     cluster_map[cluster_idx].insert(node);
   }
 
+  std::unique_ptr<NGraphCostModel> cost_model;
+  if (config::IsCostModelEnabled()) {
+    TF_RETURN_IF_ERROR(NGraphCostModel::Build(*graph, &cost_model));
+  }
+
+  bool use_profile = false;
+  string profile_path = config::GetClusterProfilePath();
+  if (!profile_path.empty() && !config::IsRecordingClusterProfile()) {
+    Status status = NGraphClusterProfile::Load(profile_path);
+    if (status.ok()) {
+      use_profile = true;
+    } else {
+      NGRAPH_VLOG(1) << "Not using cluster profile: " << status.error_message();
+    }
+  }
+
   for (auto& kv : cluster_map) {
     int cluster_idx = kv.first;
     std::set<Node*>& nodes = kv.second;
@@ -159,7 +189,30 @@ Status DeassignClusters(Graph* graph) {
       }
     }
 
-    if (non_trivial_count < MIN_NONTRIVIAL_NODES) {
+    bool bust = non_trivial_count < MIN_NONTRIVIAL_NODES;
+
+    if (!bust && cost_model != nullptr) {
+      ClusterCost cost = cost_model->ComputeClusterCost(nodes);
+      NGRAPH_VLOG(2) << "Cluster " << cluster_idx << ": estimated flops "
+                     << cost.flops << ", boundary bytes "
+                     << cost.boundary_bytes;
+      bust = !NGraphCostModel::ClusterIsProfitable(cost);
+    }
+
+    if (!bust && use_profile) {
+      std::vector<string> node_names;
+      for (auto node : nodes) {
+        node_names.push_back(node->name());
+      }
+      if (NGraphClusterProfile::IsSlowerThanTF(
+              NGraphClusterProfile::ComputeKey(node_names))) {
+        NGRAPH_VLOG(2) << "Cluster " << cluster_idx
+                       << " was measured slower than TF";
+        bust = true;
+      }
+    }
+
+    if (bust) {
       NGRAPH_VLOG(2) << "Busting cluster " << cluster_idx;
       for (auto node : nodes) {
         NGRAPH_VLOG(2) << "Busting node: " << node->name() << " ["
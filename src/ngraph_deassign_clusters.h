@@ -24,6 +24,10 @@ namespace ngraph_bridge {
 
 Status DeassignClusters(Graph* graph);
 
+// The cluster assignment of each node of "graph", as printed when logging
+// placement (see config::StartLoggingPlacement()).
+string PlacementLog(const Graph* graph);
+
 }  // namespace ngraph_bridge
 
 }  // namespace tensorflow
@@ -36,6 +36,7 @@
 
 #include "ngraph_assign_clusters.h"
 #include "ngraph_cluster_manager.h"
+#include "ngraph_const_store.h"
 #include "ngraph_encapsulate_clusters.h"
 #include "ngraph_log.h"
 #include "ngraph_mark_for_clustering.h"
@@ -411,6 +412,7 @@ Status EncapsulateClusters(Graph* graph) {
     auto node_def =
         NGraphClusterManager::GetClusterGraph(cluster_idx)->add_node();
     *node_def = original_def;
+    TF_RETURN_IF_ERROR(NGraphConstStore::Externalize(node_def));
 
     for (auto& input : *(node_def->mutable_input())) {
       TensorId tensor_id = ParseTensorName(input);
@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  *******************************************************************************/
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <mutex>
@@ -29,12 +31,19 @@
 
 #include "ngraph/serializer.hpp"
 
+#include "ngraph_api.h"
 #include "ngraph_backend_manager.h"
 #include "ngraph_builder.h"
 #include "ngraph_cluster_manager.h"
+#include "ngraph_cluster_profile.h"
+#include "ngraph_const_store.h"
 #include "ngraph_freshness_tracker.h"
+#include "ngraph_function_registry.h"
 #include "ngraph_log.h"
 #include "ngraph_mark_for_clustering.h"
+#include "ngraph_mixed_precision.h"
+#include "ngraph_simplify_graph.h"
+#include "ngraph_tf_executor.h"
 #include "ngraph_utils.h"
 
 #include "ngraph/runtime/interpreter/int_backend.hpp"
@@ -60,6 +69,15 @@ REGISTER_OP("NGraphEncapsulate")
     .SetIsStateful()
     .Doc("nGraph Encapsulation Op. For use by the nGraph JIT only.");
 
+// Number of steps (not counting those that compile a new function) for which
+// each cluster is timed against TF when recording a cluster profile.
+static const int NUM_PROFILED_STEPS = 20;
+
+// Number of calls over which each kernel counts the ones that compile a
+// function for a new input signature. A kernel that compiles on more than
+// config::GetMaxNewSignatureRate() of them runs with TensorFlow from then on.
+static const int SIGNATURE_WINDOW_STEPS = 20;
+
 class NGraphEncapsulateOp : public OpKernel {
  public:
   explicit NGraphEncapsulateOp(OpKernelConstruction* ctx)
@@ -70,6 +88,8 @@ class NGraphEncapsulateOp : public OpKernel {
 
     OP_REQUIRES_OK(ctx, ctx->GetAttr<int>("ngraph_cluster", &m_ngraph_cluster));
     graph_def = NGraphClusterManager::GetClusterGraph(m_ngraph_cluster);
+    OP_REQUIRES_OK(ctx, NGraphConstStore::Acquire(*graph_def));
+    m_const_store_graph = graph_def;
 
     GraphConstructorOptions opts;
     opts.allow_internal_ops = true;
@@ -86,8 +106,14 @@ class NGraphEncapsulateOp : public OpKernel {
     // Create the vector.
     int32 max_arg_index = -1;
     std::vector<const Node*> arg_nodes;
+    std::vector<string> cluster_node_names;
 
     for (auto node : m_graph.nodes()) {
+      if (node->IsOp() && node->type_string() != "_Arg" &&
+          node->type_string() != "_Retval") {
+        cluster_node_names.push_back(node->name());
+      }
+
       if (node->type_string() == "_Arg") {
         arg_nodes.push_back(node);
 
@@ -124,6 +150,12 @@ class NGraphEncapsulateOp : public OpKernel {
       m_input_is_static[index] = is_static;
     }
 
+    m_profile_key = NGraphClusterProfile::ComputeKey(cluster_node_names);
+    m_graph_hash = NGraphFunctionRegistry::CanonicalGraphHash(m_graph);
+
+    m_recompile_fallback_enabled = config::IsRecompileFallbackEnabled();
+    m_max_new_signature_rate = config::GetMaxNewSignatureRate();
+
     // Set the backend type for the op
     OP_REQUIRES_OK(ctx,
                    ctx->GetAttr<string>("_ngraph_backend", &m_op_backend_name));
@@ -131,18 +163,177 @@ class NGraphEncapsulateOp : public OpKernel {
   }
 
   ~NGraphEncapsulateOp() override {
-    // If the kernel goes away, we must de-register all of its cached
-    // functions
-    // from the freshness tracker.
+    ReleaseFunctions();
+    if (m_const_store_graph != nullptr) {
+      NGraphConstStore::Release(*m_const_store_graph);
+    }
+
+    // TODO(amprocte): We should be able to unref the tracker here, but it
+    // seems to screw things up in the C++ unit tests.
+    // if (m_freshness_tracker != nullptr) m_freshness_tracker->Unref();
+
+    // Don't lose a partial profile if we ran fewer than NUM_PROFILED_STEPS.
+    if (m_profiled_steps > 0 && m_profiled_steps < NUM_PROFILED_STEPS) {
+      Status status =
+          NGraphClusterProfile::Save(config::GetClusterProfilePath());
+      if (!status.ok()) {
+        NGRAPH_VLOG(0) << status.error_message();
+      }
+    }
+  }
+
+  // Drops all of the kernel's cached functions.
+  void ReleaseFunctions() {
+    // De-register the functions from the freshness tracker.
     if (m_freshness_tracker != nullptr) {
       for (auto kv : m_ng_functions) {
-        m_freshness_tracker->RemoveUser(kv.second);
+        m_freshness_tracker->RemoveUser(
+            NGraphFreshnessTracker::User(this, kv.second));
+      }
+    }
+
+    // Give up our references to the shared functions, and remove from the
+    // backend those that nobody else is using.
+    for (auto kv : m_ng_functions) {
+      auto unused_function =
+          NGraphFunctionRegistry::Release(FunctionRegistryKey(kv.first));
+      if (unused_function != nullptr) {
+        BackendManager::LockBackend(m_op_backend_name);
+        BackendManager::GetBackend(m_op_backend_name)
+            ->remove_compiled_function(unused_function);
+        BackendManager::UnlockBackend(m_op_backend_name);
+      }
+    }
+
+    m_ng_functions.clear();
+    m_ng_function_input_cache_map.clear();
+    m_ng_function_output_cache_map.clear();
+  }
+
+  // Key under which functions for "signature" are shared with other kernels.
+  string FunctionRegistryKey(const string& signature) const {
+    return NGraphFunctionRegistry::MakeKey(m_graph_hash, m_op_backend_name,
+                                           signature);
+  }
+
+  // Runs the current step again with native TF kernels, and records the time
+  // taken by both. "ngraph_us" is the time of the backend call alone, which
+  // is compared with the time of the TF executor's Run alone; "transfer_us"
+  // is the rest of the nGraph step, mostly moving inputs and outputs.
+  Status RecordProfileStep(OpKernelContext* ctx, double ngraph_us,
+                           double transfer_us) {
+    std::vector<Tensor> inputs;
+    for (int i = 0; i < ctx->num_inputs(); i++) {
+      inputs.push_back(ctx->input(i));
+    }
+    std::vector<Tensor> outputs;
+
+    if (m_tf_executor == nullptr) {
+      TF_RETURN_IF_ERROR(NGraphTFExecutor::Create(
+          *NGraphClusterManager::GetClusterGraph(m_ngraph_cluster), ctx,
+          &m_tf_executor));
+      // Warm up, so that kernel creation is not counted against TF.
+      TF_RETURN_IF_ERROR(m_tf_executor->Run(ctx, inputs, &outputs));
+      outputs.clear();
+    }
+
+    auto tf_start = std::chrono::steady_clock::now();
+    TF_RETURN_IF_ERROR(m_tf_executor->Run(ctx, inputs, &outputs));
+    double tf_us = std::chrono::duration<double, std::micro>(
+                       std::chrono::steady_clock::now() - tf_start)
+                       .count();
+
+    NGraphClusterProfile::RecordStep(m_profile_key, ngraph_us, tf_us,
+                                     transfer_us);
+    NGRAPH_VLOG(2) << "Profiled cluster " << m_ngraph_cluster << ": nGraph "
+                   << ngraph_us << "us (transfer " << transfer_us
+                   << "us), TF " << tf_us << "us";
+
+    if (++m_profiled_steps == NUM_PROFILED_STEPS) {
+      TF_RETURN_IF_ERROR(
+          NGraphClusterProfile::Save(config::GetClusterProfilePath()));
+    }
+    return Status::OK();
+  }
+
+  // Runs the current step with native TF kernels instead of nGraph.
+  Status RunWithTF(OpKernelContext* ctx) {
+    std::vector<Tensor> inputs;
+    for (int i = 0; i < ctx->num_inputs(); i++) {
+      inputs.push_back(ctx->input(i));
+    }
+    std::vector<Tensor> outputs;
+
+    if (m_tf_executor == nullptr) {
+      TF_RETURN_IF_ERROR(NGraphTFExecutor::Create(
+          *NGraphClusterManager::GetClusterGraph(m_ngraph_cluster), ctx,
+          &m_tf_executor));
+    }
+    TF_RETURN_IF_ERROR(m_tf_executor->Run(ctx, inputs, &outputs));
+
+    for (size_t i = 0; i < outputs.size(); i++) {
+      ctx->set_output(i, outputs[i]);
+    }
+    return Status::OK();
+  }
+
+  // Counts a call, which needs to compile a function for a new signature or
+  // not. Sets "too_many" at the end of a window in which more than
+  // m_max_new_signature_rate of the calls needed a compile: such a kernel
+  // spends most of its time recompiling.
+  Status TrackNewSignatures(OpKernelContext* ctx, bool needs_compile,
+                            bool* too_many) {
+    *too_many = false;
+    double max_rate = m_max_new_signature_rate;
+    if (!m_recompile_fallback_enabled || max_rate >= 1) {
+      return Status::OK();
+    }
+
+    // The first compile is not counted, only the ones that follow it.
+    if (needs_compile) {
+      if (!m_last_input_signatures.empty()) {
+        m_window_new_signatures++;
+      }
+
+      // Find the inputs that differ from the last compiled signature.
+      m_input_changes.resize(ctx->num_inputs(), 0);
+      std::vector<string> input_signatures(ctx->num_inputs());
+      for (int i = 0; i < ctx->num_inputs(); i++) {
+        std::stringstream ss;
+        ss << ctx->input(i).shape().DebugString();
+        if (m_input_is_static[i]) {
+          TF_RETURN_IF_ERROR(TensorToStream(ss, ctx->input(i)));
+        }
+        input_signatures[i] = ss.str();
+        if (!m_last_input_signatures.empty() &&
+            input_signatures[i] != m_last_input_signatures[i]) {
+          m_input_changes[i]++;
+        }
       }
+      m_last_input_signatures = input_signatures;
+    }
 
-      // TODO(amprocte): We should be able to unref the tracker here, but it
-      // seems to screw things up in the C++ unit tests.
-      // m_freshness_tracker->Unref();
+    if (++m_window_steps < SIGNATURE_WINDOW_STEPS) {
+      return Status::OK();
+    }
+    *too_many = m_window_new_signatures > max_rate * SIGNATURE_WINDOW_STEPS;
+    m_window_steps = 0;
+    m_window_new_signatures = 0;
+
+    if (*too_many) {
+      int input = std::max_element(m_input_changes.begin(),
+                                   m_input_changes.end()) -
+                  m_input_changes.begin();
+      LOG(WARNING) << "Cluster " << m_ngraph_cluster << " ("
+                   << ctx->op_kernel().name() << ") saw new input "
+                   << "signatures on more than " << max_rate * 100
+                   << "% of its last " << SIGNATURE_WINDOW_STEPS
+                   << " calls, mostly because of input " << input << " ("
+                   << def().input(input)
+                   << (m_input_is_static[input] ? ", a static input" : "")
+                   << "); running it with TensorFlow from now on";
     }
+    return Status::OK();
   }
 
   template <typename T>
@@ -209,26 +400,28 @@ class NGraphEncapsulateOp : public OpKernel {
   // TODO(amprocte): this needs to be made thread-safe (compilation cache OK?).
   void Compute(OpKernelContext* ctx) override {
     std::lock_guard<std::mutex> lock(m_compute_lock);
+    auto compute_start = std::chrono::steady_clock::now();
     NGRAPH_VLOG(4) << "NGraphEncapsulateOp::Compute starting for cluster "
                    << m_ngraph_cluster;
 
+    if (m_run_with_tf) {
+      OP_REQUIRES_OK(ctx, RunWithTF(ctx));
+      return;
+    }
+
     NGRAPH_VLOG(4) << "Got backend of type: " << m_op_backend_name;
     ng::runtime::Backend* op_backend =
         BackendManager::GetBackend(m_op_backend_name);
 
     // Get the inputs
     std::vector<TensorShape> input_shapes;
-    std::stringstream signature_ss;
     for (int i = 0; i < ctx->num_inputs(); i++) {
-      const Tensor& input_tensor = ctx->input(i);
-      input_shapes.push_back(input_tensor.shape());
-      for (const auto& x : input_tensor.shape()) {
-        signature_ss << x.size << ",";
-      }
-      signature_ss << ";";
+      input_shapes.push_back(ctx->input(i).shape());
     }
 
-    signature_ss << "/";
+    std::stringstream signature_ss;
+    signature_ss << NGraphFunctionRegistry::ShapeSignature(input_shapes)
+                 << MixedPrecisionSignature();
 
     std::vector<const Tensor*> static_input_map(ctx->num_inputs());
     for (int i = 0; i < ctx->num_inputs(); i++) {
@@ -249,17 +442,65 @@ class NGraphEncapsulateOp : public OpKernel {
 
     auto it = m_ng_functions.find(signature);
 
-    NGRAPH_VLOG(4) << "NGraphEncapsulateOp::Compute got inputs for cluster "
-                   << m_ngraph_cluster;
-
     // Compile the graph using nGraph.
     //
     // TODO(amprocte): Investigate performance of the compilation cache.
-    if (it == m_ng_functions.end()) {
+    bool cache_miss = (it == m_ng_functions.end());
+    if (cache_miss) {
+      ng_function =
+          NGraphFunctionRegistry::Acquire(FunctionRegistryKey(signature));
+    }
+
+    if (cache_miss && ng_function != nullptr) {
+      NGRAPH_VLOG(1) << "Reusing shared function: " << ctx->op_kernel().name();
+      m_ng_functions[signature] = ng_function;
+    }
+
+    // Functions shared by other kernels, or preloaded, cost nothing to reuse,
+    // so only the signatures that need a compile are counted.
+    bool needs_compile = cache_miss && ng_function == nullptr;
+    bool too_many_signatures;
+    OP_REQUIRES_OK(
+        ctx, TrackNewSignatures(ctx, needs_compile, &too_many_signatures));
+    if (too_many_signatures) {
+      m_run_with_tf = true;
+      ReleaseFunctions();
+      OP_REQUIRES_OK(ctx, RunWithTF(ctx));
+      return;
+    }
+
+    NGRAPH_VLOG(4) << "NGraphEncapsulateOp::Compute got inputs for cluster "
+                   << m_ngraph_cluster;
+
+    if (needs_compile) {
       NGRAPH_VLOG(1) << "Compilation cache miss: " << ctx->op_kernel().name();
-      OP_REQUIRES_OK(
-          ctx, Builder::TranslateGraph(input_shapes, static_input_map, &m_graph,
-                                       ng_function));
+
+      // Simplify a copy of the cluster graph for these input shapes. This is
+      // mostly an optimization, so on failure we translate the original; only
+      // static inputs sunk into the cluster (see SinkStaticInputs) cannot be
+      // translated without it.
+      Graph simplified_graph(OpRegistry::Global());
+      const Graph* graph_to_translate = &m_graph;
+      if (std::getenv("NGRAPH_TF_DISABLE_GRAPH_SIMPLIFICATION") == nullptr) {
+        CopyGraph(m_graph, &simplified_graph);
+        Status status = SimplifyClusterGraph(&simplified_graph, input_shapes,
+                                             ctx->function_library());
+        if (status.ok()) {
+          NGRAPH_VLOG(1) << "Simplified cluster " << m_ngraph_cluster
+                         << " from " << m_graph.num_op_nodes() << " to "
+                         << simplified_graph.num_op_nodes() << " nodes";
+          graph_to_translate = &simplified_graph;
+        } else {
+          NGRAPH_VLOG(1) << "Could not simplify cluster " << m_ngraph_cluster
+                         << ": " << status.error_message();
+        }
+      }
+
+      OP_REQUIRES_OK(ctx, Builder::TranslateGraph(input_shapes,
+                                                  static_input_map,
+                                                  graph_to_translate,
+                                                  ng_function));
+      config::CountCompile();
 
       // Serialize to nGraph if needed
       if (std::getenv("NGRAPH_ENABLE_SERIALIZE") != nullptr) {
@@ -279,8 +520,12 @@ class NGraphEncapsulateOp : public OpKernel {
         }
       }
 
+      // If another kernel registered the same function while we were
+      // translating, we use theirs.
+      ng_function = NGraphFunctionRegistry::Register(
+          FunctionRegistryKey(signature), ng_function);
       m_ng_functions[signature] = ng_function;
-    } else {
+    } else if (!cache_miss) {
       ng_function = it->second;
     }
 
@@ -302,8 +547,10 @@ class NGraphEncapsulateOp : public OpKernel {
         << "NGraphEncapsulateOp::Compute got freshness tracker for cluster "
         << m_ngraph_cluster;
 
-    // Allocate tensors for arguments.
+    // Allocate tensors for arguments. Other kernels sharing ng_function keep
+    // their own tensors, so freshness is tracked for this kernel only.
     vector<shared_ptr<ng::runtime::Tensor>> ng_inputs;
+    NGraphFreshnessTracker::User freshness_user(this, ng_function);
 
     std::vector<std::pair<void*, std::shared_ptr<ng::runtime::Tensor>>>&
         input_caches = m_ng_function_input_cache_map[ng_function];
@@ -340,7 +587,7 @@ class NGraphEncapsulateOp : public OpKernel {
             //   2. we are using the same tensor in this argument position as
             //      the one we used last time ng_function was called.
             last_tv->set_stale(
-                !m_freshness_tracker->IsFresh(current_src_ptr, ng_function));
+                !m_freshness_tracker->IsFresh(current_src_ptr, freshness_user));
             current_tv = last_tv;
           } else {
             current_tv = op_backend->create_tensor(ng_element_type, ng_shape,
@@ -350,8 +597,8 @@ class NGraphEncapsulateOp : public OpKernel {
         } else {
           if (last_tv != nullptr) {
             if (current_src_ptr == last_src_ptr) {
-              last_tv->set_stale(
-                  !m_freshness_tracker->IsFresh(current_src_ptr, ng_function));
+              last_tv->set_stale(!m_freshness_tracker->IsFresh(
+                  current_src_ptr, freshness_user));
             } else {
               last_tv->set_stale(true);
             }
@@ -451,6 +698,7 @@ class NGraphEncapsulateOp : public OpKernel {
         << m_ngraph_cluster;
 
     // Execute the nGraph function.
+    double call_us = 0;
     {
       // mutex_lock l(s_ng_backend_mutex);
       // std::lock_guard<std::mutex> lock(backend_mutex_ptr);
@@ -458,6 +706,19 @@ class NGraphEncapsulateOp : public OpKernel {
       NGRAPH_VLOG(4)
           << "NGraphEncapsulateOp::Compute call starting for cluster "
           << m_ngraph_cluster;
+
+      // Our input tensors hold current values (see the freshness user
+      // above), but the backend's own state for this (possibly shared)
+      // function, about which inputs are unchanged, only holds if we were
+      // the last kernel to call it.
+      if (NGraphFunctionRegistry::ExchangeLastUser(
+              FunctionRegistryKey(signature), this) != this) {
+        for (auto& tv : ng_inputs) {
+          tv->set_stale(true);
+        }
+      }
+
+      auto call_start = std::chrono::steady_clock::now();
       try {
         op_backend->call(ng_function, ng_outputs, ng_inputs);
       } catch (const std::exception& exp) {
@@ -471,6 +732,9 @@ class NGraphEncapsulateOp : public OpKernel {
             errors::Internal("Error in executing the nGraph computation\n"));
       }
       BackendManager::UnlockBackend(m_op_backend_name);
+      call_us = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - call_start)
+                    .count();
     }
     NGRAPH_VLOG(4) << "NGraphEncapsulateOp::Compute call done for cluster "
                    << m_ngraph_cluster;
@@ -502,12 +766,21 @@ class NGraphEncapsulateOp : public OpKernel {
     // Mark input tensors as fresh for the next time around.
     for (int i = 0; i < input_shapes.size(); i++) {
       void* src_ptr = (void*)DMAHelper::base(&ctx->input(i));
-      m_freshness_tracker->MarkFresh(src_ptr, ng_function);
+      m_freshness_tracker->MarkFresh(src_ptr, freshness_user);
     }
 
     NGRAPH_VLOG(4)
         << "NGraphEncapsulateOp::Compute done marking fresh for cluster "
         << m_ngraph_cluster;
+
+    // Steps that compiled a new function are not representative.
+    if (!cache_miss && m_profiled_steps < NUM_PROFILED_STEPS &&
+        config::IsRecordingClusterProfile()) {
+      double step_us = std::chrono::duration<double, std::micro>(
+                           std::chrono::steady_clock::now() - compute_start)
+                           .count();
+      OP_REQUIRES_OK(ctx, RecordProfileStep(ctx, call_us, step_us - call_us));
+    }
   }  // end compute
 
  private:
@@ -518,9 +791,27 @@ class NGraphEncapsulateOp : public OpKernel {
   NgFunctionIOCache m_ng_function_output_cache_map;
   NGraphFreshnessTracker* m_freshness_tracker;
   int m_ngraph_cluster;
+  // The cluster graph whose externalized Consts this kernel holds on to.
+  const GraphDef* m_const_store_graph = nullptr;
   std::vector<bool> m_input_is_static;
   std::mutex m_compute_lock;
   string m_op_backend_name;
+  string m_profile_key;
+  string m_graph_hash;
+  int m_profiled_steps = 0;
+  std::unique_ptr<NGraphTFExecutor> m_tf_executor;
+  // Taken from the config when the kernel is created. A rate of 1 or more
+  // disables the fallback to TF, as does disabling it outright.
+  bool m_recompile_fallback_enabled = true;
+  double m_max_new_signature_rate = 0.5;
+  // Calls, and calls with a new signature, in the current window.
+  int m_window_steps = 0;
+  int m_window_new_signatures = 0;
+  // The signature of each input on the last call with a new signature, and
+  // the number of new signatures for which it changed.
+  std::vector<string> m_last_input_signatures;
+  std::vector<int> m_input_changes;
+  bool m_run_with_tf = false;
   // static std::weak_ptr<ng::runtime::Backend> s_ng_backend_wptr;
   // static std::string s_ng_backend_name;
   // static mutex s_ng_backend_mutex;
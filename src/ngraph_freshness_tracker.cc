@@ -22,7 +22,7 @@ namespace tensorflow {
 namespace ngraph_bridge {
 
 void NGraphFreshnessTracker::MarkFresh(const void* base_pointer,
-                                       std::shared_ptr<ngraph::Function> user) {
+                                       const User& user) {
   mutex_lock l(mu_);
   auto it = freshness_map_.find(base_pointer);
   if (it != freshness_map_.end()) {
@@ -31,7 +31,7 @@ void NGraphFreshnessTracker::MarkFresh(const void* base_pointer,
 }
 
 bool NGraphFreshnessTracker::IsFresh(const void* base_pointer,
-                                     std::shared_ptr<ngraph::Function> user) {
+                                     const User& user) {
   mutex_lock l(mu_);
   auto it = freshness_map_.find(base_pointer);
   if (it == freshness_map_.end()) {
@@ -53,8 +53,7 @@ void NGraphFreshnessTracker::AddTensor(const void* base_pointer) {
   mutex_lock l(mu_);
   auto it = freshness_map_.find(base_pointer);
   if (it == freshness_map_.end()) {
-    freshness_map_[base_pointer] =
-        std::set<std::shared_ptr<ngraph::Function>>{};
+    freshness_map_[base_pointer] = std::set<User>{};
   }
 }
 
@@ -63,10 +62,9 @@ void NGraphFreshnessTracker::RemoveTensor(const void* base_pointer) {
   freshness_map_.erase(base_pointer);
 }
 
-void NGraphFreshnessTracker::RemoveUser(
-    std::shared_ptr<ngraph::Function> user) {
+void NGraphFreshnessTracker::RemoveUser(const User& user) {
   mutex_lock l(mu_);
-  for (auto kv : freshness_map_) {
+  for (auto& kv : freshness_map_) {
     kv.second.erase(user);
   }
 }
@@ -17,6 +17,7 @@
 #define NGRAPH_FRESHNESS_TRACKER_H_
 
 #include <set>
+#include <utility>
 #include "ngraph_utils.h"
 
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -30,52 +31,58 @@ namespace ngraph_bridge {
 // suitable in cases where a tensor's base pointer cannot be changed. Tensors
 // internal to the nGraph bridge conform to these restrictions.
 //
+// Freshness is tracked per user, a pair of a kernel and one of its functions:
+// kernels sharing a function (see NGraphFunctionRegistry) each keep their own
+// copies of its inputs on the device, so a tensor being fresh for one of them
+// says nothing about the others.
+//
 // General usage:
 //
 //   NGraphFreshnessTracker* tracker;
 //   Tensor* t = ...;
-//   std::shared_ptr<ngraph::Function> ng_func1 = something;
-//   std::shared_ptr<ngraph::Function> ng_func2 = something_else;
+//   std::shared_ptr<ngraph::Function> ng_func = something;
+//   NGraphFreshnessTracker::User user1(kernel1, ng_func);
+//   NGraphFreshnessTracker::User user2(kernel2, ng_func);
 //   ...
 //   const void* tensor_base_ptr = (const void *)DMAHelper::base(t);
 //
-//   [tracker->IsFresh(tensor_base_ptr,ng_func1) will return false]
-//   [tracker->IsFresh(tensor_base_ptr,ng_func2) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user1) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user2) will return false]
 //
-//   tracker->MarkFresh(tensor_base_ptr,ng_func1);
+//   tracker->MarkFresh(tensor_base_ptr,user1);
 //                                        // TRIES to mark "t" as fresh for
-//                                        // ng_func1, but has no effect
+//                                        // user1, but has no effect
 //                                        // because t has not been registered
 //                                        // yet.
 //
-//   [tracker->IsFresh(tensor_base_ptr,ng_func1) will _still_ return false]
-//   [tracker->IsFresh(tensor_base_ptr,ng_func2) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user1) will _still_ return false]
+//   [tracker->IsFresh(tensor_base_ptr,user2) will return false]
 //
 //   tracker->AddTensor(tensor_base_ptr); // registers "t"
-//   tracker->MarkFresh(tensor_base_ptr); // marks "t" fresh for ng_func1
+//   tracker->MarkFresh(tensor_base_ptr,user1); // marks "t" fresh for user1
 //
-//   [tracker->IsFresh(tensor_base_ptr,ng_func1) will return true]
-//   [tracker->IsFresh(tensor_base_ptr,ng_func2) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user1) will return true]
+//   [tracker->IsFresh(tensor_base_ptr,user2) will return false]
 //
-//   tracker->MarkStale(tensor_base_ptr); // marks t as "stale" for all funcs
+//   tracker->MarkStale(tensor_base_ptr); // marks t as "stale" for all users
 //
-//   [tracker->IsFresh(tensor_base_ptr,ng_func1) will return false]
-//   [tracker->IsFresh(tensor_base_ptr,ng_func2) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user1) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user2) will return false]
 //
-//   tracker->MarkFresh(tensor_base_ptr,ng_func1); // marks "t" fresh for
-//                                                 // ng_func1
-//   tracker->RemoveUser(ng_func1);                // removes all freshness
-//                                                 // info for ng_func1
+//   tracker->MarkFresh(tensor_base_ptr,user1); // marks "t" fresh for
+//                                              // user1
+//   tracker->RemoveUser(user1);                // removes all freshness
+//                                              // info for user1
 //
-//   [tracker->IsFresh(tensor_base_ptr,ng_func1) will return false]
-//   [tracker->IsFresh(tensor_base_ptr,ng_func2) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user1) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user2) will return false]
 //
-//   tracker->MarkFresh(tensor_base_ptr,ng_func2); // marks "t" fresh for
-//                                                 // ng_func2
-//   tracker->RemoveTensor(tensor_base_ptr);       // de-registers "t"
+//   tracker->MarkFresh(tensor_base_ptr,user2); // marks "t" fresh for
+//                                              // user2
+//   tracker->RemoveTensor(tensor_base_ptr);    // de-registers "t"
 //
-//   [tracker->IsFresh(tensor_base_ptr,ng_func1) will return false]
-//   [tracker->IsFresh(tensor_base_ptr,ng_func2) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user1) will return false]
+//   [tracker->IsFresh(tensor_base_ptr,user2) will return false]
 //
 // Inside the nGraph bridge, the freshness tracker is stored as a resource in
 // the ResourceMgr's default container, with the resource name
@@ -90,20 +97,19 @@ class NGraphFreshnessTracker : public ResourceBase {
 
   std::string DebugString() override { return "FreshnessTracker"; }
 
-  void MarkFresh(const void* base_pointer,
-                 std::shared_ptr<ngraph::Function> user);
-  bool IsFresh(const void* base_pointer,
-               std::shared_ptr<ngraph::Function> user);
+  typedef std::pair<const void*, std::shared_ptr<ngraph::Function>> User;
+
+  void MarkFresh(const void* base_pointer, const User& user);
+  bool IsFresh(const void* base_pointer, const User& user);
   void MarkStale(const void* base_pointer);
 
   void AddTensor(const void* base_pointer);
   void RemoveTensor(const void* base_pointer);
-  void RemoveUser(std::shared_ptr<ngraph::Function> user);
+  void RemoveUser(const User& user);
 
  private:
   mutex mu_;
-  std::map<const void*, std::set<std::shared_ptr<ngraph::Function>>>
-      freshness_map_;
+  std::map<const void*, std::set<User>> freshness_map_;
 
   ~NGraphFreshnessTracker() override {}
 };
@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <algorithm>
+#include <sstream>
+
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+#include "ngraph_function_registry.h"
+#include "ngraph_log.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+// Static initializers
+std::map<string, NGraphFunctionRegistry::Entry>
+    NGraphFunctionRegistry::s_entries;
+std::mutex NGraphFunctionRegistry::s_entries_mutex;
+
+//
+// Each node is hashed from its op type, its attributes, and the hashes of
+// the nodes feeding it (a Merkle hash), so two graphs get the same hash
+// exactly when they compute the same thing, whatever their nodes are called.
+// The graph hash combines the sorted hashes of all its nodes.
+//
+string NGraphFunctionRegistry::CanonicalGraphHash(const Graph& graph) {
+  std::vector<Node*> ordered;
+  GetReversePostOrder(graph, &ordered);
+
+  std::map<const Node*, uint64> node_hashes;
+  std::vector<uint64> all_hashes;
+
+  for (auto node : ordered) {
+    if (!node->IsOp()) {
+      continue;
+    }
+
+    uint64 hash = Fingerprint64(node->type_string());
+
+    // Protobuf map iteration order is unspecified, so sort the attributes.
+    // The cluster index and colocation groups differ between instances of
+    // the same cluster.
+    std::map<string, string> attrs;
+    for (auto& kv : node->def().attr()) {
+      if (kv.first == "_ngraph_cluster" || kv.first == "_class") {
+        continue;
+      }
+      attrs[kv.first] = kv.second.SerializeAsString();
+    }
+    for (auto& kv : attrs) {
+      hash = FingerprintCat64(hash, Fingerprint64(kv.first));
+      hash = FingerprintCat64(hash, Fingerprint64(kv.second));
+    }
+
+    std::vector<const Edge*> data_edges(node->num_inputs(), nullptr);
+    std::vector<uint64> control_hashes;
+    for (auto edge : node->in_edges()) {
+      if (edge->IsControlEdge()) {
+        control_hashes.push_back(node_hashes[edge->src()]);
+      } else {
+        data_edges[edge->dst_input()] = edge;
+      }
+    }
+
+    for (auto edge : data_edges) {
+      if (edge == nullptr) {
+        continue;
+      }
+      hash = FingerprintCat64(hash, node_hashes[edge->src()]);
+      hash = FingerprintCat64(hash, edge->src_output());
+    }
+
+    std::sort(control_hashes.begin(), control_hashes.end());
+    for (auto control_hash : control_hashes) {
+      hash = FingerprintCat64(hash, control_hash);
+    }
+
+    node_hashes[node] = hash;
+    all_hashes.push_back(hash);
+  }
+
+  std::sort(all_hashes.begin(), all_hashes.end());
+  uint64 graph_hash = Fingerprint64("ngraph_cluster");
+  for (auto hash : all_hashes) {
+    graph_hash = FingerprintCat64(graph_hash, hash);
+  }
+
+  return strings::FpToString(graph_hash);
+}
+
+string NGraphFunctionRegistry::MakeKey(const string& graph_hash,
+                                       const string& backend,
+                                       const string& signature) {
+  return graph_hash + "/" + backend + "/" + signature;
+}
+
+string NGraphFunctionRegistry::ShapeSignature(
+    const std::vector<TensorShape>& input_shapes) {
+  std::stringstream ss;
+  for (const auto& shape : input_shapes) {
+    for (const auto& dim : shape) {
+      ss << dim.size << ",";
+    }
+    ss << ";";
+  }
+  ss << "/";
+  return ss.str();
+}
+
+std::shared_ptr<ngraph::Function> NGraphFunctionRegistry::Acquire(
+    const string& key) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  auto it = s_entries.find(key);
+  if (it == s_entries.end()) {
+    return nullptr;
+  }
+  it->second.refcount++;
+  return it->second.function;
+}
+
+std::shared_ptr<ngraph::Function> NGraphFunctionRegistry::Register(
+    const string& key, std::shared_ptr<ngraph::Function> function) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  auto it = s_entries.find(key);
+  if (it != s_entries.end()) {
+    it->second.refcount++;
+    return it->second.function;
+  }
+
+  Entry& entry = s_entries[key];
+  entry.function = function;
+  entry.refcount = 1;
+  entry.last_user = nullptr;
+  return function;
+}
+
+bool NGraphFunctionRegistry::Preload(
+    const string& key, const string& backend,
+    std::shared_ptr<ngraph::Function> function) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  if (s_entries.find(key) != s_entries.end()) {
+    return false;
+  }
+
+  Entry& entry = s_entries[key];
+  entry.function = function;
+  entry.refcount = 0;
+  entry.last_user = nullptr;
+  entry.backend = backend;
+  return true;
+}
+
+// Entries only ever have no references between Preload and the first
+// Acquire; Release erases the others when their last reference goes.
+std::vector<std::pair<string, std::shared_ptr<ngraph::Function>>>
+NGraphFunctionRegistry::EvictPreloads(const std::set<string>& keep) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  std::vector<std::pair<string, std::shared_ptr<ngraph::Function>>> evicted;
+  for (auto it = s_entries.begin(); it != s_entries.end();) {
+    if (it->second.refcount > 0 || keep.count(it->first) != 0) {
+      ++it;
+      continue;
+    }
+    NGRAPH_VLOG(2) << "Evicting unused preloaded function " << it->first;
+    evicted.push_back(std::make_pair(it->second.backend, it->second.function));
+    it = s_entries.erase(it);
+  }
+  return evicted;
+}
+
+bool NGraphFunctionRegistry::Contains(const string& key) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+  return s_entries.find(key) != s_entries.end();
+}
+
+std::shared_ptr<ngraph::Function> NGraphFunctionRegistry::Release(
+    const string& key) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  auto it = s_entries.find(key);
+  if (it == s_entries.end()) {
+    return nullptr;
+  }
+  if (--it->second.refcount > 0) {
+    return nullptr;
+  }
+
+  std::shared_ptr<ngraph::Function> function = it->second.function;
+  s_entries.erase(it);
+  NGRAPH_VLOG(2) << "Released last reference to function " << key;
+  return function;
+}
+
+const void* NGraphFunctionRegistry::ExchangeLastUser(const string& key,
+                                                     const void* user) {
+  std::lock_guard<std::mutex> guard(s_entries_mutex);
+
+  auto it = s_entries.find(key);
+  if (it == s_entries.end()) {
+    return nullptr;
+  }
+  const void* last_user = it->second.last_user;
+  it->second.last_user = user;
+  return last_user;
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#ifndef NGRAPH_TF_FUNCTION_REGISTRY_H_
+#define NGRAPH_TF_FUNCTION_REGISTRY_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "ngraph/ngraph.hpp"
+
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Process-wide registry of translated nGraph functions, shared between all
+// NGraphEncapsulate kernels whose cluster graphs are structurally identical
+// (repeated blocks within a model, the same model loaded in several sessions,
+// replicated towers).
+//
+// Functions are keyed by a canonical hash of the cluster graph, which ignores
+// node names and cluster indices, together with the backend name and the
+// kernel's input signature. Each kernel holds one reference per key it uses;
+// when the last reference is released, the function is handed back to the
+// caller so that it can be removed from the backend.
+//
+// Backends keep per-function state about non-stale inputs, which is only
+// valid for the kernel that last called the function. Kernels must therefore
+// treat all inputs as stale whenever ExchangeLastUser reports that somebody
+// else called the function last.
+//
+class NGraphFunctionRegistry {
+ public:
+  // Returns a hash of "graph" that is independent of node names, and of
+  // attributes that differ between instances of the same cluster.
+  static string CanonicalGraphHash(const Graph& graph);
+
+  // Returns the key under which a kernel running the cluster with hash
+  // "graph_hash" on "backend" shares its function for "signature". The
+  // signature must cover everything that changes the translated function
+  // other than the graph and the backend: input shapes, static input values,
+  // and the mixed precision settings (MixedPrecisionSignature).
+  static string MakeKey(const string& graph_hash, const string& backend,
+                        const string& signature);
+
+  // Returns the part of a kernel's input signature that describes the shapes
+  // of its inputs.
+  static string ShapeSignature(const std::vector<TensorShape>& input_shapes);
+
+  // Returns the function registered under "key" and takes a reference to it,
+  // or returns nullptr if there is none.
+  static std::shared_ptr<ngraph::Function> Acquire(const string& key);
+
+  // Registers "function" under "key", with one reference held by the caller.
+  // If a function was registered for "key" in the meantime, that one is
+  // referenced and returned instead.
+  static std::shared_ptr<ngraph::Function> Register(
+      const string& key, std::shared_ptr<ngraph::Function> function);
+
+  // Registers "function", compiled ahead of time for "backend", under "key"
+  // without taking a reference, so that the first kernel to Acquire it owns
+  // it. Returns false if a function is already registered under "key".
+  static bool Preload(const string& key, const string& backend,
+                      std::shared_ptr<ngraph::Function> function);
+
+  // Unregisters the preloaded functions that no kernel has acquired, except
+  // those under the keys in "keep", and returns them with their backends so
+  // that they can be removed from the backends.
+  static std::vector<std::pair<string, std::shared_ptr<ngraph::Function>>>
+  EvictPreloads(const std::set<string>& keep);
+
+  static bool Contains(const string& key);
+
+  // Drops a reference to "key". Returns the function if this was the last
+  // reference, or nullptr otherwise.
+  static std::shared_ptr<ngraph::Function> Release(const string& key);
+
+  // Records "user" as the last caller of the function registered under
+  // "key", and returns the previous one.
+  static const void* ExchangeLastUser(const string& key, const void* user);
+
+ private:
+  struct Entry {
+    std::shared_ptr<ngraph::Function> function;
+    int refcount;
+    const void* last_user;
+    // Only set for preloaded functions.
+    string backend;
+  };
+
+  static std::map<string, Entry> s_entries;
+  static std::mutex s_entries_mutex;
+};
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
+
+#endif  // NGRAPH_TF_FUNCTION_REGISTRY_H_
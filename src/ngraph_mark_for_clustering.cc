@@ -118,6 +118,23 @@ static SetAttributesFunction SetStaticInputs(
   return cf;
 };
 
+// The quantized convolutions, which share a translation.
+static const std::vector<string>& QuantizedConv2DOpTypes() {
+  static const std::vector<string> op_types{
+      "QuantizedConv2D",
+      "QuantizedConv2DAndRelu",
+      "QuantizedConv2DAndReluAndRequantize",
+      "QuantizedConv2DAndRequantize",
+      "QuantizedConv2DWithBias",
+      "QuantizedConv2DWithBiasAndRelu",
+      "QuantizedConv2DWithBiasAndReluAndRequantize",
+      "QuantizedConv2DWithBiasAndRequantize",
+      "QuantizedConv2DWithBiasSignedSumAndReluAndRequantize",
+      "QuantizedConv2DWithBiasSumAndRelu",
+      "QuantizedConv2DWithBiasSumAndReluAndRequantize"};
+  return op_types;
+}
+
 // Generates a "simple" confirmation function which always returns true,
 static ConfirmationFunction SimpleConfirmationFunction() {
   auto cf = [](Node* n, bool* result) {
@@ -284,7 +301,14 @@ Status MarkForClustering(Graph* graph) {
         *result = (num_bits == 8) && range_given;
         return Status::OK();
       };
-      confirmation_function_map["QuantizedConv2DWithBiasAndReluAndRequantize"] =
+      confirmation_function_map["QuantizedAvgPool"] =
+          SimpleConfirmationFunction();
+      confirmation_function_map["QuantizedConcat"] =
+          SimpleConfirmationFunction();
+      for (const string& op_type : QuantizedConv2DOpTypes()) {
+        confirmation_function_map[op_type] = SimpleConfirmationFunction();
+      }
+      confirmation_function_map["QuantizedMatMul"] =
           SimpleConfirmationFunction();
       confirmation_function_map["QuantizedMaxPool"] =
           SimpleConfirmationFunction();
@@ -299,8 +323,12 @@ Status MarkForClustering(Graph* graph) {
       confirmation_function_map["Relu"] = SimpleConfirmationFunction();
       confirmation_function_map["Relu6"] = SimpleConfirmationFunction();
       confirmation_function_map["ReluGrad"] = SimpleConfirmationFunction();
+      confirmation_function_map["RequantizationRange"] =
+          SimpleConfirmationFunction();
+      confirmation_function_map["Requantize"] = SimpleConfirmationFunction();
       confirmation_function_map["Reshape"] = SimpleConfirmationFunction();
       confirmation_function_map["Rsqrt"] = SimpleConfirmationFunction();
+      confirmation_function_map["Select"] = SimpleConfirmationFunction();
       confirmation_function_map["Shape"] = SimpleConfirmationFunction();
       confirmation_function_map["Sigmoid"] = SimpleConfirmationFunction();
       confirmation_function_map["SigmoidGrad"] = SimpleConfirmationFunction();
@@ -318,6 +346,7 @@ Status MarkForClustering(Graph* graph) {
       confirmation_function_map["SquaredDifference"] =
           SimpleConfirmationFunction();
       confirmation_function_map["Squeeze"] = SimpleConfirmationFunction();
+      confirmation_function_map["StopGradient"] = SimpleConfirmationFunction();
       confirmation_function_map["StridedSlice"] = [](Node* n, bool* result) {
         // Reject if "new_axis_mask" is set.
         int tf_new_axis_mask;
@@ -356,8 +385,8 @@ Status MarkForClustering(Graph* graph) {
       type_constraint_map["BatchMatMul"]["T"] = NGraphNumericDTypes();
       type_constraint_map["BiasAdd"]["T"] = NGraphNumericDTypes();
       type_constraint_map["BiasAddGrad"]["T"] = NGraphNumericDTypes();
-      type_constraint_map["Cast"]["SrcT"] = NGraphDTypes();
-      type_constraint_map["Cast"]["DstT"] = NGraphDTypes();
+      type_constraint_map["Cast"]["SrcT"] = NGraphCastDTypes();
+      type_constraint_map["Cast"]["DstT"] = NGraphCastDTypes();
       type_constraint_map["ConcatV2"]["T"] = NGraphDTypes();
       type_constraint_map["ConcatV2"]["Tidx"] = NGraphIndexDTypes();
       type_constraint_map["Const"]["dtype"] = NGraphDTypes();
@@ -407,12 +436,27 @@ Status MarkForClustering(Graph* graph) {
       type_constraint_map["Prod"]["T"] = NGraphNumericDTypes();
       type_constraint_map["Prod"]["Tidx"] = NGraphIndexDTypes();
       type_constraint_map["QuantizeAndDequantizeV2"]["T"] = NGraphRealDTypes();
-      type_constraint_map["QuantizedConv2DWithBiasAndReluAndRequantize"]
-                         ["Tinput"] = NGraphSupportedQuantizedDTypes();
-      type_constraint_map["QuantizedConv2DWithBiasAndReluAndRequantize"]
-                         ["Tfilter"] = NGraphSupportedQuantizedDTypes();
-      type_constraint_map["QuantizedConv2DWithBiasAndReluAndRequantize"]
-                         ["Tbias"] = NGraphBiasDTypes();
+      type_constraint_map["QuantizedAvgPool"]["T"] =
+          NGraphSupportedQuantizedDTypes();
+      type_constraint_map["QuantizedConcat"]["T"] =
+          NGraphSupportedQuantizedDTypes();
+      for (const string& op_type : QuantizedConv2DOpTypes()) {
+        type_constraint_map[op_type]["Tinput"] =
+            NGraphSupportedQuantizedDTypes();
+        type_constraint_map[op_type]["Tfilter"] =
+            NGraphSupportedQuantizedDTypes();
+        type_constraint_map[op_type]["Tbias"] = NGraphBiasDTypes();
+        type_constraint_map[op_type]["Tsummand"] =
+            NGraphSupportedQuantizedDTypes();
+        type_constraint_map[op_type]["out_type"] =
+            NGraphQuantizedOutputDTypes();
+      }
+      type_constraint_map["QuantizedMatMul"]["T1"] =
+          NGraphSupportedQuantizedDTypes();
+      type_constraint_map["QuantizedMatMul"]["T2"] =
+          NGraphSupportedQuantizedDTypes();
+      type_constraint_map["QuantizedMatMul"]["Toutput"] =
+          NGraphQuantizedOutputDTypes();
       type_constraint_map["QuantizedMaxPool"]["T"] =
           NGraphSupportedQuantizedDTypes();
       type_constraint_map["QuantizeV2"]["T"] = NGraphSupportedQuantizedDTypes();
@@ -421,9 +465,16 @@ Status MarkForClustering(Graph* graph) {
       type_constraint_map["Relu"]["T"] = NGraphNumericDTypes();
       type_constraint_map["Relu6"]["T"] = NGraphNumericDTypes();
       type_constraint_map["ReluGrad"]["T"] = NGraphNumericDTypes();
+      type_constraint_map["RequantizationRange"]["Tinput"] =
+          NGraphQuantizedOutputDTypes();
+      type_constraint_map["Requantize"]["Tinput"] =
+          NGraphQuantizedOutputDTypes();
+      type_constraint_map["Requantize"]["out_type"] =
+          NGraphSupportedQuantizedDTypes();
       type_constraint_map["Reshape"]["T"] = NGraphDTypes();
       type_constraint_map["Reshape"]["Tshape"] = NGraphIndexDTypes();
       type_constraint_map["Rsqrt"]["T"] = NGraphDTypes();
+      type_constraint_map["Select"]["T"] = NGraphDTypes();
       type_constraint_map["Shape"]["T"] = NGraphDTypes();
       type_constraint_map["Shape"]["out_type"] = NGraphIndexDTypes();
       type_constraint_map["Sigmoid"]["T"] = NGraphNumericDTypes();
@@ -446,6 +497,7 @@ Status MarkForClustering(Graph* graph) {
       type_constraint_map["Square"]["T"] = NGraphDTypes();
       type_constraint_map["SquaredDifference"]["T"] = NGraphDTypes();
       type_constraint_map["Squeeze"]["T"] = NGraphDTypes();
+      type_constraint_map["StopGradient"]["T"] = NGraphDTypes();
       type_constraint_map["StridedSlice"]["T"] = NGraphDTypes();
       type_constraint_map["StridedSlice"]["Index"] = NGraphIndexDTypes();
       type_constraint_map["Sub"]["T"] = NGraphNumericDTypes();
@@ -477,8 +529,7 @@ Status MarkForClustering(Graph* graph) {
       set_attributes_map["Pad"] = SetStaticInputs({1});
       set_attributes_map["Prod"] = SetStaticInputs({1});
       set_attributes_map["QuantizeAndDequantizeV2"] = SetStaticInputs({1, 2});
-      set_attributes_map["QuantizedConv2DWithBiasAndReluAndRequantize"] =
-          SetStaticInputs({3, 4, 5, 6, 7, 8});
+      set_attributes_map["QuantizedConcat"] = SetStaticInputs({0});
       set_attributes_map["QuantizeV2"] = SetStaticInputs({1, 2});
       set_attributes_map["Reshape"] = SetStaticInputs({1});
       set_attributes_map["Slice"] = SetStaticInputs({1, 2});
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+#include <set>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+
+#include "ngraph_api.h"
+#include "ngraph_log.h"
+#include "ngraph_mixed_precision.h"
+
+using namespace std;
+namespace ng = ngraph;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Mixed precision. Convolutions and dot products, which dominate the run time
+// of most models and tolerate reduced input precision, are given bf16 inputs;
+// their results are converted back to f32 right away, so that everything
+// downstream (and in particular reductions, softmaxes and losses) still sees
+// f32. How the products are accumulated is up to the backend's bf16 kernels;
+// the pass does not ask for any particular accumulation precision.
+//
+// Ops are classified by nGraph op type:
+//
+//   allow - always run in bf16.
+//   infer - run in bf16 if all of their f32 inputs are bf16 values converted
+//           to f32, i.e. if doing so loses nothing. This keeps data in bf16
+//           between, say, a convolution, its padding and pooling, and the
+//           next convolution.
+//   deny  - always run in f32, even if listed above.
+//
+// Ops on no list run in f32. NGRAPH_TF_MIXED_PRECISION_ALLOW and
+// NGRAPH_TF_MIXED_PRECISION_DENY add comma-separated op types to the allow and
+// deny lists.
+//
+
+namespace {
+
+struct PrecisionLists {
+  std::set<string> allow;
+  std::set<string> infer;
+  std::set<string> deny;
+};
+
+void AddFromEnv(const char* env_var, std::set<string>* list) {
+  const char* value = std::getenv(env_var);
+  if (value == nullptr) {
+    return;
+  }
+  for (const string& op_type : str_util::Split(value, ',')) {
+    if (!op_type.empty()) {
+      list->insert(op_type);
+    }
+  }
+}
+
+const PrecisionLists& GetPrecisionLists() {
+  static PrecisionLists* lists = [] {
+    auto result = new PrecisionLists;
+    result->allow = {"Convolution", "ConvolutionBackpropData",
+                     "ConvolutionBackpropFilters", "Dot"};
+    result->infer = {"Add",     "AvgPool", "Broadcast", "Concat", "MaxPool",
+                     "Maximum", "Minimum", "Multiply",  "Pad",    "Relu",
+                     "Reshape", "Slice",   "Subtract"};
+    result->deny = {"BatchNormInference", "BatchNormTraining", "Divide",
+                    "Exp",                "Log",               "Max",
+                    "Min",                "Power",             "Product",
+                    "Sigmoid",            "Softmax",           "Sqrt",
+                    "Sum",                "Tanh"};
+    AddFromEnv("NGRAPH_TF_MIXED_PRECISION_ALLOW", &result->allow);
+    AddFromEnv("NGRAPH_TF_MIXED_PRECISION_DENY", &result->deny);
+    return result;
+  }();
+  return *lists;
+}
+
+// Returns true if "node" converts a bf16 value to f32.
+bool IsWidened(const shared_ptr<ng::Node>& node) {
+  return dynamic_pointer_cast<ng::op::Convert>(node) != nullptr &&
+         node->get_argument(0)->get_element_type() == ng::element::bf16;
+}
+
+shared_ptr<ng::Node> Narrow(const shared_ptr<ng::Node>& node) {
+  if (IsWidened(node)) {
+    return node->get_argument(0);
+  }
+  return make_shared<ng::op::Convert>(node, ng::element::bf16);
+}
+
+bool RunInBF16(const shared_ptr<ng::Node>& node, const PrecisionLists& lists) {
+  if (node->get_outputs().size() != 1 ||
+      node->get_element_type() != ng::element::f32) {
+    return false;
+  }
+  const string& op_type = node->description();
+  if (lists.deny.count(op_type) != 0) {
+    return false;
+  }
+  if (lists.allow.count(op_type) != 0) {
+    for (auto& arg : node->get_arguments()) {
+      if (arg->get_element_type() != ng::element::f32) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (lists.infer.count(op_type) != 0) {
+    bool any_f32 = false;
+    for (auto& arg : node->get_arguments()) {
+      if (arg->get_element_type() == ng::element::f32) {
+        if (!IsWidened(arg)) {
+          return false;
+        }
+        any_f32 = true;
+      }
+    }
+    return any_f32;
+  }
+  return false;
+}
+
+}  // namespace
+
+Status ApplyMixedPrecision(shared_ptr<ng::Function> ng_function) {
+  const PrecisionLists& lists = GetPrecisionLists();
+
+  try {
+    int num_rewrites = 0;
+    // Ops are visited in topological order, so the inputs of an infer op
+    // have already been rewritten when it is considered.
+    for (auto node : ng_function->get_ordered_ops()) {
+      if (node->get_users().empty() || !RunInBF16(node, lists)) {
+        continue;
+      }
+      ng::NodeVector new_args;
+      for (auto& arg : node->get_arguments()) {
+        new_args.push_back(arg->get_element_type() == ng::element::f32
+                               ? Narrow(arg)
+                               : arg);
+      }
+      ng::replace_node(node, make_shared<ng::op::Convert>(
+                                 node->copy_with_new_args(new_args),
+                                 ng::element::f32));
+      num_rewrites++;
+    }
+    NGRAPH_VLOG(3) << "Mixed precision moved " << num_rewrites
+                   << " ops to bf16 in " << ng_function->get_name();
+  } catch (const std::exception& e) {
+    return errors::Internal("Mixed precision rewrite failed: ", e.what());
+  }
+
+  return Status::OK();
+}
+
+string MixedPrecisionSignature() {
+  if (!config::IsMixedPrecisionEnabled()) {
+    return "";
+  }
+  const PrecisionLists& lists = GetPrecisionLists();
+  return strings::StrCat("bf16:allow=", str_util::Join(lists.allow, ","),
+                         ";deny=", str_util::Join(lists.deny, ","), "/");
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,38 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+
+#pragma once
+
+#include "ngraph/ngraph.hpp"
+
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+// Runs the compute-bound f32 ops of a translated function in bf16, with f32
+// at the function's boundary. See ngraph_mixed_precision.cc.
+Status ApplyMixedPrecision(std::shared_ptr<ngraph::Function> ng_function);
+
+// Describes the mixed precision settings translation currently applies (the
+// empty string when the mode is off), so that functions translated under
+// different settings are not mistaken for each other.
+string MixedPrecisionSignature();
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
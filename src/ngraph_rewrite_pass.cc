@@ -14,20 +14,37 @@
  * limitations under the License.
  *******************************************************************************/
 #include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/graph_constructor.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/protobuf.h"
 
 #include "ngraph_api.h"
 #include "ngraph_assign_clusters.h"
+#include "ngraph_backend_manager.h"
 #include "ngraph_capture_variables.h"
+#include "ngraph_cluster_manager.h"
+#include "ngraph_const_store.h"
+#include "ngraph_convert_conditionals.h"
 #include "ngraph_deassign_clusters.h"
 #include "ngraph_encapsulate_clusters.h"
 #include "ngraph_log.h"
 #include "ngraph_mark_for_clustering.h"
 #include "ngraph_rewrite_for_tracking.h"
+#include "ngraph_sink_static_inputs.h"
+#include "ngraph_unroll_loops.h"
+#include "ngraph_warmup.h"
 #include "tf_graph_writer.h"
 
 #include <iomanip>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
 
 using namespace std;
 
@@ -86,6 +103,133 @@ class NGraphRewritePass : public GraphOptimizationPass {
     return std::getenv("NGRAPH_TF_DUMP_GRAPHS") != nullptr;
   }
 
+  //
+  // Rewrite memoization. TF runs the optimization passes again for every new
+  // session, every new feed/fetch set, and every Estimator re-creation, very
+  // often on a graph we have already rewritten. We therefore remember the
+  // output of each pass, keyed by a fingerprint of the input graph (and of
+  // the configuration that affects the rewrite), and on a hit simply swap in
+  // a copy of the remembered output. The NGraphClusterManager entries that
+  // the remembered graph refers to are never released, so they stay valid.
+  //
+  // The memoization can be disabled by setting
+  // NGRAPH_TF_DISABLE_REWRITE_CACHE=1.
+  //
+  static bool RewriteCacheEnabled() {
+    return std::getenv("NGRAPH_TF_DISABLE_REWRITE_CACHE") == nullptr;
+  }
+
+  static uint64 RewriteFingerprint(const Graph* graph, const string& pass,
+                                   const string& config) {
+    GraphDef graph_def;
+    graph->ToGraphDef(&graph_def);
+
+    string serialized;
+    {
+      protobuf::io::StringOutputStream stream(&serialized);
+      protobuf::io::CodedOutputStream output(&stream);
+      output.SetSerializationDeterministic(true);
+      graph_def.SerializeToCodedStream(&output);
+    }
+
+    return FingerprintCat64(
+        Fingerprint64(serialized),
+        Fingerprint64(strings::StrCat(pass, "/", config)));
+  }
+
+  // If a rewrite with fingerprint "key" is cached, replaces the graph in
+  // "options" with a copy of its result, prints the placement it logged, if
+  // any, and sets "*restored" to true.
+  static Status MaybeRestoreRewrite(uint64 key,
+                                    const GraphOptimizationPassOptions& options,
+                                    bool* restored) {
+    *restored = false;
+
+    std::shared_ptr<const GraphDef> graph_def;
+    string placement_log;
+    {
+      mutex_lock l(s_rewrite_cache_mutex);
+      auto it = s_rewrite_cache.find(key);
+      if (it == s_rewrite_cache.end()) {
+        return Status::OK();
+      }
+      s_rewrite_cache_lru.splice(s_rewrite_cache_lru.begin(),
+                                 s_rewrite_cache_lru, it->second.lru_position);
+      graph_def = it->second.graph_def;
+      placement_log = it->second.placement_log;
+    }
+
+    std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
+    GraphConstructorOptions opts;
+    opts.allow_internal_ops = true;
+    TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(opts, *graph_def, graph.get()));
+
+    // The cached GraphDef carries each node's assigned device in its device
+    // field; placement has already happened, so restore the assignment.
+    for (auto node : graph->op_nodes()) {
+      node->set_assigned_device_name(node->def().device());
+    }
+
+    options.graph->swap(graph);
+    std::cout << placement_log << std::flush;
+    *restored = true;
+    return Status::OK();
+  }
+
+  // A cached rewrite holds on to the externalized Consts of the clusters it
+  // refers to, so that the kernels of a restored rewrite can still find them.
+  static Status AcquireConstStoreRefs(const GraphDef& graph_def) {
+    std::vector<const GraphDef*> acquired;
+    for (auto& node_def : graph_def.node()) {
+      if (node_def.op() != "NGraphEncapsulate") {
+        continue;
+      }
+      auto cluster_graph = NGraphClusterManager::GetClusterGraph(
+          node_def.attr().at("ngraph_cluster").i());
+      Status status = NGraphConstStore::Acquire(*cluster_graph);
+      if (!status.ok()) {
+        for (auto released : acquired) {
+          NGraphConstStore::Release(*released);
+        }
+        return status;
+      }
+      acquired.push_back(cluster_graph);
+    }
+    return Status::OK();
+  }
+
+  static void ReleaseConstStoreRefs(const GraphDef& graph_def) {
+    for (auto& node_def : graph_def.node()) {
+      if (node_def.op() == "NGraphEncapsulate") {
+        NGraphConstStore::Release(*NGraphClusterManager::GetClusterGraph(
+            node_def.attr().at("ngraph_cluster").i()));
+      }
+    }
+  }
+
+  static Status CacheRewrite(uint64 key, const Graph* graph,
+                             const string& placement_log = "") {
+    std::shared_ptr<GraphDef> graph_def(new GraphDef());
+    graph->ToGraphDef(graph_def.get());
+
+    mutex_lock l(s_rewrite_cache_mutex);
+    if (s_rewrite_cache.count(key) != 0) {
+      return Status::OK();
+    }
+    TF_RETURN_IF_ERROR(AcquireConstStoreRefs(*graph_def));
+    s_rewrite_cache_lru.push_front(key);
+    s_rewrite_cache[key] = CachedRewrite{graph_def, placement_log,
+                                         s_rewrite_cache_lru.begin()};
+
+    if (s_rewrite_cache_lru.size() > REWRITE_CACHE_SIZE) {
+      auto evicted = s_rewrite_cache.find(s_rewrite_cache_lru.back());
+      ReleaseConstStoreRefs(*evicted->second.graph_def);
+      s_rewrite_cache.erase(evicted);
+      s_rewrite_cache_lru.pop_back();
+    }
+    return Status::OK();
+  }
+
  private:
   static std::string DotFilename(std::string kind, int idx) {
     return GraphFilenamePrefix(kind, idx) + ".dot";
@@ -114,10 +258,30 @@ class NGraphRewritePass : public GraphOptimizationPass {
 
   static int s_serial_counter GUARDED_BY(s_serial_counter_mutex);
   static mutex s_serial_counter_mutex;
+
+  struct CachedRewrite {
+    std::shared_ptr<const GraphDef> graph_def;
+    // What the rewrite logged with placement logging on; restoring it logs
+    // the same again.
+    string placement_log;
+    std::list<uint64>::iterator lru_position;
+  };
+
+  static const size_t REWRITE_CACHE_SIZE = 16;
+  static std::map<uint64, CachedRewrite> s_rewrite_cache
+      GUARDED_BY(s_rewrite_cache_mutex);
+  static std::list<uint64> s_rewrite_cache_lru GUARDED_BY(
+      s_rewrite_cache_mutex);
+  static mutex s_rewrite_cache_mutex;
 };
 
 int NGraphRewritePass::s_serial_counter = 0;
 mutex NGraphRewritePass::s_serial_counter_mutex;
+const size_t NGraphRewritePass::REWRITE_CACHE_SIZE;
+std::map<uint64, NGraphRewritePass::CachedRewrite>
+    NGraphRewritePass::s_rewrite_cache;
+std::list<uint64> NGraphRewritePass::s_rewrite_cache_lru;
+mutex NGraphRewritePass::s_rewrite_cache_mutex;
 
 //
 // The variable capture pass replaces all instances of VariableV2 with the
@@ -152,12 +316,27 @@ class NGraphVariableCapturePass : public NGraphRewritePass {
       return Status::OK();
     }
 
+    uint64 key = 0;
+    if (RewriteCacheEnabled()) {
+      key = RewriteFingerprint(options.graph->get(), "capture", "");
+      bool restored;
+      TF_RETURN_IF_ERROR(MaybeRestoreRewrite(key, options, &restored));
+      if (restored) {
+        NGRAPH_VLOG(1) << "NGraphVariableCapturePass: reusing cached rewrite";
+        return Status::OK();
+      }
+    }
+
     // Do variable capture then, if requested, dump the graphs.
     TF_RETURN_IF_ERROR(CaptureVariables(options.graph->get()));
     if (DumpCapturedGraphs()) {
       DumpGraphs(options, idx, "captured", "Graph With Variables Captured");
     }
 
+    if (RewriteCacheEnabled()) {
+      TF_RETURN_IF_ERROR(CacheRewrite(key, options.graph->get()));
+    }
+
     return Status::OK();
   }
 
@@ -177,10 +356,13 @@ class NGraphVariableCapturePass : public NGraphRewritePass {
 //
 // The pass has several phases, each executed in sequence:
 //
-//   1. Marking [ngraph_mark_for_clustering.cc]
+//   1. Marking [ngraph_mark_for_clustering.cc], followed by unrolling of
+//      while-loops with static trip counts [ngraph_unroll_loops.cc] and
+//      if-conversion of small conditionals [ngraph_convert_conditionals.cc]
 //   2. Cluster Assignment [ngraph_assign_clusters.cc]
 //   3. Cluster Deassignment [ngraph_deassign_clusters.cc]
 //   4. Cluster Encapsulation [ngraph_encapsulate_clusters.cc]
+//   5. Session Warmup [ngraph_warmup.cc]
 //
 // Between phases, graph dumps (in both .dot and .pbtxt format) may be
 // requested by setting the following environment variables:
@@ -192,6 +374,9 @@ class NGraphVariableCapturePass : public NGraphRewritePass {
 //   NGRAPH_TF_DUMP_ENCAPSULATED_GRAPHS=1  dumps graphs after phase 4
 //   NGRAPH_TF_DUMP_GRAPHS=1               all of the above
 //
+// The result of all phases is memoized by a fingerprint of the input graph
+// and of the relevant configuration (see NGraphRewritePass).
+//
 class NGraphEncapsulationPass : public NGraphRewritePass {
  public:
   Status Run(const GraphOptimizationPassOptions& options) override {
@@ -219,8 +404,27 @@ class NGraphEncapsulationPass : public NGraphRewritePass {
       return Status::OK();
     }
 
+    // The cluster profile is read from a file that may change between
+    // sessions, so rewrites depending on it are not memoized.
+    bool use_cache =
+        RewriteCacheEnabled() && config::GetClusterProfilePath().empty();
+    uint64 key = 0;
+    if (use_cache) {
+      key = RewriteFingerprint(options.graph->get(), "encapsulation",
+                               RewriteConfigString());
+      bool restored;
+      TF_RETURN_IF_ERROR(MaybeRestoreRewrite(key, options, &restored));
+      if (restored) {
+        NGRAPH_VLOG(1) << "NGraphEncapsulationPass: reusing cached rewrite";
+        return WarmUpClusters(*options.graph->get());
+      }
+    }
+
     // 1. Mark for clustering then, if requested, dump the graphs.
     TF_RETURN_IF_ERROR(MarkForClustering(options.graph->get()));
+    TF_RETURN_IF_ERROR(UnrollWhileLoops(options.graph->get()));
+    TF_RETURN_IF_ERROR(ConvertConditionalsToSelect(options.graph->get()));
+    TF_RETURN_IF_ERROR(SinkStaticInputs(options.graph->get()));
     if (DumpMarkedGraphs()) {
       DumpGraphs(options, idx, "marked", "Graph Marked for Clustering");
     }
@@ -233,6 +437,10 @@ class NGraphEncapsulationPass : public NGraphRewritePass {
 
     // 3. Deassign trivial clusters then, if requested, dump the graphs.
     TF_RETURN_IF_ERROR(DeassignClusters(options.graph->get()));
+    string placement_log;
+    if (use_cache && config::IsLoggingPlacement()) {
+      placement_log = PlacementLog(options.graph->get());
+    }
     if (DumpDeclusteredGraphs()) {
       DumpGraphs(options, idx, "declustered",
                  "Graph with Trivial Clusters De-Assigned");
@@ -252,10 +460,53 @@ class NGraphEncapsulationPass : public NGraphRewritePass {
                  "Graph with Variables Rewritten for Tracking");
     }
 
+    if (use_cache) {
+      TF_RETURN_IF_ERROR(
+          CacheRewrite(key, options.graph->get(), placement_log));
+    }
+
+    // 5. Translate and compile the clusters ahead of the first step.
+    TF_RETURN_IF_ERROR(WarmUpClusters(*options.graph->get()));
+
     return Status::OK();
   }
 
  private:
+  // Every setting that can change the result of the phases above must be
+  // reflected here, or stale rewrites could be reused.
+  static string EnvString(const char* name) {
+    const char* value = std::getenv(name);
+    return value == nullptr ? "" : value;
+  }
+
+  static string RewriteConfigString() {
+    std::stringstream ss;
+    // Marking tags every node with the backend, and NGRAPH_TF_BACKEND
+    // overrides the one that is set.
+    ss << "backend=" << BackendManager::GetCurrentlySetBackendName()
+       << ",backend_env=" << EnvString("NGRAPH_TF_BACKEND")
+       << ",cost_model=" << config::IsCostModelEnabled()
+       << ",min_flops_per_byte=" << config::GetMinClusterFlopsPerByte()
+       << ",unknown_dim=" << config::GetCostModelUnknownDimSize()
+       << ",disable_deassign="
+       << (std::getenv("NGRAPH_TF_DISABLE_DEASSIGN_CLUSTERS") != nullptr)
+       << ",horizontal_merge=" << config::IsHorizontalMergeEnabled()
+       << ",max_loop_unroll=" << EnvString("NGRAPH_TF_MAX_LOOP_UNROLL")
+       << ",max_speculated_flops="
+       << EnvString("NGRAPH_TF_MAX_SPECULATED_FLOPS")
+       << ",disable_static_input_sinking="
+       << (std::getenv("NGRAPH_TF_DISABLE_STATIC_INPUT_SINKING") != nullptr)
+       << ",disable_graph_simplification="
+       << (std::getenv("NGRAPH_TF_DISABLE_GRAPH_SIMPLIFICATION") != nullptr)
+       << ",const_store_min_bytes="
+       << EnvString("NGRAPH_TF_CONST_STORE_MIN_BYTES")
+       << ",max_cluster_size=" << config::GetMaxClusterSize()
+       << ",max_cluster_flops=" << config::GetMaxClusterFlops()
+       // Only rewrites made while logging placement carry a placement log.
+       << ",logging_placement=" << config::IsLoggingPlacement();
+    return ss.str();
+  }
+
   static bool DumpUnmarkedGraphs() {
     return DumpAllGraphs() ||
            std::getenv("NGRAPH_TF_DUMP_UNMARKED_GRAPHS") != nullptr;
@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "tensorflow/core/common_runtime/constant_folding.h"
+#include "tensorflow/core/common_runtime/shape_refiner.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/optimizer_cse.h"
+#include "tensorflow/core/platform/env.h"
+
+#include "ngraph_const_store.h"
+#include "ngraph_log.h"
+#include "ngraph_simplify_graph.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Cluster graphs often compute shapes at runtime (Shape -> StridedSlice ->
+// Pack -> Reshape), and carry duplicate constants and repeated
+// subexpressions. Once the input shapes of the cluster are known, all of
+// these can be resolved before translation:
+//
+//   1. Shape inference is run with the actual input shapes, and every
+//      Shape, Size and Rank node whose input shape is fully known is
+//      replaced by a Const.
+//   2. TensorFlow's constant folding evaluates every subgraph that now only
+//      depends on constants.
+//   3. TensorFlow's CSE merges identical nodes, including identical Consts.
+//
+// This also lets the builder resolve static inputs (such as a Reshape's
+// shape) that used to be computed inside the cluster.
+//
+
+namespace {
+
+Status MakeShapeTensor(const Node* node, shape_inference::InferenceContext* ctx,
+                       shape_inference::ShapeHandle shape, Tensor* result) {
+  int rank = ctx->Rank(shape);
+  int64 num_elements = 1;
+  for (int i = 0; i < rank; i++) {
+    num_elements *= ctx->Value(ctx->Dim(shape, i));
+  }
+
+  if (node->type_string() == "Rank") {
+    *result = Tensor(DT_INT32, TensorShape({}));
+    result->scalar<int32>()() = rank;
+    return Status::OK();
+  }
+
+  DataType out_type;
+  TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "out_type", &out_type));
+  if (out_type != DT_INT32 && out_type != DT_INT64) {
+    return errors::InvalidArgument("Unexpected out_type for ", node->name());
+  }
+
+  if (node->type_string() == "Size") {
+    *result = Tensor(out_type, TensorShape({}));
+    if (out_type == DT_INT32) {
+      result->scalar<int32>()() = num_elements;
+    } else {
+      result->scalar<int64>()() = num_elements;
+    }
+    return Status::OK();
+  }
+
+  *result = Tensor(out_type, TensorShape({rank}));
+  for (int i = 0; i < rank; i++) {
+    int64 dim = ctx->Value(ctx->Dim(shape, i));
+    if (out_type == DT_INT32) {
+      result->vec<int32>()(i) = dim;
+    } else {
+      result->vec<int64>()(i) = dim;
+    }
+  }
+  return Status::OK();
+}
+
+// Replaces "node" by a Const holding "value".
+Status ReplaceWithConst(Graph* graph, Node* node, const Tensor& value) {
+  std::vector<Node*> control_inputs;
+  for (auto edge : node->in_edges()) {
+    if (edge->IsControlEdge() && edge->src()->IsOp()) {
+      control_inputs.push_back(edge->src());
+    }
+  }
+  std::vector<const Edge*> out_edges(node->out_edges().begin(),
+                                     node->out_edges().end());
+
+  Node* const_node;
+  TF_RETURN_IF_ERROR(NodeBuilder(graph->NewName(node->name() + "/folded"),
+                                 "Const")
+                         .Attr("dtype", value.dtype())
+                         .Attr("value", value)
+                         .ControlInputs(control_inputs)
+                         .Finalize(graph, &const_node));
+  const_node->set_assigned_device_name(node->assigned_device_name());
+
+  for (auto edge : out_edges) {
+    if (edge->IsControlEdge()) {
+      graph->AddControlEdge(const_node, edge->dst());
+    } else {
+      graph->AddEdge(const_node, 0, edge->dst(), edge->dst_input());
+    }
+  }
+  graph->RemoveNode(node);
+  return Status::OK();
+}
+
+Status FoldShapeOps(Graph* graph,
+                    const std::vector<TensorShape>& input_shapes) {
+  ShapeRefiner refiner(graph->versions(), graph->op_registry());
+  refiner.set_require_shape_inference_fns(false);
+
+  std::vector<Node*> ordered;
+  GetReversePostOrder(*graph, &ordered);
+
+  std::vector<std::pair<Node*, Tensor>> folded;
+  for (auto node : ordered) {
+    if (!node->IsOp()) {
+      continue;
+    }
+
+    Status status = refiner.AddNode(node);
+    if (!status.ok()) {
+      NGRAPH_VLOG(5) << "Shape inference failed for " << node->name() << ": "
+                     << status.error_message();
+      continue;
+    }
+    shape_inference::InferenceContext* ctx = refiner.GetContext(node);
+
+    if (node->type_string() == "_Arg") {
+      int index;
+      TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "index", &index));
+      if (index >= 0 && index < input_shapes.size()) {
+        shape_inference::ShapeHandle shape;
+        TF_RETURN_IF_ERROR(
+            ctx->MakeShapeFromTensorShape(input_shapes[index], &shape));
+        TF_RETURN_IF_ERROR(refiner.SetShape(node, 0, shape));
+      }
+      continue;
+    }
+
+    if (node->type_string() != "Shape" && node->type_string() != "Size" &&
+        node->type_string() != "Rank") {
+      continue;
+    }
+    shape_inference::ShapeHandle input_shape = ctx->input(0);
+    if (!ctx->FullyDefined(input_shape)) {
+      continue;
+    }
+    Tensor value;
+    TF_RETURN_IF_ERROR(MakeShapeTensor(node, ctx, input_shape, &value));
+    folded.push_back(std::make_pair(node, value));
+  }
+
+  for (auto& kv : folded) {
+    TF_RETURN_IF_ERROR(ReplaceWithConst(graph, kv.first, kv.second));
+  }
+  // The new Consts have no inputs; without an edge from the source node the
+  // passes below would not see them.
+  FixupSourceAndSinkEdges(graph);
+  return Status::OK();
+}
+
+}  // namespace
+
+Status SimplifyClusterGraph(Graph* graph,
+                            const std::vector<TensorShape>& input_shapes,
+                            FunctionLibraryRuntime* flib) {
+  TF_RETURN_IF_ERROR(FoldShapeOps(graph, input_shapes));
+
+  if (flib != nullptr) {
+    ConstantFoldingOptions options;
+    // Externalized Consts carry no value TensorFlow could evaluate.
+    options.consider = [](const Node* node) {
+      return !NGraphConstStore::IsExternalized(node->def());
+    };
+    bool was_mutated = false;
+    TF_RETURN_IF_ERROR(ConstantFold(options, flib, Env::Default(),
+                                    flib->device(), graph, &was_mutated));
+  }
+
+  OptimizeCSE(graph, nullptr);
+
+  FixupSourceAndSinkEdges(graph);
+  return Status::OK();
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
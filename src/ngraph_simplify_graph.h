@@ -0,0 +1,39 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+// Simplifies a cluster graph for one set of input shapes, ahead of
+// translation: folds shape computations and constant subgraphs, and
+// eliminates duplicate constants and common subexpressions. The function
+// library, which may be null, is used to evaluate constant subgraphs.
+Status SimplifyClusterGraph(Graph* graph,
+                            const std::vector<TensorShape>& input_shapes,
+                            FunctionLibraryRuntime* flib);
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,237 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+#include <map>
+#include <set>
+
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/graph/graph.h"
+
+#include "ngraph_const_store.h"
+#include "ngraph_log.h"
+#include "ngraph_mark_for_clustering.h"
+#include "ngraph_sink_static_inputs.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// A static input (see SetStaticInputs in ngraph_mark_for_clustering.cc), such
+// as the shape of a Reshape or the paddings of a Pad, must be known when the
+// cluster is translated. If its producer is outside the cluster, the value is
+// passed in as an argument and becomes part of the compilation signature: it
+// is serialized on every step, and the cluster is recompiled whenever it
+// changes. Yet such values are mostly computed from the shapes of other
+// tensors (Shape -> StridedSlice -> Pack -> Reshape), which are part of the
+// signature already.
+//
+// The static input sinking pass copies these computations into their
+// consumers. A static input is sunk if it is computed by ops of
+// SinkableOpTypes(), marked for clustering and assigned to the consumer's
+// backend, from Shape, Size and Rank ops (whatever their inputs) and from
+// integer Consts. The copies are marked "_ngraph_sunk_static_input", so that
+// AssignClusters contracts them into the cluster of the consumer (or, when
+// deadness or backends rule that out, keeps them out of it like any other
+// static input). Once the input shapes of the cluster
+// are known, SimplifyClusterGraph folds them into a Const, so that the builder
+// never sees them. Originals left without consumers are removed.
+//
+// This pass must run after MarkForClustering. It is disabled by setting
+// NGRAPH_TF_DISABLE_STATIC_INPUT_SINKING, or
+// NGRAPH_TF_DISABLE_GRAPH_SIMPLIFICATION (without which the copies could not
+// be translated).
+//
+
+namespace {
+
+const std::set<string>& SinkableOpTypes() {
+  static const std::set<string> op_types{
+      "Add",     "Cast", "ConcatV2", "FloorDiv", "Identity", "Maximum",
+      "Minimum", "Mul",  "Pack",     "Prod",     "Slice",    "StridedSlice",
+      "Sub"};
+  return op_types;
+}
+
+bool IsShapeOp(const Node* node) {
+  return node->type_string() == "Shape" || node->type_string() == "Size" ||
+         node->type_string() == "Rank";
+}
+
+bool IsIndexType(DataType dtype) {
+  return dtype == DT_INT32 || dtype == DT_INT64;
+}
+
+// Returns true if "node", and whatever it is computed from, can be sunk into
+// a cluster on "backend". Results are memoized in "sinkable".
+bool IsSinkable(Node* node, const string& backend,
+                std::map<Node*, bool>* sinkable) {
+  auto it = sinkable->find(node);
+  if (it != sinkable->end()) {
+    return it->second;
+  }
+
+  bool result = false;
+  string node_backend;
+  if (NodeIsMarkedForClustering(node) &&
+      GetNodeBackend(node, &node_backend).ok() && node_backend == backend &&
+      node->num_outputs() == 1 && IsIndexType(node->output_type(0))) {
+    if (node->type_string() == "Const") {
+      result = !NGraphConstStore::IsExternalized(node->def());
+    } else if (IsShapeOp(node)) {
+      result = true;
+    } else if (SinkableOpTypes().count(node->type_string()) != 0) {
+      result = true;
+      for (auto edge : node->in_edges()) {
+        if (!edge->IsControlEdge() &&
+            !IsSinkable(edge->src(), backend, sinkable)) {
+          result = false;
+          break;
+        }
+      }
+    }
+  }
+
+  (*sinkable)[node] = result;
+  return result;
+}
+
+// Copies "node", and whatever it is computed from up to the Shape, Size, Rank
+// and Const ops, reusing the copies already in "copies".
+Status CopySinkable(Graph* graph, Node* node, std::map<Node*, Node*>* copies,
+                    Node** result) {
+  auto it = copies->find(node);
+  if (it != copies->end()) {
+    *result = it->second;
+    return Status::OK();
+  }
+
+  NodeDef def = node->def();
+  def.set_name(graph->NewName(node->name() + "/ngraph_sunk"));
+  def.clear_input();
+
+  Status status;
+  Node* copy = graph->AddNode(def, &status);
+  TF_RETURN_IF_ERROR(status);
+  copy->set_assigned_device_name(node->assigned_device_name());
+  copy->AddAttr("_ngraph_sunk_static_input", true);
+
+  for (auto edge : node->in_edges()) {
+    Node* src = edge->src();
+    if (edge->IsControlEdge()) {
+      graph->AddControlEdge(src, copy);
+      continue;
+    }
+    if (!IsShapeOp(node)) {
+      TF_RETURN_IF_ERROR(CopySinkable(graph, src, copies, &src));
+    }
+    graph->AddEdge(src, edge->src_output(), copy, edge->dst_input());
+  }
+
+  (*copies)[node] = copy;
+  *result = copy;
+  return Status::OK();
+}
+
+bool IsUnused(const Node* node) {
+  for (auto edge : node->out_edges()) {
+    if (!edge->dst()->IsSink()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool IsSunkStaticInput(const Node* node) {
+  bool sunk = false;
+  return GetNodeAttr(node->attrs(), "_ngraph_sunk_static_input", &sunk).ok() &&
+         sunk;
+}
+
+Status SinkStaticInputs(Graph* graph) {
+  if (std::getenv("NGRAPH_TF_DISABLE_STATIC_INPUT_SINKING") != nullptr ||
+      std::getenv("NGRAPH_TF_DISABLE_GRAPH_SIMPLIFICATION") != nullptr) {
+    return Status::OK();
+  }
+
+  // Copying adds nodes to the graph, so collect the consumers first.
+  std::vector<Node*> consumers;
+  for (auto node : graph->op_nodes()) {
+    std::vector<int32> static_inputs;
+    GetStaticInputs(node, &static_inputs);
+    if (!static_inputs.empty() && NodeIsMarkedForClustering(node)) {
+      consumers.push_back(node);
+    }
+  }
+
+  std::set<Node*> originals;
+  for (auto node : consumers) {
+    string backend;
+    TF_RETURN_IF_ERROR(GetNodeBackend(node, &backend));
+
+    std::vector<int32> static_inputs;
+    GetStaticInputs(node, &static_inputs);
+    std::vector<const Edge*> input_edges;
+    TF_RETURN_IF_ERROR(node->input_edges(&input_edges));
+
+    std::map<Node*, bool> sinkable;
+    std::map<Node*, Node*> copies;
+    for (auto index : static_inputs) {
+      const Edge* edge = input_edges[index];
+      Node* src = edge->src();
+      if (src->type_string() == "Const" ||
+          !IsSinkable(src, backend, &sinkable)) {
+        continue;
+      }
+
+      NGRAPH_VLOG(3) << "Sinking static input " << index << " of "
+                     << node->name() << " from " << src->name();
+      Node* copy;
+      TF_RETURN_IF_ERROR(CopySinkable(graph, src, &copies, &copy));
+      graph->RemoveEdge(edge);
+      graph->AddEdge(copy, 0, node, index);
+    }
+    for (auto& kv : copies) {
+      originals.insert(kv.first);
+    }
+  }
+
+  // Remove the originals that nothing consumes anymore.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = originals.begin(); it != originals.end();) {
+      if (IsUnused(*it)) {
+        NGRAPH_VLOG(4) << "Removing " << (*it)->name();
+        graph->RemoveNode(*it);
+        it = originals.erase(it);
+        changed = true;
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "tensorflow/core/common_runtime/function.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/graph_constructor.h"
+
+#include "ngraph_const_store.h"
+#include "ngraph_log.h"
+#include "ngraph_tf_executor.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+Status NGraphTFExecutor::Create(const GraphDef& graph_def, OpKernelContext* ctx,
+                                std::unique_ptr<NGraphTFExecutor>* result) {
+  FunctionLibraryRuntime* lib = ctx->function_library();
+  if (lib == nullptr) {
+    return errors::Internal(
+        "No function library runtime available to run cluster with TF");
+  }
+
+  // TensorFlow needs the values of Consts moved to the constant store.
+  GraphDef internal_graph_def = graph_def;
+  TF_RETURN_IF_ERROR(NGraphConstStore::Internalize(&internal_graph_def));
+
+  std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
+  GraphConstructorOptions opts;
+  opts.allow_internal_ops = true;
+  TF_RETURN_IF_ERROR(
+      ConvertGraphDefToGraph(opts, internal_graph_def, graph.get()));
+
+  std::unique_ptr<NGraphTFExecutor> tf_executor(new NGraphTFExecutor());
+
+  for (auto node : graph->op_nodes()) {
+    if (!node->IsArg() && !node->IsRetval()) {
+      continue;
+    }
+
+    int32 index;
+    DataType dtype;
+    TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "index", &index));
+    TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "T", &dtype));
+
+    DataTypeVector& types =
+        node->IsArg() ? tf_executor->m_arg_types : tf_executor->m_ret_types;
+    if (index >= types.size()) {
+      types.resize(index + 1, DT_INVALID);
+    }
+    types[index] = dtype;
+  }
+
+  LocalExecutorParams params;
+  params.device = lib->device();
+  params.function_library = lib;
+  params.create_kernel = [lib](const NodeDef& ndef, OpKernel** kernel) {
+    return lib->CreateKernel(ndef, kernel);
+  };
+  params.delete_kernel = [](OpKernel* kernel) {
+    DeleteNonCachedKernel(kernel);
+  };
+
+  Executor* executor;
+  TF_RETURN_IF_ERROR(NewLocalExecutor(params, std::move(graph), &executor));
+  tf_executor->m_executor.reset(executor);
+
+  *result = std::move(tf_executor);
+  return Status::OK();
+}
+
+Status NGraphTFExecutor::Run(OpKernelContext* ctx,
+                             const std::vector<Tensor>& inputs,
+                             std::vector<Tensor>* outputs) {
+  FunctionCallFrame call_frame(m_arg_types, m_ret_types);
+  TF_RETURN_IF_ERROR(call_frame.SetArgs(inputs));
+
+  Executor::Args args;
+  args.step_id = ctx->step_id();
+  args.call_frame = &call_frame;
+  args.rendezvous = ctx->rendezvous();
+  args.cancellation_manager = ctx->cancellation_manager();
+  args.step_container = ctx->step_container();
+  // We are already running on one of the inter-op threads; running the
+  // cluster's kernels inline avoids waiting on that same pool.
+  args.runner = [](std::function<void()> fn) { fn(); };
+
+  TF_RETURN_IF_ERROR(m_executor->Run(args));
+  return call_frame.GetRetvals(outputs);
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
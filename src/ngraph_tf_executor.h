@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#ifndef NGRAPH_TF_EXECUTOR_H_
+#define NGRAPH_TF_EXECUTOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/op_kernel.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Runs a cluster graph (as stored in NGraphClusterManager) with TensorFlow's
+// own kernels, on the device and function library of the NGraphEncapsulate
+// op that owns it. The cluster's _Arg/_Retval nodes are bound through a
+// call frame, exactly as for a TF function call.
+//
+class NGraphTFExecutor {
+ public:
+  static Status Create(const GraphDef& graph_def, OpKernelContext* ctx,
+                       std::unique_ptr<NGraphTFExecutor>* result);
+
+  // Runs the graph synchronously on the calling thread.
+  Status Run(OpKernelContext* ctx, const std::vector<Tensor>& inputs,
+             std::vector<Tensor>* outputs);
+
+ private:
+  NGraphTFExecutor() {}
+
+  std::unique_ptr<Executor> m_executor;
+  DataTypeVector m_arg_types;
+  DataTypeVector m_ret_types;
+};
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
+
+#endif  // NGRAPH_TF_EXECUTOR_H_
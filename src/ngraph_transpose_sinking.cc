@@ -0,0 +1,258 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+
+#include "tensorflow/core/lib/core/errors.h"
+
+#include "ngraph_log.h"
+#include "ngraph_transpose_sinking.h"
+
+using namespace std;
+namespace ng = ngraph;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Layout-sensitive ops translated from NHWC (Conv2D, pooling,
+// FusedBatchNorm, ...) are wrapped in a pair of transposes, to NCHW on the
+// way in and back to NHWC on the way out (see ngraph_conversions.h). In a
+// chain of such ops the transpose out of one op and the transpose into the
+// next cancel, but elementwise ops in between (BiasAdd, Relu, residual Adds)
+// keep them apart.
+//
+// This pass moves transposes down past elementwise ops, then fuses adjacent
+// transposes, dropping those that compose to the identity. Activations thus
+// stay in NCHW along the chain, and transposes only remain where a
+// layout-agnostic consumer (or a cluster boundary) needs NHWC.
+//
+// A transpose is moved past an elementwise op only when that does not add
+// transposes: the op's other operands must be constants, broadcasts (which
+// are re-expressed in the new layout), or transposes with the same order,
+// and at least one operand transpose must have the op as its only user.
+//
+// Setting NGRAPH_TF_DISABLE_TRANSPOSE_SINKING disables the pass.
+//
+
+namespace {
+
+// Returns true if "node" is a Reshape that only permutes its input's axes,
+// setting "order" to the permutation.
+bool IsTranspose(const shared_ptr<ng::Node>& node, ng::AxisVector* order) {
+  auto reshape = dynamic_pointer_cast<ng::op::Reshape>(node);
+  if (reshape == nullptr) {
+    return false;
+  }
+  auto& input_shape = reshape->get_argument(0)->get_shape();
+  auto& output_shape = reshape->get_shape();
+  auto& input_order = reshape->get_input_order();
+  if (input_order.size() != input_shape.size() ||
+      output_shape.size() != input_shape.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < input_order.size(); i++) {
+    if (output_shape[i] != input_shape[input_order[i]]) {
+      return false;
+    }
+  }
+  *order = input_order;
+  return true;
+}
+
+bool IsIdentityOrder(const ng::AxisVector& order) {
+  for (size_t i = 0; i < order.size(); i++) {
+    if (order[i] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ng::AxisVector InvertOrder(const ng::AxisVector& order) {
+  ng::AxisVector inverse(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    inverse[order[i]] = i;
+  }
+  return inverse;
+}
+
+shared_ptr<ng::Node> MakeTranspose(shared_ptr<ng::Node> node,
+                                   const ng::AxisVector& order) {
+  if (IsIdentityOrder(order)) {
+    return node;
+  }
+  auto& input_shape = node->get_shape();
+  ng::Shape output_shape;
+  for (auto axis : order) {
+    output_shape.push_back(input_shape[axis]);
+  }
+  return make_shared<ng::op::Reshape>(node, order, output_shape);
+}
+
+// Constants, possibly already transposed; transposes of these are free to
+// create, and never worth sinking.
+bool IsConstant(const shared_ptr<ng::Node>& node) {
+  ng::AxisVector order;
+  if (IsTranspose(node, &order)) {
+    return IsConstant(node->get_argument(0));
+  }
+  return dynamic_pointer_cast<ng::op::Constant>(node) != nullptr;
+}
+
+bool IsElementwise(const shared_ptr<ng::Node>& node) {
+  return dynamic_pointer_cast<ng::op::util::UnaryElementwiseArithmetic>(
+             node) != nullptr ||
+         dynamic_pointer_cast<ng::op::util::BinaryElementwiseArithmetic>(
+             node) != nullptr ||
+         dynamic_pointer_cast<ng::op::util::BinaryElementwiseComparison>(
+             node) != nullptr ||
+         dynamic_pointer_cast<ng::op::util::BinaryElementwiseLogical>(node) !=
+             nullptr;
+}
+
+// Transpose(Transpose(x)) => Transpose(x), or x.
+bool FuseTransposes(const shared_ptr<ng::Node>& node) {
+  ng::AxisVector outer_order, inner_order;
+  if (!IsTranspose(node, &outer_order) ||
+      !IsTranspose(node->get_argument(0), &inner_order)) {
+    return false;
+  }
+  ng::AxisVector order(outer_order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = inner_order[outer_order[i]];
+  }
+  ng::replace_node(
+      node, MakeTranspose(node->get_argument(0)->get_argument(0), order));
+  return true;
+}
+
+// Re-expresses "broadcast", whose shape is that of a transpose with the given
+// order, in the layout of the transpose's input. Returns null if the
+// broadcast's argument would have to be transposed itself.
+shared_ptr<ng::Node> TransposeBroadcast(
+    const shared_ptr<ng::op::Broadcast>& broadcast,
+    const ng::AxisVector& order) {
+  auto& shape = broadcast->get_shape();
+  auto& axes = broadcast->get_broadcast_axes();
+
+  ng::Shape input_shape(shape.size());
+  ng::AxisSet input_axes;
+  size_t last_kept_axis = 0;
+  bool first_kept = true;
+  for (size_t i = 0; i < order.size(); i++) {
+    input_shape[order[i]] = shape[i];
+    if (axes.count(i) != 0) {
+      input_axes.insert(order[i]);
+    } else {
+      if (!first_kept && order[i] < last_kept_axis) {
+        return nullptr;
+      }
+      last_kept_axis = order[i];
+      first_kept = false;
+    }
+  }
+  return make_shared<ng::op::Broadcast>(broadcast->get_argument(0),
+                                        input_shape, input_axes);
+}
+
+// Elementwise(Transpose(x), ...) => Transpose(Elementwise(x, ...))
+bool SinkThroughElementwise(const shared_ptr<ng::Node>& node) {
+  if (!IsElementwise(node)) {
+    return false;
+  }
+
+  auto args = node->get_arguments();
+  ng::AxisVector order;
+  bool have_order = false;
+  int removable_transposes = 0;
+  for (auto& arg : args) {
+    ng::AxisVector arg_order;
+    if (IsConstant(arg) || !IsTranspose(arg, &arg_order)) {
+      continue;
+    }
+    if (have_order && arg_order != order) {
+      return false;
+    }
+    order = arg_order;
+    have_order = true;
+    if (arg->get_users().size() == 1) {
+      removable_transposes++;
+    }
+  }
+  if (!have_order || removable_transposes == 0) {
+    return false;
+  }
+
+  ng::AxisVector inverse = InvertOrder(order);
+  ng::NodeVector new_args;
+  for (auto& arg : args) {
+    ng::AxisVector arg_order;
+    if (IsConstant(arg)) {
+      new_args.push_back(MakeTranspose(arg, inverse));
+    } else if (IsTranspose(arg, &arg_order)) {
+      new_args.push_back(arg->get_argument(0));
+    } else if (auto broadcast = dynamic_pointer_cast<ng::op::Broadcast>(arg)) {
+      auto new_broadcast = TransposeBroadcast(broadcast, order);
+      if (new_broadcast == nullptr) {
+        return false;
+      }
+      new_args.push_back(new_broadcast);
+    } else {
+      return false;
+    }
+  }
+
+  ng::replace_node(node,
+                   MakeTranspose(node->copy_with_new_args(new_args), order));
+  return true;
+}
+
+}  // namespace
+
+Status SinkTransposes(shared_ptr<ng::Function> ng_function) {
+  if (std::getenv("NGRAPH_TF_DISABLE_TRANSPOSE_SINKING") != nullptr) {
+    return Status::OK();
+  }
+
+  try {
+    int num_rewrites = 0;
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (auto node : ng_function->get_ordered_ops()) {
+        // Nodes replaced earlier in this sweep have no users left.
+        if (node->get_users().empty()) {
+          continue;
+        }
+        if (FuseTransposes(node) || SinkThroughElementwise(node)) {
+          num_rewrites++;
+          changed = true;
+        }
+      }
+    }
+    NGRAPH_VLOG(3) << "Transpose sinking rewrote " << num_rewrites
+                   << " nodes in " << ng_function->get_name();
+  } catch (const std::exception& e) {
+    return errors::Internal("Transpose sinking failed: ", e.what());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,579 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <set>
+
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+
+#include "ngraph_log.h"
+#include "ngraph_mark_for_clustering.h"
+#include "ngraph_unroll_loops.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// The loop unrolling pass replaces TF while-loops that have a static trip
+// count, and whose bodies consist only of ops marked for clustering, by that
+// many copies of the loop body. The control-flow ops (Enter, Merge, Switch,
+// LoopCond, NextIteration, Exit) disappear, so the unrolled body can be
+// clustered, together with whatever surrounds the loop, into a single nGraph
+// function.
+//
+// A loop is unrolled only if it matches the shape tf.while_loop produces for
+// a simple counted loop:
+//
+//   - the loop condition is Less or LessEqual of one loop variable (the
+//     counter) and a constant;
+//   - the counter's initial value is a constant;
+//   - the body increments the counter by a positive constant with Add;
+//   - the loop is not nested in, and does not contain, another loop;
+//   - every node in the body is marked for clustering;
+//   - no control edges enter the loop from outside.
+//
+// Each Exit is replaced by an Identity of the same name, so that anything
+// referring to the loop's outputs by name still finds them.
+//
+// This pass must run after MarkForClustering. Loops whose trip count exceeds
+// NGRAPH_TF_MAX_LOOP_UNROLL (default 32) are left alone; setting it to 0
+// disables the pass.
+//
+
+static const int DEFAULT_MAX_LOOP_UNROLL = 32;
+
+namespace {
+
+struct LoopVar {
+  Node* enter = nullptr;
+  Node* merge = nullptr;
+  Node* switch_node = nullptr;
+  Node* next_iteration = nullptr;
+  Node* exit = nullptr;
+  std::set<Node*> identities;
+};
+
+struct Loop {
+  string frame_name;
+  std::vector<Node*> enters;
+  std::set<Node*> nodes;
+  std::vector<LoopVar> vars;
+  // Loop-invariant (is_constant) Enter nodes.
+  std::set<Node*> invariants;
+  Node* loop_cond = nullptr;
+};
+
+using Endpoint = std::pair<Node*, int>;
+
+int MaxLoopUnroll() {
+  const char* max_unroll = std::getenv("NGRAPH_TF_MAX_LOOP_UNROLL");
+  return max_unroll == nullptr ? DEFAULT_MAX_LOOP_UNROLL : atoi(max_unroll);
+}
+
+const Edge* GetDataInput(const Node* node, int index) {
+  for (auto edge : node->in_edges()) {
+    if (!edge->IsControlEdge() && edge->dst_input() == index) {
+      return edge;
+    }
+  }
+  return nullptr;
+}
+
+// Gets the value of an integer scalar Const, looking through Identity and
+// loop-invariant Enter nodes.
+bool GetScalarConstValue(const Node* node, int64* value) {
+  while (node->IsIdentity() || node->IsEnter()) {
+    if (node->IsEnter()) {
+      bool is_constant = false;
+      if (!GetNodeAttr(node->attrs(), "is_constant", &is_constant).ok() ||
+          !is_constant) {
+        return false;
+      }
+    }
+    const Edge* edge = GetDataInput(node, 0);
+    if (edge == nullptr) {
+      return false;
+    }
+    node = edge->src();
+  }
+
+  if (node->type_string() != "Const") {
+    return false;
+  }
+
+  const TensorProto* proto;
+  Tensor tensor;
+  if (!GetNodeAttr(node->attrs(), "value", &proto).ok() ||
+      !tensor.FromProto(*proto) || tensor.NumElements() != 1) {
+    return false;
+  }
+
+  switch (tensor.dtype()) {
+    case DT_INT32:
+      *value = tensor.flat<int32>()(0);
+      return true;
+    case DT_INT64:
+      *value = tensor.flat<int64>()(0);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Collects the frame's nodes: everything reachable from its Enter nodes
+// without going past an Exit. Returns false if the frame contains another
+// loop.
+bool CollectLoopNodes(Loop* loop) {
+  std::deque<Node*> queue(loop->enters.begin(), loop->enters.end());
+  loop->nodes.insert(loop->enters.begin(), loop->enters.end());
+
+  while (!queue.empty()) {
+    Node* node = queue.front();
+    queue.pop_front();
+
+    if (node->IsExit()) {
+      continue;
+    }
+
+    for (auto edge : node->out_edges()) {
+      Node* dst = edge->dst();
+      if (!dst->IsOp() || loop->nodes.count(dst) != 0) {
+        continue;
+      }
+      if (dst->IsEnter()) {
+        return false;
+      }
+      loop->nodes.insert(dst);
+      queue.push_back(dst);
+    }
+  }
+
+  return true;
+}
+
+// Identifies the loop variables and the LoopCond of the frame. Returns false
+// if the frame does not have the structure tf.while_loop produces.
+bool AnalyzeLoopStructure(Loop* loop) {
+  for (auto node : loop->nodes) {
+    if (node->IsLoopCond()) {
+      if (loop->loop_cond != nullptr) return false;
+      loop->loop_cond = node;
+    }
+  }
+  if (loop->loop_cond == nullptr) {
+    return false;
+  }
+
+  for (auto enter : loop->enters) {
+    bool is_constant = false;
+    if (!GetNodeAttr(enter->attrs(), "is_constant", &is_constant).ok()) {
+      return false;
+    }
+    if (is_constant) {
+      loop->invariants.insert(enter);
+      continue;
+    }
+
+    LoopVar var;
+    var.enter = enter;
+
+    for (auto edge : enter->out_edges()) {
+      if (edge->IsControlEdge()) continue;
+      if (!edge->dst()->IsMerge() || var.merge != nullptr) return false;
+      var.merge = edge->dst();
+    }
+    if (var.merge == nullptr) return false;
+
+    for (auto edge : var.merge->in_edges()) {
+      if (edge->IsControlEdge() || edge->src() == enter) continue;
+      if (!edge->src()->IsNextIteration() || var.next_iteration != nullptr) {
+        return false;
+      }
+      var.next_iteration = edge->src();
+    }
+    if (var.next_iteration == nullptr) return false;
+
+    for (auto edge : var.merge->out_edges()) {
+      if (!edge->IsControlEdge() && edge->src_output() == 0 &&
+          edge->dst()->IsSwitch()) {
+        if (var.switch_node != nullptr) return false;
+        var.switch_node = edge->dst();
+      }
+    }
+    if (var.switch_node == nullptr) return false;
+
+    const Edge* pred = GetDataInput(var.switch_node, 1);
+    if (pred == nullptr || pred->src() != loop->loop_cond) return false;
+
+    for (auto edge : var.switch_node->out_edges()) {
+      if (edge->IsControlEdge()) continue;
+      if (edge->src_output() == 0) {
+        if (!edge->dst()->IsExit() || var.exit != nullptr) return false;
+        var.exit = edge->dst();
+      } else if (edge->dst()->IsIdentity()) {
+        var.identities.insert(edge->dst());
+      } else {
+        return false;
+      }
+    }
+
+    loop->vars.push_back(var);
+  }
+
+  return !loop->vars.empty();
+}
+
+// Computes the trip count of the loop, or returns false if it is not a
+// simple counted loop with at most "max_trip_count" iterations.
+bool ComputeTripCount(const Loop& loop, int max_trip_count, int* trip_count) {
+  const Edge* cond_edge = GetDataInput(loop.loop_cond, 0);
+  if (cond_edge == nullptr) return false;
+  Node* cmp = cond_edge->src();
+  bool inclusive = cmp->type_string() == "LessEqual";
+  if (cmp->type_string() != "Less" && !inclusive) return false;
+
+  const Edge* lhs = GetDataInput(cmp, 0);
+  const Edge* rhs = GetDataInput(cmp, 1);
+  int64 limit;
+  if (lhs == nullptr || rhs == nullptr ||
+      !GetScalarConstValue(rhs->src(), &limit)) {
+    return false;
+  }
+
+  const LoopVar* counter = nullptr;
+  for (auto& var : loop.vars) {
+    if (lhs->src() == var.merge) counter = &var;
+  }
+  if (counter == nullptr) return false;
+
+  int64 init;
+  const Edge* init_edge = GetDataInput(counter->enter, 0);
+  if (init_edge == nullptr || !GetScalarConstValue(init_edge->src(), &init)) {
+    return false;
+  }
+
+  const Edge* next_edge = GetDataInput(counter->next_iteration, 0);
+  if (next_edge == nullptr) return false;
+  Node* add = next_edge->src();
+  if (add->type_string() != "Add" && add->type_string() != "AddV2") {
+    return false;
+  }
+
+  int64 step = 0;
+  bool found_counter = false;
+  for (int i = 0; i < 2; i++) {
+    const Edge* edge = GetDataInput(add, i);
+    if (edge == nullptr) return false;
+    if (counter->identities.count(edge->src()) != 0) {
+      found_counter = true;
+    } else if (!GetScalarConstValue(edge->src(), &step)) {
+      return false;
+    }
+  }
+  if (!found_counter || step <= 0) return false;
+
+  int count = 0;
+  for (int64 i = init; inclusive ? i <= limit : i < limit; i += step) {
+    if (++count > max_trip_count) return false;
+  }
+  *trip_count = count;
+  return true;
+}
+
+// Collects into "needed" the nodes of the loop that the values in "roots"
+// depend on, not counting the control-flow structure itself.
+void CollectAncestors(const Loop& loop, const std::set<Node*>& structure,
+                      const std::vector<Node*>& roots,
+                      std::set<Node*>* needed) {
+  std::deque<Node*> queue(roots.begin(), roots.end());
+  while (!queue.empty()) {
+    Node* node = queue.front();
+    queue.pop_front();
+    if (structure.count(node) != 0 || loop.nodes.count(node) == 0 ||
+        !needed->insert(node).second) {
+      continue;
+    }
+    for (auto edge : node->in_edges()) {
+      queue.push_back(edge->src());
+    }
+  }
+}
+
+Status UnrollLoop(Graph* graph, const Loop& loop, int trip_count,
+                  const std::vector<Node*>& rpo, bool* unrolled) {
+  *unrolled = false;
+
+  // The control-flow structure of the loop. Loop-variable identities are
+  // included, since they simply forward the current value.
+  std::set<Node*> structure(loop.invariants.begin(), loop.invariants.end());
+  structure.insert(loop.loop_cond);
+  std::vector<Node*> next_values;
+  for (auto& var : loop.vars) {
+    structure.insert({var.enter, var.merge, var.switch_node,
+                      var.next_iteration});
+    if (var.exit != nullptr) structure.insert(var.exit);
+    structure.insert(var.identities.begin(), var.identities.end());
+    next_values.push_back(GetDataInput(var.next_iteration, 0)->src());
+  }
+
+  std::set<Node*> body;
+  CollectAncestors(loop, structure, next_values, &body);
+
+  std::set<Node*> cond;
+  CollectAncestors(loop, structure, {GetDataInput(loop.loop_cond, 0)->src()},
+                   &cond);
+
+  for (auto node : loop.nodes) {
+    if (structure.count(node) == 0 && body.count(node) == 0 &&
+        cond.count(node) == 0) {
+      NGRAPH_VLOG(3) << "Not unrolling " << loop.frame_name
+                     << ": unused node " << node->name();
+      return Status::OK();
+    }
+  }
+
+  for (auto node : body) {
+    if (!NodeIsMarkedForClustering(node)) {
+      NGRAPH_VLOG(3) << "Not unrolling " << loop.frame_name
+                     << ": unsupported node " << node->name();
+      return Status::OK();
+    }
+  }
+
+  for (auto node : structure) {
+    for (auto edge : node->in_edges()) {
+      if (edge->IsControlEdge() && edge->src()->IsOp() &&
+          loop.nodes.count(edge->src()) == 0) {
+        NGRAPH_VLOG(3) << "Not unrolling " << loop.frame_name
+                       << ": control input from outside the loop";
+        return Status::OK();
+      }
+    }
+  }
+
+  NGRAPH_VLOG(2) << "Unrolling " << loop.frame_name << " " << trip_count
+                 << " times";
+
+  std::vector<Node*> ordered_body;
+  for (auto node : rpo) {
+    if (body.count(node) != 0) ordered_body.push_back(node);
+  }
+
+  // The current value of every loop variable, and the value of every
+  // loop-invariant Enter.
+  std::vector<Endpoint> values;
+  for (auto& var : loop.vars) {
+    const Edge* edge = GetDataInput(var.enter, 0);
+    values.push_back(Endpoint(edge->src(), edge->src_output()));
+  }
+  std::map<Node*, Endpoint> invariant_values;
+  for (auto enter : loop.invariants) {
+    const Edge* edge = GetDataInput(enter, 0);
+    invariant_values[enter] = Endpoint(edge->src(), edge->src_output());
+  }
+
+  for (int iteration = 0; iteration < trip_count; iteration++) {
+    std::map<Node*, Node*> clones;
+
+    // Maps an endpoint inside the loop to the corresponding endpoint in
+    // this iteration, or to a null node if it is part of the structure.
+    auto resolve = [&](Node* src, int src_output) -> Endpoint {
+      for (size_t k = 0; k < loop.vars.size(); k++) {
+        if (loop.vars[k].identities.count(src) != 0 ||
+            (src == loop.vars[k].switch_node && src_output == 1)) {
+          return values[k];
+        }
+      }
+      if (invariant_values.count(src) != 0) {
+        return invariant_values[src];
+      }
+      if (clones.count(src) != 0) {
+        return Endpoint(clones[src], src_output);
+      }
+      // Constants without control inputs may live outside the frame.
+      if (loop.nodes.count(src) == 0) {
+        return Endpoint(src, src_output);
+      }
+      return Endpoint(nullptr, 0);
+    };
+
+    for (auto node : ordered_body) {
+      NodeDef def = node->def();
+      def.set_name(graph->NewName(node->name() + "/ngraph_unrolled"));
+      def.clear_input();
+
+      Status status;
+      Node* clone = graph->AddNode(def, &status);
+      TF_RETURN_IF_ERROR(status);
+      clone->set_assigned_device_name(node->assigned_device_name());
+      clones[node] = clone;
+
+      for (auto edge : node->in_edges()) {
+        Endpoint src = resolve(edge->src(), edge->src_output());
+        if (src.first == nullptr) {
+          if (edge->IsControlEdge()) continue;
+          return errors::Internal("Cannot resolve input ", edge->DebugString(),
+                                  " while unrolling ", loop.frame_name);
+        }
+        if (edge->IsControlEdge()) {
+          graph->AddControlEdge(src.first, clone);
+        } else {
+          graph->AddEdge(src.first, src.second, clone, edge->dst_input());
+        }
+      }
+    }
+
+    std::vector<Endpoint> new_values;
+    for (auto& var : loop.vars) {
+      const Edge* edge = GetDataInput(var.next_iteration, 0);
+      new_values.push_back(resolve(edge->src(), edge->src_output()));
+      if (new_values.back().first == nullptr) {
+        return errors::Internal("Cannot resolve next value of ",
+                                var.merge->name(), " while unrolling ",
+                                loop.frame_name);
+      }
+    }
+    values = new_values;
+  }
+
+  // Replace each Exit by an Identity of the same name, once the loop itself
+  // is gone.
+  std::vector<std::vector<std::pair<Node*, int>>> exit_consumers(
+      loop.vars.size());
+  std::vector<string> exit_names(loop.vars.size());
+  std::vector<string> exit_devices(loop.vars.size());
+  std::vector<DataType> exit_types(loop.vars.size());
+  for (size_t k = 0; k < loop.vars.size(); k++) {
+    Node* exit = loop.vars[k].exit;
+    if (exit == nullptr) continue;
+    for (auto edge : exit->out_edges()) {
+      exit_consumers[k].push_back(
+          std::make_pair(edge->dst(), edge->dst_input()));
+    }
+    exit_names[k] = exit->name();
+    exit_devices[k] = exit->assigned_device_name();
+    exit_types[k] = exit->output_type(0);
+  }
+
+  for (auto node : loop.nodes) {
+    graph->RemoveNode(node);
+  }
+
+  for (size_t k = 0; k < loop.vars.size(); k++) {
+    if (loop.vars[k].exit == nullptr) continue;
+
+    Node* identity;
+    TF_RETURN_IF_ERROR(NodeBuilder(exit_names[k], "Identity")
+                           .Input(values[k].first, values[k].second)
+                           .Attr("T", exit_types[k])
+                           .Finalize(graph, &identity));
+    identity->set_assigned_device_name(exit_devices[k]);
+
+    for (auto& consumer : exit_consumers[k]) {
+      if (consumer.second == Graph::kControlSlot) {
+        graph->AddControlEdge(identity, consumer.first);
+      } else {
+        graph->AddEdge(identity, 0, consumer.first, consumer.second);
+      }
+    }
+  }
+
+  *unrolled = true;
+  return Status::OK();
+}
+
+}  // namespace
+
+Status UnrollWhileLoops(Graph* graph) {
+  int max_trip_count = MaxLoopUnroll();
+  if (max_trip_count <= 0) {
+    return Status::OK();
+  }
+
+  std::map<string, Loop> loops;
+  for (auto node : graph->op_nodes()) {
+    if (node->IsEnter()) {
+      string frame_name;
+      TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "frame_name", &frame_name));
+      loops[frame_name].frame_name = frame_name;
+      loops[frame_name].enters.push_back(node);
+    }
+  }
+
+  if (loops.empty()) {
+    return Status::OK();
+  }
+
+  // Collect every frame's nodes first, so that we can recognize loops nested
+  // in other loops.
+  std::set<string> candidates;
+  std::map<Node*, string> frame_of_node;
+  for (auto& kv : loops) {
+    if (CollectLoopNodes(&kv.second)) {
+      candidates.insert(kv.first);
+    }
+    for (auto node : kv.second.nodes) {
+      frame_of_node[node] = kv.first;
+    }
+  }
+
+  std::vector<Node*> rpo;
+  GetReversePostOrder(*graph, &rpo);
+
+  bool changed = false;
+  for (auto& frame_name : candidates) {
+    Loop& loop = loops[frame_name];
+
+    // The Exit of an earlier loop belongs to the enclosing frame.
+    bool nested = false;
+    for (auto enter : loop.enters) {
+      const Edge* edge = GetDataInput(enter, 0);
+      if (edge == nullptr || (frame_of_node.count(edge->src()) != 0 &&
+                              !edge->src()->IsExit())) {
+        nested = true;
+      }
+    }
+
+    int trip_count;
+    if (nested || !AnalyzeLoopStructure(&loop) ||
+        !ComputeTripCount(loop, max_trip_count, &trip_count)) {
+      NGRAPH_VLOG(3) << "Not unrolling " << frame_name;
+      continue;
+    }
+
+    bool unrolled;
+    TF_RETURN_IF_ERROR(UnrollLoop(graph, loop, trip_count, rpo, &unrolled));
+    changed |= unrolled;
+  }
+
+  if (changed) {
+    FixupSourceAndSinkEdges(graph);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
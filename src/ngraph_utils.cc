@@ -98,6 +98,9 @@ Status TFDataTypeToNGraphElementType(DataType tf_dt,
     case DataType::DT_DOUBLE:
       *ng_et = ng::element::f64;
       break;
+    case DataType::DT_BFLOAT16:
+      *ng_et = ng::element::bf16;
+      break;
     case DataType::DT_INT32:
       *ng_et = ng::element::i32;
       break;
@@ -125,6 +128,9 @@ Status TFDataTypeToNGraphElementType(DataType tf_dt,
     case DataType::DT_QUINT8:
       *ng_et = ng::element::u8;
       break;
+    case DataType::DT_QINT32:
+      *ng_et = ng::element::i32;
+      break;
     default:
       return errors::Unimplemented("Unsupported TensorFlow data type: ",
                                    DataType_Name(tf_dt));
@@ -180,11 +186,24 @@ const gtl::ArraySlice<DataType>& NGraphSupportedQuantizedDTypes() {
   return result;
 }
 
+const gtl::ArraySlice<DataType>& NGraphQuantizedOutputDTypes() {
+  static gtl::ArraySlice<DataType> result{DT_QINT8, DT_QUINT8, DT_QINT32};
+  return result;
+}
+
 const gtl::ArraySlice<DataType>& NGraphRealDTypes() {
   static gtl::ArraySlice<DataType> result{DT_FLOAT, DT_DOUBLE};
   return result;
 }
 
+const gtl::ArraySlice<DataType>& NGraphCastDTypes() {
+  static gtl::ArraySlice<DataType> result{
+      DT_FLOAT,  DT_DOUBLE,   DT_INT8,   DT_INT16,  DT_INT32, DT_INT64,
+      DT_UINT8,  DT_UINT16,   DT_UINT32, DT_UINT64, DT_BOOL,  DT_QINT8,
+      DT_QUINT8, DT_BFLOAT16};
+  return result;
+}
+
 const gtl::ArraySlice<DataType>& NGraphBiasDTypes() {
   static gtl::ArraySlice<DataType> result{DT_FLOAT, DT_QINT32};
   return result;
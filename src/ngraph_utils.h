@@ -182,9 +182,17 @@ const gtl::ArraySlice<DataType>& NGraphIndexDTypes();
 // Returns an ArraySlice containing supported data types in the quantized domain
 const gtl::ArraySlice<DataType>& NGraphSupportedQuantizedDTypes();
 
+// Returns an ArraySlice containing the dtypes quantized ops can produce: the
+// supported quantized types, and qint32 for unrequantized results.
+const gtl::ArraySlice<DataType>& NGraphQuantizedOutputDTypes();
+
 // Returns an ArraySlice containing supported real/non-integer data types
 const gtl::ArraySlice<DataType>& NGraphRealDTypes();
 
+// Returns an ArraySlice containing the dtypes Cast can convert from and to:
+// those of NGraphDTypes, and bfloat16, which is not otherwise supported.
+const gtl::ArraySlice<DataType>& NGraphCastDTypes();
+
 // Returns an ArraySlice containing supported bias types for custom quant op
 const gtl::ArraySlice<DataType>& NGraphBiasDTypes();
 
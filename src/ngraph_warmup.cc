@@ -0,0 +1,394 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+
+#include "tensorflow/core/common_runtime/shape_refiner.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph_constructor.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+
+#include "ngraph_backend_manager.h"
+#include "ngraph_builder.h"
+#include "ngraph_cluster_manager.h"
+#include "ngraph_function_registry.h"
+#include "ngraph_log.h"
+#include "ngraph_mark_for_clustering.h"
+#include "ngraph_mixed_precision.h"
+#include "ngraph_simplify_graph.h"
+#include "ngraph_warmup.h"
+
+using namespace std;
+namespace ng = ngraph;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+static const int64 DEFAULT_WARMUP_MEMORY_MB = 1024;
+
+namespace {
+
+struct WarmupJob {
+  int cluster;
+  string backend;
+  string key;
+  std::unique_ptr<Graph> graph;
+  std::vector<TensorShape> input_shapes;
+  int64 estimated_bytes;
+};
+
+// Warmup is opt-in, since it compiles clusters whether or not they ever
+// run, and never uses more threads than there are cores.
+int WarmupThreads() {
+  const char* threads = std::getenv("NGRAPH_TF_WARMUP_THREADS");
+  return threads == nullptr
+             ? 0
+             : std::min(atoi(threads), port::NumSchedulableCPUs());
+}
+
+int64 WarmupMemoryBytes() {
+  const char* memory_mb = std::getenv("NGRAPH_TF_WARMUP_MEMORY_MB");
+  int64 mb = memory_mb == nullptr ? DEFAULT_WARMUP_MEMORY_MB
+                                  : strtoll(memory_mb, nullptr, 10);
+  return mb << 20;
+}
+
+// Admits jobs as long as the sum of their estimated footprints stays within
+// the limit. A job that exceeds the limit by itself waits until it is the
+// only one running.
+class MemoryBudget {
+ public:
+  explicit MemoryBudget(int64 limit) : m_limit(limit), m_in_use(0) {}
+
+  void Acquire(int64 bytes) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this, bytes] {
+      return m_in_use == 0 || m_in_use + bytes <= m_limit;
+    });
+    m_in_use += bytes;
+  }
+
+  void Release(int64 bytes) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_in_use -= bytes;
+    }
+    m_cv.notify_all();
+  }
+
+ private:
+  int64 m_limit;
+  int64 m_in_use;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
+// Returns true if some _Arg of "graph" drives an input whose value is needed
+// for translation, in which case the signature depends on input values.
+bool HasStaticInputs(const Graph& graph) {
+  for (auto node : graph.op_nodes()) {
+    if (node->type_string() != "_Arg") {
+      continue;
+    }
+    for (auto edge : node->out_edges()) {
+      if (!edge->IsControlEdge() && edge->dst()->IsOp() &&
+          InputIsStatic(edge->dst(), edge->dst_input())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Infers the shapes of the results of the cluster "graph" when it is fed
+// inputs of "input_shapes". Results whose shape cannot be inferred are left
+// with unknown rank.
+Status InferClusterOutputShapes(
+    const Graph& graph, const std::vector<TensorShape>& input_shapes,
+    int num_outputs, std::vector<PartialTensorShape>* output_shapes) {
+  output_shapes->assign(num_outputs, PartialTensorShape());
+
+  ShapeRefiner refiner(graph.versions(), graph.op_registry());
+  refiner.set_require_shape_inference_fns(false);
+
+  std::vector<Node*> ordered;
+  GetReversePostOrder(graph, &ordered);
+
+  for (auto node : ordered) {
+    if (!node->IsOp()) {
+      continue;
+    }
+    if (!refiner.AddNode(node).ok()) {
+      continue;
+    }
+    shape_inference::InferenceContext* ctx = refiner.GetContext(node);
+
+    int index;
+    if (node->type_string() == "_Arg") {
+      TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "index", &index));
+      if (index >= 0 && index < input_shapes.size()) {
+        shape_inference::ShapeHandle shape;
+        TF_RETURN_IF_ERROR(
+            ctx->MakeShapeFromTensorShape(input_shapes[index], &shape));
+        TF_RETURN_IF_ERROR(refiner.SetShape(node, 0, shape));
+      }
+    } else if (node->type_string() == "_Retval") {
+      TF_RETURN_IF_ERROR(GetNodeAttr(node->attrs(), "index", &index));
+      shape_inference::ShapeHandle shape = ctx->input(0);
+      if (index >= 0 && index < num_outputs && ctx->RankKnown(shape)) {
+        std::vector<int64> dims(ctx->Rank(shape));
+        for (int d = 0; d < dims.size(); d++) {
+          dims[d] = ctx->Value(ctx->Dim(shape, d));
+        }
+        (*output_shapes)[index] = PartialTensorShape(dims);
+      }
+    }
+  }
+  return Status::OK();
+}
+
+// A rough upper bound on what translating and compiling "graph" holds in
+// memory: its constants, which end up in nGraph Constants, and its inputs
+// and outputs, which the backend allocates buffers for.
+int64 EstimateFootprint(const Graph& graph, const Node* encapsulate,
+                        const std::vector<TensorShape>& input_shapes,
+                        const std::vector<PartialTensorShape>& output_shapes) {
+  int64 bytes = 0;
+  for (int i = 0; i < input_shapes.size(); i++) {
+    bytes += input_shapes[i].num_elements() *
+             DataTypeSize(encapsulate->input_type(i));
+  }
+  for (int i = 0; i < output_shapes.size(); i++) {
+    if (output_shapes[i].IsFullyDefined()) {
+      bytes += output_shapes[i].num_elements() *
+               DataTypeSize(encapsulate->output_type(i));
+    }
+  }
+
+  for (auto node : graph.op_nodes()) {
+    if (node->type_string() != "Const") {
+      continue;
+    }
+    auto it = node->def().attr().find("value");
+    if (it == node->def().attr().end()) {
+      continue;
+    }
+    const TensorProto& proto = it->second.tensor();
+    bytes += TensorShape(proto.tensor_shape()).num_elements() *
+             DataTypeSize(proto.dtype());
+  }
+  return bytes;
+}
+
+Status RunWarmupJob(const WarmupJob& job) {
+  // As in NGraphEncapsulateOp, simplification is only an optimization. There
+  // is no function library here, so constant subgraphs are left alone.
+  Graph simplified_graph(OpRegistry::Global());
+  const Graph* graph_to_translate = job.graph.get();
+  if (std::getenv("NGRAPH_TF_DISABLE_GRAPH_SIMPLIFICATION") == nullptr) {
+    CopyGraph(*job.graph, &simplified_graph);
+    if (SimplifyClusterGraph(&simplified_graph, job.input_shapes, nullptr)
+            .ok()) {
+      graph_to_translate = &simplified_graph;
+    }
+  }
+
+  std::shared_ptr<ng::Function> ng_function;
+  std::vector<const Tensor*> static_input_map(job.input_shapes.size(),
+                                              nullptr);
+  TF_RETURN_IF_ERROR(Builder::TranslateGraph(
+      job.input_shapes, static_input_map, graph_to_translate, ng_function));
+
+  // Backends are not thread-safe, so only translation runs concurrently.
+  BackendManager::LockBackend(job.backend);
+  ng::runtime::Backend* backend = BackendManager::GetBackend(job.backend);
+  try {
+    backend->compile(ng_function);
+  } catch (const std::exception& exp) {
+    BackendManager::UnlockBackend(job.backend);
+    return errors::Internal("Caught exception while compiling cluster ",
+                            job.cluster, ": ", exp.what());
+  }
+  BackendManager::UnlockBackend(job.backend);
+
+  // A kernel may have registered its own function while we were busy.
+  if (!NGraphFunctionRegistry::Preload(job.key, job.backend, ng_function)) {
+    BackendManager::LockBackend(job.backend);
+    backend->remove_compiled_function(ng_function);
+    BackendManager::UnlockBackend(job.backend);
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+// Removes from their backends the functions preloaded by earlier warmups
+// that no kernel has claimed (because their sessions never ran, or ran with
+// other signatures), except those this warmup would preload again.
+static void EvictPreloads(const std::set<string>& keep) {
+  for (auto& kv : NGraphFunctionRegistry::EvictPreloads(keep)) {
+    BackendManager::LockBackend(kv.first);
+    BackendManager::GetBackend(kv.first)->remove_compiled_function(kv.second);
+    BackendManager::UnlockBackend(kv.first);
+  }
+}
+
+Status WarmUpClusters(const Graph& graph) {
+  int num_threads = WarmupThreads();
+  if (num_threads <= 0) {
+    EvictPreloads({});
+    return Status::OK();
+  }
+
+  //
+  // Walk the graph in topological order with shape inference, so that the
+  // input shapes of each cluster are known by the time we reach it. The
+  // NGraphEncapsulate op has no shape function, so we set the shapes of its
+  // outputs ourselves.
+  //
+  ShapeRefiner refiner(graph.versions(), graph.op_registry());
+  refiner.set_require_shape_inference_fns(false);
+
+  std::vector<Node*> ordered;
+  GetReversePostOrder(graph, &ordered);
+
+  std::vector<std::unique_ptr<WarmupJob>> jobs;
+  std::set<string> job_keys;
+  // Keys of every cluster we can warm up, including those already in the
+  // registry.
+  std::set<string> wanted_keys;
+
+  for (auto node : ordered) {
+    if (!node->IsOp()) {
+      continue;
+    }
+    if (!refiner.AddNode(node).ok() ||
+        node->type_string() != "NGraphEncapsulate") {
+      continue;
+    }
+    shape_inference::InferenceContext* ctx = refiner.GetContext(node);
+
+    std::vector<TensorShape> input_shapes;
+    bool shapes_known = true;
+    for (int i = 0; i < ctx->num_inputs() && shapes_known; i++) {
+      shape_inference::ShapeHandle shape = ctx->input(i);
+      if (!ctx->FullyDefined(shape)) {
+        shapes_known = false;
+        break;
+      }
+      TensorShape input_shape;
+      for (int d = 0; d < ctx->Rank(shape); d++) {
+        input_shape.AddDim(ctx->Value(ctx->Dim(shape, d)));
+      }
+      input_shapes.push_back(input_shape);
+    }
+    if (!shapes_known) {
+      continue;
+    }
+
+    std::unique_ptr<WarmupJob> job(new WarmupJob());
+    TF_RETURN_IF_ERROR(
+        GetNodeAttr(node->attrs(), "ngraph_cluster", &job->cluster));
+    TF_RETURN_IF_ERROR(
+        GetNodeAttr(node->attrs(), "_ngraph_backend", &job->backend));
+
+    job->graph.reset(new Graph(OpRegistry::Global()));
+    GraphConstructorOptions opts;
+    opts.allow_internal_ops = true;
+    TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(
+        opts, *NGraphClusterManager::GetClusterGraph(job->cluster),
+        job->graph.get()));
+
+    std::vector<PartialTensorShape> output_shapes;
+    TF_RETURN_IF_ERROR(InferClusterOutputShapes(
+        *job->graph, input_shapes, node->num_outputs(), &output_shapes));
+    for (int i = 0; i < output_shapes.size(); i++) {
+      shape_inference::ShapeHandle shape;
+      TF_RETURN_IF_ERROR(
+          ctx->MakeShapeFromPartialTensorShape(output_shapes[i], &shape));
+      TF_RETURN_IF_ERROR(refiner.SetShape(node, i, shape));
+    }
+
+    if (HasStaticInputs(*job->graph)) {
+      continue;
+    }
+
+    job->key = NGraphFunctionRegistry::MakeKey(
+        NGraphFunctionRegistry::CanonicalGraphHash(*job->graph), job->backend,
+        NGraphFunctionRegistry::ShapeSignature(input_shapes) +
+            MixedPrecisionSignature());
+    wanted_keys.insert(job->key);
+    if (NGraphFunctionRegistry::Contains(job->key) ||
+        !job_keys.insert(job->key).second) {
+      continue;
+    }
+
+    job->estimated_bytes =
+        EstimateFootprint(*job->graph, node, input_shapes, output_shapes);
+    job->input_shapes = input_shapes;
+    BackendManager::CreateBackendIfDoesNotExist(job->backend);
+    jobs.push_back(std::move(job));
+  }
+
+  EvictPreloads(wanted_keys);
+  if (jobs.empty()) {
+    return Status::OK();
+  }
+
+  NGRAPH_VLOG(1) << "Warming up " << jobs.size() << " clusters on "
+                 << num_threads << " threads";
+  auto start = std::chrono::steady_clock::now();
+
+  MemoryBudget budget(WarmupMemoryBytes());
+  {
+    thread::ThreadPool pool(Env::Default(), "ngraph_warmup", num_threads);
+    for (auto& job : jobs) {
+      const WarmupJob* job_ptr = job.get();
+      pool.Schedule([job_ptr, &budget]() {
+        budget.Acquire(job_ptr->estimated_bytes);
+        Status status = RunWarmupJob(*job_ptr);
+        budget.Release(job_ptr->estimated_bytes);
+        // The kernel will try again, and report the error, on its first
+        // Compute.
+        if (!status.ok()) {
+          NGRAPH_VLOG(1) << "Could not warm up cluster " << job_ptr->cluster
+                         << ": " << status.error_message();
+        }
+      });
+    }
+    // The pool's destructor waits for all jobs to finish.
+  }
+
+  NGRAPH_VLOG(1) << "Warmup done in "
+                 << std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count()
+                 << "ms";
+  return Status::OK();
+}
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#ifndef NGRAPH_TF_WARMUP_H_
+#define NGRAPH_TF_WARMUP_H_
+
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+//
+// Session warmup. Left to themselves, NGraphEncapsulate kernels translate
+// and compile their clusters on their first Compute, one after another in
+// execution order. WarmUpClusters instead does this ahead of the first step,
+// on a thread pool, for every cluster in "graph" whose input signature can
+// be determined statically: all of its input shapes are fully known and none
+// of its inputs is static (i.e. needs its value for translation). Shapes
+// are propagated through clusters by running shape inference on their
+// bodies.
+//
+// The compiled functions are preloaded into NGraphFunctionRegistry, where
+// the kernels find them on their first Compute. Functions preloaded by an
+// earlier warmup that no kernel has claimed are evicted when the next
+// rewrite warms up (or would, if warmup were enabled).
+//
+// Warmup is off by default. NGRAPH_TF_WARMUP_THREADS enables it, with the
+// given number of threads (at most one per core). NGRAPH_TF_WARMUP_MEMORY_MB
+// (default 1024) caps the sum of the estimated footprints of the clusters
+// being translated at any one time; a cluster larger than the budget is
+// translated on its own.
+//
+Status WarmUpClusters(const Graph& graph);
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
+
+#endif  // NGRAPH_TF_WARMUP_H_
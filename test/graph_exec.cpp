@@ -13,6 +13,8 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  *******************************************************************************/
+#include <chrono>
+
 #include "gtest/gtest.h"
 
 #include "ngraph_builder.h"
@@ -23,6 +25,7 @@
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_constructor.h"
+#include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/platform/env.h"
 
 using namespace std;
@@ -111,6 +114,85 @@ TEST(graph_exec, axpy) {
   // TODO
 }
 
+// Builds a synthetic cluster of "num_layers" layers, each of which adds,
+// multiplies and rectifies the two outputs of the previous one.
+static void BuildLadderCluster(Graph* g, int num_layers) {
+  Node* lhs;
+  Node* rhs;
+  TF_CHECK_OK(NodeBuilder("arg_0", "_Arg")
+                  .Attr("T", DT_FLOAT)
+                  .Attr("index", 0)
+                  .Finalize(g, &lhs));
+  TF_CHECK_OK(NodeBuilder("arg_1", "_Arg")
+                  .Attr("T", DT_FLOAT)
+                  .Attr("index", 1)
+                  .Finalize(g, &rhs));
+
+  for (int i = 0; i < num_layers; i++) {
+    string prefix = "layer_" + to_string(i) + "/";
+    Node* add;
+    Node* mul;
+    TF_CHECK_OK(NodeBuilder(prefix + "add", "Add")
+                    .Input(lhs, 0)
+                    .Input(rhs, 0)
+                    .Attr("T", DT_FLOAT)
+                    .Finalize(g, &add));
+    TF_CHECK_OK(NodeBuilder(prefix + "mul", "Mul")
+                    .Input(lhs, 0)
+                    .Input(rhs, 0)
+                    .Attr("T", DT_FLOAT)
+                    .Finalize(g, &mul));
+    TF_CHECK_OK(NodeBuilder(prefix + "relu", "Relu")
+                    .Input(add, 0)
+                    .Attr("T", DT_FLOAT)
+                    .Finalize(g, &lhs));
+    rhs = mul;
+  }
+
+  Node* retval;
+  TF_CHECK_OK(NodeBuilder("retval_0", "_Retval")
+                  .Input(lhs, 0)
+                  .Attr("T", DT_FLOAT)
+                  .Attr("index", 0)
+                  .Finalize(g, &retval));
+  TF_CHECK_OK(NodeBuilder("retval_1", "_Retval")
+                  .Input(rhs, 0)
+                  .Attr("T", DT_FLOAT)
+                  .Attr("index", 1)
+                  .Finalize(g, &retval));
+  FixupSourceAndSinkEdges(g);
+}
+
+// Measures translation time alone, which is what a cache miss costs before
+// the backend compiles anything.
+TEST(graph_exec, DISABLED_TranslateLargeClusterBenchmark) {
+  const int num_steps = 5;
+  std::vector<TensorShape> inputs{TensorShape({16, 16}),
+                                  TensorShape({16, 16})};
+  std::vector<const Tensor*> static_input_map(2, nullptr);
+
+  for (int num_layers : {1000, 10000, 50000}) {
+    Graph input_graph(OpRegistry::Global());
+    BuildLadderCluster(&input_graph, num_layers);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < num_steps; step++) {
+      shared_ptr<ng::Function> ng_function;
+      ASSERT_EQ(Status::OK(),
+                Builder::TranslateGraph(inputs, static_input_map,
+                                        &input_graph, ng_function));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    LOG(INFO) << "Translated " << input_graph.num_op_nodes() << " nodes in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     end - start)
+                         .count() /
+                     num_steps
+              << "ms";
+  }
+}
+
 }  // namespace testing
 
 }  // namespace ngraph_bridge
@@ -15,6 +15,7 @@
  *******************************************************************************/
 #include "gtest/gtest.h"
 
+#include "ngraph_api.h"
 #include "ngraph_assign_clusters.h"
 #include "ngraph_utils.h"
 #include "tensorflow/core/graph/graph.h"
@@ -154,6 +155,282 @@ TEST(AssignClusters, Cone) {
   ASSERT_NE(node2_cluster, node3_cluster);
 }
 
+// Given a graph of this form:
+//
+//         Node1
+//        /     \
+//       v       v
+//     Node2   Node4
+//       |       |
+//       v       v
+//     Node3   Node5
+//
+// where Node1 is not marked, we want Node2/Node3 and Node4/Node5 to be merged
+// into a single cluster even though there is no edge between them, when
+// horizontal merging is enabled and the clusters are too small to pay for
+// their own dispatch. Otherwise they stay apart.
+static void BuildSiblingClusters(Graph* g, std::vector<Node*>* nodes) {
+  Tensor t(DT_FLOAT, TensorShape{2, 3});
+
+  Node* node1;
+  ASSERT_OK(NodeBuilder("node1", "Const")
+                .Attr("dtype", DT_FLOAT)
+                .Attr("value", t)
+                .Finalize(g, &node1));
+
+  nodes->resize(4);
+  for (int i = 0; i < 2; i++) {
+    ASSERT_OK(NodeBuilder("abs" + std::to_string(i), "Abs")
+                  .Input(node1, 0)
+                  .Attr("T", DT_FLOAT)
+                  .Attr("_ngraph_marked_for_clustering", true)
+                  .Finalize(g, &(*nodes)[2 * i]));
+    ASSERT_OK(NodeBuilder("neg" + std::to_string(i), "Neg")
+                  .Input((*nodes)[2 * i], 0)
+                  .Attr("T", DT_FLOAT)
+                  .Attr("_ngraph_marked_for_clustering", true)
+                  .Finalize(g, &(*nodes)[2 * i + 1]));
+  }
+
+  // The graph is disconnected without these edges
+  g->AddEdge(g->source_node(), Graph::kControlSlot, node1,
+             Graph::kControlSlot);
+  g->AddEdge((*nodes)[1], Graph::kControlSlot, g->sink_node(),
+             Graph::kControlSlot);
+  g->AddEdge((*nodes)[3], Graph::kControlSlot, g->sink_node(),
+             Graph::kControlSlot);
+}
+
+// Runs AssignClusters with horizontal merging and the cost model enabled,
+// with clusters profitable when they do "flops_per_byte" flops per byte
+// crossing their boundary.
+static Status AssignClustersWithHorizontalMerge(Graph* g,
+                                                double flops_per_byte) {
+  double default_flops_per_byte = config::GetMinClusterFlopsPerByte();
+  config::SetMinClusterFlopsPerByte(flops_per_byte);
+  config::EnableHorizontalMerge();
+  config::EnableCostModel();
+  Status status = AssignClusters(g);
+  config::DisableCostModel();
+  config::DisableHorizontalMerge();
+  config::SetMinClusterFlopsPerByte(default_flops_per_byte);
+  return status;
+}
+
+TEST(AssignClusters, HorizontalMerge) {
+  Graph g(OpRegistry::Global());
+  std::vector<Node*> nodes;
+  BuildSiblingClusters(&g, &nodes);
+
+  ASSERT_OK(AssignClustersWithHorizontalMerge(&g, 1e6));
+
+  int first_cluster;
+  ASSERT_OK(GetNodeCluster(nodes[0], &first_cluster));
+  for (auto node : nodes) {
+    int cluster;
+    ASSERT_OK(GetNodeCluster(node, &cluster));
+    ASSERT_EQ(cluster, first_cluster);
+  }
+}
+
+// Test that horizontal merging is off by default.
+TEST(AssignClusters, HorizontalMergeDisabled) {
+  Graph g(OpRegistry::Global());
+  std::vector<Node*> nodes;
+  BuildSiblingClusters(&g, &nodes);
+
+  ASSERT_OK(AssignClusters(&g));
+
+  int cluster0, cluster2;
+  ASSERT_OK(GetNodeCluster(nodes[0], &cluster0));
+  ASSERT_OK(GetNodeCluster(nodes[2], &cluster2));
+  ASSERT_NE(cluster0, cluster2);
+}
+
+// Test that siblings that pay for their own dispatch are not merged, so that
+// they can still run in parallel.
+TEST(AssignClusters, HorizontalMergeKeepsProfitableClusters) {
+  Graph g(OpRegistry::Global());
+  std::vector<Node*> nodes;
+  BuildSiblingClusters(&g, &nodes);
+
+  ASSERT_OK(AssignClustersWithHorizontalMerge(&g, 0));
+
+  int cluster0, cluster2;
+  ASSERT_OK(GetNodeCluster(nodes[0], &cluster0));
+  ASSERT_OK(GetNodeCluster(nodes[2], &cluster2));
+  ASSERT_NE(cluster0, cluster2);
+}
+
+// Same as above, but with an unmarked node on a path from Node3 to Node4, so
+// that merging the two clusters would create a cycle.
+TEST(AssignClusters, HorizontalMergeNoCycle) {
+  Graph g(OpRegistry::Global());
+
+  Tensor t(DT_FLOAT, TensorShape{2, 3});
+
+  Node* node1;
+  ASSERT_OK(NodeBuilder("node1", "Const")
+                .Attr("dtype", DT_FLOAT)
+                .Attr("value", t)
+                .Finalize(&g, &node1));
+
+  Node* node2;
+  ASSERT_OK(NodeBuilder("node2", "Abs")
+                .Input(node1, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("_ngraph_marked_for_clustering", true)
+                .Finalize(&g, &node2));
+
+  Node* unmarked;
+  ASSERT_OK(NodeBuilder("unmarked", "Neg")
+                .Input(node2, 0)
+                .Attr("T", DT_FLOAT)
+                .Finalize(&g, &unmarked));
+
+  Node* node4;
+  ASSERT_OK(NodeBuilder("node4", "Add")
+                .Input(node1, 0)
+                .Input(unmarked, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("_ngraph_marked_for_clustering", true)
+                .Finalize(&g, &node4));
+
+  // The graph is disconnected without these edges
+  g.AddEdge(g.source_node(), Graph::kControlSlot, node1, Graph::kControlSlot);
+  g.AddEdge(node4, Graph::kControlSlot, g.sink_node(), Graph::kControlSlot);
+
+  ASSERT_OK(AssignClustersWithHorizontalMerge(&g, 1e6));
+
+  int node2_cluster, node4_cluster;
+  ASSERT_OK(GetNodeCluster(node2, &node2_cluster));
+  ASSERT_OK(GetNodeCluster(node4, &node4_cluster));
+  ASSERT_NE(node2_cluster, node4_cluster);
+}
+
+// Test that with a cluster size limit, a chain of four marked nodes
+//
+//   Const -> Abs0 -> Abs1 -> Abs2 -> Abs3
+//
+// is split into two clusters of two nodes each.
+TEST(AssignClusters, SplitOversizedCluster) {
+  Graph g(OpRegistry::Global());
+
+  Tensor t(DT_FLOAT, TensorShape{2, 3});
+
+  Node* node1;
+  ASSERT_OK(NodeBuilder("node1", "Const")
+                .Attr("dtype", DT_FLOAT)
+                .Attr("value", t)
+                .Finalize(&g, &node1));
+
+  std::vector<Node*> nodes(4);
+  Node* input = node1;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_OK(NodeBuilder("abs" + std::to_string(i), "Abs")
+                  .Input(input, 0)
+                  .Attr("T", DT_FLOAT)
+                  .Attr("_ngraph_marked_for_clustering", true)
+                  .Finalize(&g, &nodes[i]));
+    input = nodes[i];
+  }
+
+  // The graph is disconnected without these edges
+  g.AddEdge(g.source_node(), Graph::kControlSlot, node1, Graph::kControlSlot);
+  g.AddEdge(nodes[3], Graph::kControlSlot, g.sink_node(), Graph::kControlSlot);
+
+  config::SetMaxClusterSize(2);
+  Status status = AssignClusters(&g);
+  config::SetMaxClusterSize(0);
+  ASSERT_OK(status);
+
+  std::vector<int> clusters(4);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_OK(GetNodeCluster(nodes[i], &clusters[i]));
+  }
+  ASSERT_EQ(clusters[0], clusters[1]);
+  ASSERT_EQ(clusters[2], clusters[3]);
+  ASSERT_NE(clusters[1], clusters[2]);
+}
+
+// Test that splitting keeps a sunk static input with its consumer. In
+//
+//   Const -> Abs0 -> Abs1 -> Reshape -> Abs2
+//              \              ^*
+//               --> Shape ----
+//
+// the Shape is a copy made by SinkStaticInputs, and it must stay in the
+// cluster of the Reshape for its value to be folded.
+TEST(AssignClusters, SplitKeepsSunkStaticInput) {
+  Graph g(OpRegistry::Global());
+
+  Tensor t(DT_FLOAT, TensorShape{2, 3});
+
+  Node* node1;
+  ASSERT_OK(NodeBuilder("node1", "Const")
+                .Attr("dtype", DT_FLOAT)
+                .Attr("value", t)
+                .Finalize(&g, &node1));
+
+  Node* abs0;
+  ASSERT_OK(NodeBuilder("abs0", "Abs")
+                .Input(node1, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("_ngraph_marked_for_clustering", true)
+                .Finalize(&g, &abs0));
+
+  Node* shape;
+  ASSERT_OK(NodeBuilder("shape", "Shape")
+                .Input(abs0, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("out_type", DT_INT32)
+                .Attr("_ngraph_marked_for_clustering", true)
+                .Attr("_ngraph_sunk_static_input", true)
+                .Finalize(&g, &shape));
+
+  Node* abs1;
+  ASSERT_OK(NodeBuilder("abs1", "Abs")
+                .Input(abs0, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("_ngraph_marked_for_clustering", true)
+                .Finalize(&g, &abs1));
+
+  Node* reshape;
+  ASSERT_OK(NodeBuilder("reshape", "Reshape")
+                .Input(abs1, 0)
+                .Input(shape, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("Tshape", DT_INT32)
+                .Attr("_ngraph_marked_for_clustering", true)
+                .Attr("_ngraph_static_inputs", std::vector<int32>{1})
+                .Finalize(&g, &reshape));
+
+  Node* abs2;
+  ASSERT_OK(NodeBuilder("abs2", "Abs")
+                .Input(reshape, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("_ngraph_marked_for_clustering", true)
+                .Finalize(&g, &abs2));
+
+  // The graph is disconnected without these edges
+  g.AddEdge(g.source_node(), Graph::kControlSlot, node1, Graph::kControlSlot);
+  g.AddEdge(abs2, Graph::kControlSlot, g.sink_node(), Graph::kControlSlot);
+
+  config::SetMaxClusterSize(2);
+  Status status = AssignClusters(&g);
+  config::SetMaxClusterSize(0);
+  ASSERT_OK(status);
+
+  int abs0_cluster, shape_cluster, reshape_cluster, abs2_cluster;
+  ASSERT_OK(GetNodeCluster(abs0, &abs0_cluster));
+  ASSERT_OK(GetNodeCluster(shape, &shape_cluster));
+  ASSERT_OK(GetNodeCluster(reshape, &reshape_cluster));
+  ASSERT_OK(GetNodeCluster(abs2, &abs2_cluster));
+  ASSERT_NE(abs0_cluster, abs2_cluster) << "The cluster was not split";
+  ASSERT_EQ(shape_cluster, reshape_cluster)
+      << "The sunk Shape was split from its consumer";
+}
+
 }  // namespace testing
 
 }  // namespace ngraph_bridge
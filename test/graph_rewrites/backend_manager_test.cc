@@ -22,7 +22,9 @@
 
 #include "tensorflow/cc/client/client_session.h"
 #include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/public/session.h"
 #include "tf_graph_writer.h"
 
@@ -180,6 +182,53 @@ TEST(BackendManager, BackendRun) {
                               &inter_outputs));
 }
 
+// Test that a rewrite memoized for one backend is not reused for another
+TEST(BackendManager, BackendRewriteCache) {
+  Scope root = Scope::NewRootScope();
+  auto A = ops::Placeholder(root.WithOpName("A"), DT_FLOAT);
+  auto B = ops::Placeholder(root.WithOpName("B"), DT_FLOAT);
+  auto R = ops::Add(root.WithOpName("R"), A, B);
+  auto S = ops::Sub(root.WithOpName("S"), R, B);
+
+  GraphDef graph_def;
+  TF_CHECK_OK(root.ToGraphDef(&graph_def));
+
+  // Runs the encapsulation pass on a fresh copy of the same graph and
+  // returns the backend of the (single) resulting cluster.
+  auto rewrite = [&graph_def](string* backend) {
+    std::unique_ptr<Graph> graph(new Graph(OpRegistry::Global()));
+    TF_CHECK_OK(ConvertGraphDefToGraph(GraphConstructorOptions(), graph_def,
+                                       graph.get()));
+    for (auto node : graph->op_nodes()) {
+      node->set_assigned_device_name(
+          "/job:localhost/replica:0/task:0/device:CPU:0");
+    }
+
+    GraphOptimizationPassOptions options;
+    options.graph = &graph;
+    TF_CHECK_OK(OptimizationPassRegistry::Global()->RunGrouping(
+        OptimizationPassRegistry::POST_REWRITE_FOR_EXEC, options));
+
+    int num_clusters = 0;
+    for (auto node : graph->op_nodes()) {
+      if (node->type_string() == "NGraphEncapsulate") {
+        TF_CHECK_OK(GetNodeAttr(node->attrs(), "_ngraph_backend", backend));
+        num_clusters++;
+      }
+    }
+    ASSERT_EQ(num_clusters, 1);
+  };
+
+  string backend;
+  ASSERT_OK(BackendManager::SetBackendName("INTERPRETER"));
+  rewrite(&backend);
+  ASSERT_EQ(backend, "INTERPRETER");
+
+  ASSERT_OK(BackendManager::SetBackendName("CPU"));
+  rewrite(&backend);
+  ASSERT_EQ(backend, "CPU");
+}
+
 }  // namespace testing
 }  // namespace ngraph_bridge
 }  // namespace tensorflow
\ No newline at end of file
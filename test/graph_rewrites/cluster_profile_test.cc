@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdio>
+
+#include "gtest/gtest.h"
+
+#include "ngraph_api.h"
+#include "ngraph_assign_clusters.h"
+#include "ngraph_cluster_profile.h"
+#include "ngraph_deassign_clusters.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+TEST(ClusterProfile, KeyIgnoresNodeOrder) {
+  ASSERT_EQ(NGraphClusterProfile::ComputeKey({"a", "b", "c"}),
+            NGraphClusterProfile::ComputeKey({"c", "a", "b"}));
+  ASSERT_NE(NGraphClusterProfile::ComputeKey({"a", "b"}),
+            NGraphClusterProfile::ComputeKey({"a", "b", "c"}));
+}
+
+TEST(ClusterProfile, SaveAndLoad) {
+  string fast_key = NGraphClusterProfile::ComputeKey({"fast_1", "fast_2"});
+  string slow_key = NGraphClusterProfile::ComputeKey({"slow_1", "slow_2"});
+
+  NGraphClusterProfile::RecordStep(fast_key, 10, 40, 2);
+  NGraphClusterProfile::RecordStep(fast_key, 10, 40, 2);
+  NGraphClusterProfile::RecordStep(slow_key, 30, 20, 15);
+
+  string path = "test_cluster_profile.txt";
+  ASSERT_OK(NGraphClusterProfile::Save(path));
+
+  // Start from an empty profile, so that what we check below was parsed.
+  NGraphClusterProfile::Clear();
+  ClusterProfileEntry entry;
+  ASSERT_FALSE(NGraphClusterProfile::Lookup(fast_key, &entry));
+
+  ASSERT_OK(NGraphClusterProfile::Load(path));
+  std::remove(path.c_str());
+
+  ASSERT_TRUE(NGraphClusterProfile::Lookup(fast_key, &entry));
+  ASSERT_EQ(entry.steps, 2);
+  ASSERT_EQ(entry.ngraph_us, 20);
+  ASSERT_EQ(entry.tf_us, 80);
+
+  ASSERT_FALSE(NGraphClusterProfile::IsSlowerThanTF(fast_key));
+  ASSERT_TRUE(NGraphClusterProfile::IsSlowerThanTF(slow_key));
+  ASSERT_FALSE(NGraphClusterProfile::IsSlowerThanTF(
+      NGraphClusterProfile::ComputeKey({"never_recorded"})));
+
+  NGraphClusterProfile::Clear();
+}
+
+// A cluster measured slower than TF (counting its transfers) is deassigned,
+// the other one is kept.
+TEST(ClusterProfile, DeassignSlowerCluster) {
+  Graph g(OpRegistry::Global());
+
+  Tensor t(DT_FLOAT, TensorShape{2, 3});
+  Node* input;
+  ASSERT_OK(NodeBuilder("input", "Const")
+                .Attr("dtype", DT_FLOAT)
+                .Attr("value", t)
+                .Finalize(&g, &input));
+
+  std::vector<std::vector<Node*>> clusters(2);
+  for (int i = 0; i < 2; i++) {
+    string prefix = (i == 0 ? "fast" : "slow");
+    Node* abs;
+    ASSERT_OK(NodeBuilder(prefix + "_abs", "Abs")
+                  .Input(input, 0)
+                  .Attr("T", DT_FLOAT)
+                  .Attr("_ngraph_marked_for_clustering", true)
+                  .Attr("_ngraph_cluster", i)
+                  .Finalize(&g, &abs));
+    Node* neg;
+    ASSERT_OK(NodeBuilder(prefix + "_neg", "Neg")
+                  .Input(abs, 0)
+                  .Attr("T", DT_FLOAT)
+                  .Attr("_ngraph_marked_for_clustering", true)
+                  .Attr("_ngraph_cluster", i)
+                  .Finalize(&g, &neg));
+    clusters[i] = {abs, neg};
+  }
+
+  // The slow cluster is faster than TF, but not once its transfers are
+  // counted.
+  NGraphClusterProfile::RecordStep(
+      NGraphClusterProfile::ComputeKey({"fast_abs", "fast_neg"}), 10, 40, 2);
+  NGraphClusterProfile::RecordStep(
+      NGraphClusterProfile::ComputeKey({"slow_abs", "slow_neg"}), 10, 20, 15);
+  string path = "test_deassign_profile.txt";
+  ASSERT_OK(NGraphClusterProfile::Save(path));
+  NGraphClusterProfile::Clear();
+
+  config::SetClusterProfilePath(path);
+  Status status = DeassignClusters(&g);
+  config::SetClusterProfilePath("");
+  NGraphClusterProfile::Clear();
+  std::remove(path.c_str());
+  ASSERT_OK(status);
+
+  int cluster;
+  for (auto node : clusters[0]) {
+    ASSERT_OK(GetNodeCluster(node, &cluster));
+    ASSERT_EQ(cluster, 0);
+  }
+  for (auto node : clusters[1]) {
+    ASSERT_NE(GetNodeCluster(node, &cluster), Status::OK());
+  }
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_cluster_manager.h"
+#include "ngraph_const_store.h"
+#include "ngraph_utils.h"
+
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+static NodeDef MakeConstDef(const string& name, const TensorShape& shape,
+                            float step = 0.5f) {
+  Tensor value(DT_FLOAT, shape);
+  auto flat = value.flat<float>();
+  for (int i = 0; i < flat.size(); i++) {
+    flat(i) = step * i;
+  }
+
+  Graph g(OpRegistry::Global());
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(name, "Const")
+                  .Attr("dtype", DT_FLOAT)
+                  .Attr("value", value)
+                  .Finalize(&g, &node));
+  return node->def();
+}
+
+TEST(ConstStore, ExternalizeLargeConst) {
+  // 2MiB, above the default threshold.
+  TensorShape shape({512, 1024});
+  NodeDef def_a = MakeConstDef("a", shape);
+  NodeDef def_b = MakeConstDef("b", shape);
+
+  ASSERT_OK(NGraphConstStore::Externalize(&def_a));
+  ASSERT_OK(NGraphConstStore::Externalize(&def_b));
+  ASSERT_TRUE(NGraphConstStore::IsExternalized(def_a));
+
+  // Only the dtype and shape stay in the NodeDef.
+  const TensorProto& proto = def_a.attr().at("value").tensor();
+  ASSERT_EQ(proto.tensor_content().size(), 0);
+  ASSERT_EQ(TensorShape(proto.tensor_shape()), shape);
+
+  Tensor value_a, value_b;
+  ASSERT_TRUE(NGraphConstStore::Lookup(def_a, &value_a));
+  ASSERT_TRUE(NGraphConstStore::Lookup(def_b, &value_b));
+  ASSERT_EQ(value_a.shape(), shape);
+  ASSERT_EQ(value_a.flat<float>()(3), 1.5f);
+  // Identical values are stored once.
+  ASSERT_EQ(value_a.tensor_data().data(), value_b.tensor_data().data());
+
+  GraphDef graph_def;
+  *graph_def.add_node() = def_a;
+  ASSERT_OK(NGraphConstStore::Internalize(&graph_def));
+  ASSERT_FALSE(NGraphConstStore::IsExternalized(graph_def.node(0)));
+  Tensor restored;
+  ASSERT_TRUE(
+      restored.FromProto(graph_def.node(0).attr().at("value").tensor()));
+  ASSERT_EQ(restored.tensor_data(), value_a.tensor_data());
+}
+
+TEST(ConstStore, KeepSmallConst) {
+  NodeDef def = MakeConstDef("small", TensorShape({4, 4}));
+  ASSERT_OK(NGraphConstStore::Externalize(&def));
+  ASSERT_FALSE(NGraphConstStore::IsExternalized(def));
+
+  Tensor value;
+  ASSERT_FALSE(NGraphConstStore::Lookup(def, &value));
+}
+
+TEST(ConstStore, ReleaseUnreferencedValue) {
+  // A value of its own, not shared with the other tests.
+  NodeDef def = MakeConstDef("released", TensorShape({512, 1024}), 0.25f);
+  GraphDef graph_def;
+  NodeDef* node_def = graph_def.add_node();
+  *node_def = def;
+  // Takes the reference owned by "graph_def".
+  ASSERT_OK(NGraphConstStore::Externalize(node_def));
+  ASSERT_TRUE(NGraphConstStore::IsExternalized(*node_def));
+
+  // Two kernels for the same cluster.
+  ASSERT_OK(NGraphConstStore::Acquire(graph_def));
+  ASSERT_OK(NGraphConstStore::Acquire(graph_def));
+
+  Tensor value;
+  NGraphConstStore::Release(graph_def);
+  NGraphConstStore::Release(graph_def);
+  ASSERT_TRUE(NGraphConstStore::Lookup(*node_def, &value));
+
+  // Releasing the graph itself drops the last reference.
+  NGraphConstStore::Release(graph_def);
+  ASSERT_FALSE(NGraphConstStore::Lookup(*node_def, &value));
+  ASSERT_NE(NGraphConstStore::Acquire(graph_def), Status::OK());
+
+  // The Tensor we got before the release keeps its buffer alive.
+  ASSERT_EQ(value.shape(), TensorShape({512, 1024}));
+}
+
+TEST(ConstStore, SharedValueOutlivesOtherCluster) {
+  // Two cluster graphs with identical weights share one value.
+  NodeDef def = MakeConstDef("shared", TensorShape({512, 1024}), 0.125f);
+  GraphDef graph_x, graph_y;
+  *graph_x.add_node() = def;
+  *graph_y.add_node() = def;
+  ASSERT_OK(NGraphConstStore::Externalize(graph_x.mutable_node(0)));
+  ASSERT_OK(NGraphConstStore::Externalize(graph_y.mutable_node(0)));
+
+  // Cluster X's kernel comes and goes before cluster Y's is created.
+  ASSERT_OK(NGraphConstStore::Acquire(graph_x));
+  NGraphConstStore::Release(graph_x);
+  ASSERT_OK(NGraphConstStore::Acquire(graph_y));
+  NGraphConstStore::Release(graph_y);
+
+  // Y's graph still refers to the value after X's is released.
+  Tensor value;
+  NGraphConstStore::Release(graph_x);
+  ASSERT_TRUE(NGraphConstStore::Lookup(graph_y.node(0), &value));
+  NGraphConstStore::Release(graph_y);
+  ASSERT_FALSE(NGraphConstStore::Lookup(graph_y.node(0), &value));
+}
+
+TEST(ConstStore, AcquireUnknownValue) {
+  NodeDef def = MakeConstDef("unknown", TensorShape({512, 1024}), 0.75f);
+  GraphDef graph_def;
+  *graph_def.add_node() = def;
+  ASSERT_OK(NGraphConstStore::Externalize(graph_def.mutable_node(0)));
+  NGraphConstStore::Release(graph_def);
+
+  ASSERT_NE(NGraphConstStore::Acquire(graph_def), Status::OK());
+}
+
+TEST(ConstStore, ReleaseClusterGraph) {
+  int cluster_idx = NGraphClusterManager::NewCluster();
+  GraphDef* graph_def = NGraphClusterManager::GetClusterGraph(cluster_idx);
+  NodeDef* node_def = graph_def->add_node();
+  *node_def = MakeConstDef("cluster", TensorShape({512, 1024}), 0.375f);
+  ASSERT_OK(NGraphConstStore::Externalize(node_def));
+  NodeDef externalized = *node_def;
+
+  Tensor value;
+  ASSERT_TRUE(NGraphConstStore::Lookup(externalized, &value));
+  NGraphClusterManager::ReleaseClusterGraph(cluster_idx);
+  ASSERT_FALSE(NGraphConstStore::Lookup(externalized, &value));
+  ASSERT_EQ(graph_def->node_size(), 0);
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
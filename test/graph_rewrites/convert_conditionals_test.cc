@@ -0,0 +1,175 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_convert_conditionals.h"
+#include "ngraph_mark_for_clustering.h"
+#include "ngraph_utils.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/graph/graph.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+// out = sqrt(pred ? abs(x) : neg(x))
+static void BuildConditional(Graph* graph) {
+  Scope root = Scope::NewRootScope();
+  auto pred = ops::Placeholder(root.WithOpName("pred"), DT_BOOL);
+  auto x = ops::Const(root.WithOpName("x"), {1.0f, -2.0f});
+  auto sw = ops::Switch(root.WithOpName("switch"), x, pred);
+  auto f = ops::Neg(root.WithOpName("f"), sw.output_false);
+  auto t = ops::Abs(root.WithOpName("t"), sw.output_true);
+  auto merge = ops::Merge(root.WithOpName("merge"), {f, t});
+  ops::Sqrt(root.WithOpName("out"), merge.output);
+  TF_CHECK_OK(root.ToGraph(graph));
+}
+
+static int CountControlFlow(const Graph& graph) {
+  int count = 0;
+  for (auto node : graph.op_nodes()) {
+    if (node->IsControlFlow()) count++;
+  }
+  return count;
+}
+
+TEST(ConvertConditionals, SmallBranches) {
+  Graph graph(OpRegistry::Global());
+  BuildConditional(&graph);
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(ConvertConditionalsToSelect(&graph));
+
+  ASSERT_EQ(CountControlFlow(graph), 0);
+
+  Node* select = nullptr;
+  for (auto node : graph.op_nodes()) {
+    if (node->name() == "merge") select = node;
+  }
+  ASSERT_NE(select, nullptr);
+  ASSERT_EQ(select->type_string(), "Select");
+  ASSERT_TRUE(NodeIsMarkedForClustering(select));
+
+  Node* input;
+  ASSERT_OK(select->input_node(0, &input));
+  ASSERT_EQ(input->name(), "pred");
+  ASSERT_OK(select->input_node(1, &input));
+  ASSERT_EQ(input->name(), "t");
+  ASSERT_OK(select->input_node(2, &input));
+  ASSERT_EQ(input->name(), "f");
+
+  // Both branches now read x directly.
+  for (auto node : graph.op_nodes()) {
+    if (node->name() == "t" || node->name() == "f") {
+      ASSERT_OK(node->input_node(0, &input));
+      ASSERT_EQ(input->name(), "x");
+    }
+  }
+}
+
+TEST(ConvertConditionals, ExpensiveBranches) {
+  setenv("NGRAPH_TF_MAX_SPECULATED_FLOPS", "1", 1);
+
+  Graph graph(OpRegistry::Global());
+  BuildConditional(&graph);
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(ConvertConditionalsToSelect(&graph));
+  ASSERT_EQ(CountControlFlow(graph), 2);
+
+  unsetenv("NGRAPH_TF_MAX_SPECULATED_FLOPS");
+}
+
+TEST(ConvertConditionals, UnsupportedBranch) {
+  Graph graph(OpRegistry::Global());
+  BuildConditional(&graph);
+  ASSERT_OK(MarkForClustering(&graph));
+  for (auto node : graph.op_nodes()) {
+    if (node->name() == "f") {
+      node->AddAttr("_ngraph_marked_for_clustering", false);
+    }
+  }
+  ASSERT_OK(ConvertConditionalsToSelect(&graph));
+  ASSERT_EQ(CountControlFlow(graph), 2);
+}
+
+TEST(ConvertConditionals, DifferentShapes) {
+  // out = sqrt(pred ? x + [[1, 1], [1, 1]] : neg(x)); the true branch
+  // broadcasts to 2x2, the false one stays a vector.
+  Scope root = Scope::NewRootScope();
+  auto pred = ops::Placeholder(root.WithOpName("pred"), DT_BOOL);
+  auto x = ops::Const(root.WithOpName("x"), {1.0f, -2.0f});
+  auto sw = ops::Switch(root.WithOpName("switch"), x, pred);
+  auto f = ops::Neg(root.WithOpName("f"), sw.output_false);
+  auto ones = ops::Const(root.WithOpName("ones"), {{1.0f, 1.0f}, {1.0f, 1.0f}});
+  auto t = ops::Add(root.WithOpName("t"), sw.output_true, ones);
+  auto merge = ops::Merge(root.WithOpName("merge"), {f, t});
+  ops::Sqrt(root.WithOpName("out"), merge.output);
+
+  Graph graph(OpRegistry::Global());
+  TF_CHECK_OK(root.ToGraph(&graph));
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(ConvertConditionalsToSelect(&graph));
+  ASSERT_EQ(CountControlFlow(graph), 2);
+}
+
+TEST(ConvertConditionals, UnknownShapes) {
+  Scope root = Scope::NewRootScope();
+  auto pred = ops::Placeholder(root.WithOpName("pred"), DT_BOOL);
+  auto x = ops::Placeholder(root.WithOpName("x"), DT_FLOAT);
+  auto sw = ops::Switch(root.WithOpName("switch"), x, pred);
+  auto f = ops::Neg(root.WithOpName("f"), sw.output_false);
+  auto t = ops::Abs(root.WithOpName("t"), sw.output_true);
+  auto merge = ops::Merge(root.WithOpName("merge"), {f, t});
+  ops::Sqrt(root.WithOpName("out"), merge.output);
+
+  Graph graph(OpRegistry::Global());
+  TF_CHECK_OK(root.ToGraph(&graph));
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(ConvertConditionalsToSelect(&graph));
+  ASSERT_EQ(CountControlFlow(graph), 2);
+}
+
+TEST(ConvertConditionals, BranchMayFail) {
+  // out = pred ? -x : x // y; the integer division fails on the zero in y,
+  // so it must not run unless its branch is taken.
+  Scope root = Scope::NewRootScope();
+  auto pred = ops::Placeholder(root.WithOpName("pred"), DT_BOOL);
+  auto x = ops::Const(root.WithOpName("x"), {4, 6});
+  auto y = ops::Const(root.WithOpName("y"), {2, 0});
+  auto sw = ops::Switch(root.WithOpName("switch"), x, pred);
+  auto f = ops::FloorDiv(root.WithOpName("f"), sw.output_false, y);
+  auto t = ops::Neg(root.WithOpName("t"), sw.output_true);
+  auto merge = ops::Merge(root.WithOpName("merge"), {f, t});
+  ops::Identity(root.WithOpName("out"), merge.output);
+
+  Graph graph(OpRegistry::Global());
+  TF_CHECK_OK(root.ToGraph(&graph));
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(ConvertConditionalsToSelect(&graph));
+  ASSERT_EQ(CountControlFlow(graph), 2);
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_api.h"
+#include "ngraph_cost_model.h"
+#include "ngraph_utils.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+// Builds Const(2x3) and Const(3x4) feeding a MatMul, followed by a Relu.
+static void BuildMatMulGraph(Graph* g, Node** matmul, Node** relu) {
+  Tensor t_a(DT_FLOAT, TensorShape{2, 3});
+  Tensor t_b(DT_FLOAT, TensorShape{3, 4});
+
+  Node* node_a;
+  ASSERT_OK(NodeBuilder("a", "Const")
+                .Attr("dtype", DT_FLOAT)
+                .Attr("value", t_a)
+                .Finalize(g, &node_a));
+
+  Node* node_b;
+  ASSERT_OK(NodeBuilder("b", "Const")
+                .Attr("dtype", DT_FLOAT)
+                .Attr("value", t_b)
+                .Finalize(g, &node_b));
+
+  ASSERT_OK(NodeBuilder("matmul", "MatMul")
+                .Input(node_a, 0)
+                .Input(node_b, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("transpose_a", false)
+                .Attr("transpose_b", false)
+                .Finalize(g, matmul));
+
+  ASSERT_OK(NodeBuilder("relu", "Relu")
+                .Input(*matmul, 0)
+                .Attr("T", DT_FLOAT)
+                .Finalize(g, relu));
+
+  // The graph is disconnected without these edges
+  g->AddEdge(g->source_node(), Graph::kControlSlot, node_a,
+             Graph::kControlSlot);
+  g->AddEdge(g->source_node(), Graph::kControlSlot, node_b,
+             Graph::kControlSlot);
+  g->AddEdge(*relu, Graph::kControlSlot, g->sink_node(), Graph::kControlSlot);
+}
+
+TEST(CostModel, MatMulFlopsAndBytes) {
+  Graph g(OpRegistry::Global());
+  Node* matmul;
+  Node* relu;
+  BuildMatMulGraph(&g, &matmul, &relu);
+
+  std::unique_ptr<NGraphCostModel> cost_model;
+  ASSERT_OK(NGraphCostModel::Build(g, &cost_model));
+
+  // 2 * M * N * K
+  ASSERT_EQ(cost_model->GetNodeCost(matmul).flops, 2 * 2 * 4 * 3);
+  // Reads 2x3 and 3x4 floats, writes 2x4 floats.
+  ASSERT_EQ(cost_model->GetNodeCost(matmul).bytes, (6 + 12 + 8) * 4);
+  ASSERT_EQ(cost_model->GetNodeCost(relu).flops, 8);
+
+  for (auto edge : relu->in_edges()) {
+    if (!edge->IsControlEdge()) {
+      ASSERT_EQ(cost_model->GetEdgeBytes(edge), 8 * 4);
+    }
+  }
+}
+
+TEST(CostModel, ClusterCost) {
+  Graph g(OpRegistry::Global());
+  Node* matmul;
+  Node* relu;
+  BuildMatMulGraph(&g, &matmul, &relu);
+
+  std::unique_ptr<NGraphCostModel> cost_model;
+  ASSERT_OK(NGraphCostModel::Build(g, &cost_model));
+
+  // The Relu alone moves its input and output across the boundary.
+  ClusterCost relu_cost = cost_model->ComputeClusterCost({relu});
+  ASSERT_EQ(relu_cost.flops, 8);
+  ASSERT_EQ(relu_cost.boundary_bytes, 8 * 4);
+
+  // MatMul + Relu: the intermediate tensor stays inside the cluster, and the
+  // Relu output has no consumers.
+  ClusterCost cluster_cost = cost_model->ComputeClusterCost({matmul, relu});
+  ASSERT_EQ(cluster_cost.flops, 2 * 2 * 4 * 3 + 8);
+  ASSERT_EQ(cluster_cost.boundary_bytes, (6 + 12) * 4);
+
+  double saved = config::GetMinClusterFlopsPerByte();
+  config::SetMinClusterFlopsPerByte(1.0);
+  ASSERT_FALSE(NGraphCostModel::ClusterIsProfitable(cluster_cost));
+  config::SetMinClusterFlopsPerByte(0.5);
+  ASSERT_TRUE(NGraphCostModel::ClusterIsProfitable(cluster_cost));
+  config::SetMinClusterFlopsPerByte(saved);
+}
+
+TEST(CostModel, RegisterOpCostFunction) {
+  Graph g(OpRegistry::Global());
+  Node* matmul;
+  Node* relu;
+  BuildMatMulGraph(&g, &matmul, &relu);
+
+  OpCostFunction previous = NGraphCostModel::RegisterOpCostFunction(
+      "Relu", [](const Node*, const std::vector<TensorShape>&,
+                 const std::vector<TensorShape>&) { return OpCost(1000, 0); });
+
+  std::unique_ptr<NGraphCostModel> cost_model;
+  Status status = NGraphCostModel::Build(g, &cost_model);
+
+  // The registry is process-wide; put back what the other tests expect.
+  NGraphCostModel::RegisterOpCostFunction("Relu", previous);
+
+  ASSERT_OK(status);
+  ASSERT_EQ(cost_model->GetNodeCost(relu).flops, 1000);
+
+  ASSERT_OK(NGraphCostModel::Build(g, &cost_model));
+  ASSERT_EQ(cost_model->GetNodeCost(relu).flops, 8);
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
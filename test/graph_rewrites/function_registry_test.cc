@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_freshness_tracker.h"
+#include "ngraph_function_registry.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+
+using namespace std;
+namespace ng = ngraph;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+// Builds _Arg -> <op_type> -> _Retval, with node names starting with
+// "prefix" and the given cluster index.
+static void BuildCluster(Graph* g, const string& prefix, const string& op_type,
+                         int cluster) {
+  Node* arg;
+  ASSERT_OK(NodeBuilder(prefix + "arg", "_Arg")
+                .Attr("T", DT_FLOAT)
+                .Attr("index", 0)
+                .Attr("_ngraph_cluster", cluster)
+                .Finalize(g, &arg));
+
+  Node* op;
+  ASSERT_OK(NodeBuilder(prefix + "op", op_type)
+                .Input(arg, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("_ngraph_cluster", cluster)
+                .Finalize(g, &op));
+
+  Node* retval;
+  ASSERT_OK(NodeBuilder(prefix + "retval", "_Retval")
+                .Input(op, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("index", 0)
+                .Attr("_ngraph_cluster", cluster)
+                .Finalize(g, &retval));
+
+  // The graph is disconnected without these edges
+  g->AddEdge(g->source_node(), Graph::kControlSlot, arg, Graph::kControlSlot);
+  g->AddEdge(retval, Graph::kControlSlot, g->sink_node(), Graph::kControlSlot);
+}
+
+TEST(FunctionRegistry, CanonicalHashIgnoresNames) {
+  Graph g1(OpRegistry::Global());
+  BuildCluster(&g1, "tower_0/", "Relu", 0);
+  Graph g2(OpRegistry::Global());
+  BuildCluster(&g2, "tower_1/", "Relu", 1);
+  Graph g3(OpRegistry::Global());
+  BuildCluster(&g3, "tower_0/", "Tanh", 0);
+
+  ASSERT_EQ(NGraphFunctionRegistry::CanonicalGraphHash(g1),
+            NGraphFunctionRegistry::CanonicalGraphHash(g2));
+  ASSERT_NE(NGraphFunctionRegistry::CanonicalGraphHash(g1),
+            NGraphFunctionRegistry::CanonicalGraphHash(g3));
+}
+
+TEST(FunctionRegistry, RefCounting) {
+  auto param = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2});
+  auto f1 = make_shared<ng::Function>(param, ng::ParameterVector{param});
+  auto f2 = make_shared<ng::Function>(param, ng::ParameterVector{param});
+
+  ASSERT_EQ(NGraphFunctionRegistry::Acquire("key"), nullptr);
+  ASSERT_EQ(NGraphFunctionRegistry::Register("key", f1), f1);
+  // A concurrent translation loses to the function registered first.
+  ASSERT_EQ(NGraphFunctionRegistry::Register("key", f2), f1);
+  ASSERT_EQ(NGraphFunctionRegistry::Acquire("key"), f1);
+
+  ASSERT_EQ(NGraphFunctionRegistry::ExchangeLastUser("key", &f1), nullptr);
+  ASSERT_EQ(NGraphFunctionRegistry::ExchangeLastUser("key", &f2), &f1);
+
+  ASSERT_EQ(NGraphFunctionRegistry::Release("key"), nullptr);
+  ASSERT_EQ(NGraphFunctionRegistry::Release("key"), nullptr);
+  ASSERT_EQ(NGraphFunctionRegistry::Release("key"), f1);
+  ASSERT_EQ(NGraphFunctionRegistry::Acquire("key"), nullptr);
+}
+
+TEST(FunctionRegistry, Preload) {
+  auto param = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2});
+  auto f1 = make_shared<ng::Function>(param, ng::ParameterVector{param});
+  auto f2 = make_shared<ng::Function>(param, ng::ParameterVector{param});
+
+  ASSERT_TRUE(NGraphFunctionRegistry::Preload("warm", "CPU", f1));
+  ASSERT_FALSE(NGraphFunctionRegistry::Preload("warm", "CPU", f2));
+  ASSERT_TRUE(NGraphFunctionRegistry::Contains("warm"));
+
+  // The first kernel to acquire a preloaded function holds its only
+  // reference.
+  ASSERT_EQ(NGraphFunctionRegistry::Acquire("warm"), f1);
+  ASSERT_EQ(NGraphFunctionRegistry::Release("warm"), f1);
+  ASSERT_FALSE(NGraphFunctionRegistry::Contains("warm"));
+}
+
+TEST(FunctionRegistry, EvictPreloads) {
+  auto param = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2});
+  auto f1 = make_shared<ng::Function>(param, ng::ParameterVector{param});
+  auto f2 = make_shared<ng::Function>(param, ng::ParameterVector{param});
+  auto f3 = make_shared<ng::Function>(param, ng::ParameterVector{param});
+
+  ASSERT_TRUE(NGraphFunctionRegistry::Preload("acquired", "CPU", f1));
+  ASSERT_TRUE(NGraphFunctionRegistry::Preload("kept", "CPU", f2));
+  ASSERT_TRUE(NGraphFunctionRegistry::Preload("unused", "INTERPRETER", f3));
+  ASSERT_EQ(NGraphFunctionRegistry::Acquire("acquired"), f1);
+
+  auto evicted = NGraphFunctionRegistry::EvictPreloads({"kept"});
+  ASSERT_EQ(evicted.size(), 1);
+  ASSERT_EQ(evicted[0].first, "INTERPRETER");
+  ASSERT_EQ(evicted[0].second, f3);
+  ASSERT_TRUE(NGraphFunctionRegistry::Contains("acquired"));
+  ASSERT_TRUE(NGraphFunctionRegistry::Contains("kept"));
+  ASSERT_FALSE(NGraphFunctionRegistry::Contains("unused"));
+
+  ASSERT_EQ(NGraphFunctionRegistry::Release("acquired"), f1);
+  ASSERT_EQ(NGraphFunctionRegistry::EvictPreloads({}).size(), 1);
+  ASSERT_FALSE(NGraphFunctionRegistry::Contains("kept"));
+}
+
+TEST(FunctionRegistry, ShapeSignature) {
+  ASSERT_EQ(NGraphFunctionRegistry::ShapeSignature(
+                {TensorShape({2, 3}), TensorShape({})}),
+            "2,3,;;/");
+}
+
+// Test that a tensor marked fresh for one kernel calling a shared function is
+// not fresh for another kernel calling it: each kernel has its own copies of
+// the inputs on the device, which are only current after it wrote them.
+TEST(FunctionRegistry, FreshnessPerKernel) {
+  auto param = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2});
+  auto f = make_shared<ng::Function>(param, ng::ParameterVector{param});
+  int kernel1, kernel2;
+  NGraphFreshnessTracker::User user1(&kernel1, f);
+  NGraphFreshnessTracker::User user2(&kernel2, f);
+
+  float buffer[2];
+  auto tracker = new NGraphFreshnessTracker();
+  tracker->AddTensor(buffer);
+
+  // The first kernel reads the buffer, which is then written and read by the
+  // second kernel.
+  tracker->MarkFresh(buffer, user1);
+  tracker->MarkStale(buffer);
+  tracker->MarkFresh(buffer, user2);
+  ASSERT_TRUE(tracker->IsFresh(buffer, user2));
+  ASSERT_FALSE(tracker->IsFresh(buffer, user1));
+
+  tracker->MarkFresh(buffer, user1);
+  tracker->RemoveUser(user1);
+  ASSERT_FALSE(tracker->IsFresh(buffer, user1));
+  ASSERT_TRUE(tracker->IsFresh(buffer, user2));
+
+  tracker->Unref();
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_simplify_graph.h"
+#include "ngraph_utils.h"
+
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+static Node* MakeFloatConst(Graph* g, const string& name, float value) {
+  Tensor t(DT_FLOAT, TensorShape{});
+  t.scalar<float>()() = value;
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(name, "Const")
+                  .Attr("dtype", DT_FLOAT)
+                  .Attr("value", t)
+                  .Finalize(g, &node));
+  return node;
+}
+
+static int CountOps(const Graph& g, const string& type) {
+  int count = 0;
+  for (auto node : g.op_nodes()) {
+    if (node->type_string() == type) count++;
+  }
+  return count;
+}
+
+// retval = reshape((arg + 1) * (arg + 1), shape(arg)), with the two
+// constants and the two Adds built separately.
+TEST(SimplifyGraph, FoldShapesAndCSE) {
+  Graph g(OpRegistry::Global());
+
+  Node* arg;
+  ASSERT_OK(NodeBuilder("arg", "_Arg")
+                .Attr("T", DT_FLOAT)
+                .Attr("index", 0)
+                .Finalize(&g, &arg));
+  Node* shape;
+  ASSERT_OK(NodeBuilder("shape", "Shape")
+                .Input(arg, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("out_type", DT_INT32)
+                .Finalize(&g, &shape));
+
+  Node* one_a = MakeFloatConst(&g, "one_a", 1.0f);
+  Node* one_b = MakeFloatConst(&g, "one_b", 1.0f);
+
+  Node* add_a;
+  ASSERT_OK(NodeBuilder("add_a", "Add")
+                .Input(arg, 0)
+                .Input(one_a, 0)
+                .Attr("T", DT_FLOAT)
+                .Finalize(&g, &add_a));
+  Node* add_b;
+  ASSERT_OK(NodeBuilder("add_b", "Add")
+                .Input(arg, 0)
+                .Input(one_b, 0)
+                .Attr("T", DT_FLOAT)
+                .Finalize(&g, &add_b));
+  Node* mul;
+  ASSERT_OK(NodeBuilder("mul", "Mul")
+                .Input(add_a, 0)
+                .Input(add_b, 0)
+                .Attr("T", DT_FLOAT)
+                .Finalize(&g, &mul));
+  Node* reshape;
+  ASSERT_OK(NodeBuilder("reshape", "Reshape")
+                .Input(mul, 0)
+                .Input(shape, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("Tshape", DT_INT32)
+                .Finalize(&g, &reshape));
+  Node* retval;
+  ASSERT_OK(NodeBuilder("retval", "_Retval")
+                .Input(reshape, 0)
+                .Attr("T", DT_FLOAT)
+                .Attr("index", 0)
+                .Finalize(&g, &retval));
+
+  // The graph is disconnected without these edges
+  g.AddEdge(g.source_node(), Graph::kControlSlot, arg, Graph::kControlSlot);
+  g.AddEdge(g.source_node(), Graph::kControlSlot, one_a, Graph::kControlSlot);
+  g.AddEdge(g.source_node(), Graph::kControlSlot, one_b, Graph::kControlSlot);
+  g.AddEdge(retval, Graph::kControlSlot, g.sink_node(), Graph::kControlSlot);
+
+  int nodes_before = g.num_op_nodes();
+  ASSERT_OK(SimplifyClusterGraph(&g, {TensorShape({2, 3})}, nullptr));
+
+  ASSERT_EQ(CountOps(g, "Shape"), 0);
+  ASSERT_EQ(CountOps(g, "Add"), 1);
+  // One for the folded shape, one for the deduplicated 1.0.
+  ASSERT_EQ(CountOps(g, "Const"), 2);
+  ASSERT_EQ(g.num_op_nodes(), nodes_before - 2);
+
+  Node* reshape_shape;
+  for (auto node : g.op_nodes()) {
+    if (node->type_string() == "Reshape") {
+      ASSERT_OK(node->input_node(1, &reshape_shape));
+      ASSERT_EQ(reshape_shape->type_string(), "Const");
+    }
+  }
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
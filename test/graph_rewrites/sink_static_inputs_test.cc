@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_assign_clusters.h"
+#include "ngraph_mark_for_clustering.h"
+#include "ngraph_sink_static_inputs.h"
+#include "ngraph_utils.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/graph/graph.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+// out = reshape(y, [shape(y)[0], -1]), y = abs(x)
+static void BuildReshape(Graph* graph) {
+  Scope root = Scope::NewRootScope();
+  auto x = ops::Placeholder(root.WithOpName("x"), DT_FLOAT);
+  auto y = ops::Abs(root.WithOpName("y"), x);
+  auto shape = ops::Shape(root.WithOpName("shape"), y);
+  auto dim = ops::StridedSlice(root.WithOpName("dim"), shape, {0}, {1}, {1},
+                               ops::StridedSlice::ShrinkAxisMask(1));
+  auto minus_one = ops::Const(root.WithOpName("minus_one"), -1);
+  auto packed = ops::Stack(root.WithOpName("packed"), {dim, minus_one});
+  ops::Reshape(root.WithOpName("out"), y, packed);
+  TF_CHECK_OK(root.ToGraph(graph));
+}
+
+static Node* FindNode(const Graph& graph, const string& name) {
+  for (auto node : graph.op_nodes()) {
+    if (node->name() == name) return node;
+  }
+  return nullptr;
+}
+
+TEST(SinkStaticInputs, ShapeComputation) {
+  Graph graph(OpRegistry::Global());
+  BuildReshape(&graph);
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(SinkStaticInputs(&graph));
+
+  // The Reshape now reads a copy of the shape computation, and the originals
+  // are gone.
+  Node* out = FindNode(graph, "out");
+  ASSERT_NE(out, nullptr);
+  Node* input;
+  ASSERT_OK(out->input_node(1, &input));
+  ASSERT_EQ(input->type_string(), "Pack");
+  ASSERT_TRUE(IsSunkStaticInput(input));
+  for (auto name : {"shape", "dim", "packed"}) {
+    ASSERT_EQ(FindNode(graph, name), nullptr);
+  }
+
+  // The copy of Shape still reads y.
+  Node* shape = nullptr;
+  for (auto node : graph.op_nodes()) {
+    if (node->type_string() == "Shape") shape = node;
+  }
+  ASSERT_NE(shape, nullptr);
+  ASSERT_TRUE(IsSunkStaticInput(shape));
+  ASSERT_OK(shape->input_node(0, &input));
+  ASSERT_EQ(input->name(), "y");
+
+  // Without the static input constraint, everything but x is clustered
+  // together.
+  ASSERT_OK(AssignClusters(&graph));
+  int out_cluster;
+  ASSERT_OK(GetNodeCluster(out, &out_cluster));
+  for (auto node : graph.op_nodes()) {
+    if (node->name() == "x") continue;
+    int cluster;
+    ASSERT_OK(GetNodeCluster(node, &cluster));
+    ASSERT_EQ(cluster, out_cluster);
+  }
+}
+
+TEST(SinkStaticInputs, Disabled) {
+  setenv("NGRAPH_TF_DISABLE_STATIC_INPUT_SINKING", "1", 1);
+
+  Graph graph(OpRegistry::Global());
+  BuildReshape(&graph);
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(SinkStaticInputs(&graph));
+
+  Node* out = FindNode(graph, "out");
+  ASSERT_NE(out, nullptr);
+  Node* input;
+  ASSERT_OK(out->input_node(1, &input));
+  ASSERT_EQ(input->name(), "packed");
+
+  unsetenv("NGRAPH_TF_DISABLE_STATIC_INPUT_SINKING");
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
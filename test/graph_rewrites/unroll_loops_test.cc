@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_assign_clusters.h"
+#include "ngraph_mark_for_clustering.h"
+#include "ngraph_unroll_loops.h"
+#include "ngraph_utils.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/cc/ops/while_loop.h"
+#include "tensorflow/core/graph/graph.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+// for (i = 0; i < 4; i++) x = x * 2;
+static void BuildCountedLoop(Scope& root, const Output& x) {
+  auto i = ops::Const(root.WithOpName("i"), 0);
+
+  auto cond = [](const Scope& s, const std::vector<Output>& inputs,
+                 Output* output) {
+    *output = ops::Less(s, inputs[0], 4);
+    return s.status();
+  };
+  auto body = [](const Scope& s, const std::vector<Output>& inputs,
+                 std::vector<Output>* outputs) {
+    outputs->push_back(ops::Add(s, inputs[0], 1));
+    outputs->push_back(ops::Mul(s, inputs[1], 2.0f));
+    return s.status();
+  };
+
+  OutputList outputs;
+  TF_CHECK_OK(ops::BuildWhileLoop(root, {i, x}, cond, body, "loop", &outputs));
+  ops::Abs(root.WithOpName("result"), outputs[1]);
+}
+
+TEST(UnrollLoops, CountedLoop) {
+  Scope root = Scope::NewRootScope();
+  auto x = ops::Const(root.WithOpName("x"), {1.0f, 2.0f});
+  BuildCountedLoop(root, x);
+
+  Graph graph(OpRegistry::Global());
+  TF_CHECK_OK(root.ToGraph(&graph));
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(UnrollWhileLoops(&graph));
+
+  int num_muls = 0;
+  for (auto node : graph.op_nodes()) {
+    ASSERT_FALSE(node->IsControlFlow()) << node->DebugString();
+    if (node->type_string() == "Mul") num_muls++;
+  }
+  ASSERT_EQ(num_muls, 4);
+
+  // With the control flow gone, the whole computation is one cluster.
+  ASSERT_OK(AssignClusters(&graph));
+  std::set<int> clusters;
+  for (auto node : graph.op_nodes()) {
+    int cluster;
+    if (GetNodeCluster(node, &cluster) == Status::OK()) {
+      clusters.insert(cluster);
+    }
+  }
+  ASSERT_EQ(clusters.size(), 1);
+}
+
+TEST(UnrollLoops, UnsupportedBody) {
+  Scope root = Scope::NewRootScope();
+  auto x = ops::Const(root.WithOpName("x"), {1.0f, 2.0f});
+  BuildCountedLoop(root, x);
+
+  Graph graph(OpRegistry::Global());
+  TF_CHECK_OK(root.ToGraph(&graph));
+  ASSERT_OK(MarkForClustering(&graph));
+  // Loops whose bodies contain an op nGraph can't take are left alone.
+  for (auto node : graph.op_nodes()) {
+    if (node->type_string() == "Mul") {
+      node->AddAttr("_ngraph_marked_for_clustering", false);
+    }
+  }
+  ASSERT_OK(UnrollWhileLoops(&graph));
+
+  int num_control_flow = 0;
+  for (auto node : graph.op_nodes()) {
+    if (node->IsControlFlow()) num_control_flow++;
+  }
+  ASSERT_GT(num_control_flow, 0);
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
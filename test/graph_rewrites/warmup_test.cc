@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+#include "ngraph_assign_clusters.h"
+#include "ngraph_backend_manager.h"
+#include "ngraph_cluster_manager.h"
+#include "ngraph_encapsulate_clusters.h"
+#include "ngraph_function_registry.h"
+#include "ngraph_mark_for_clustering.h"
+#include "ngraph_mixed_precision.h"
+#include "ngraph_warmup.h"
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/graph_constructor.h"
+
+using namespace std;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+// Warms up neg(abs(x)) for a statically shaped x, and checks that the key a
+// kernel for the cluster would look up holds the preloaded function until
+// it is claimed or evicted.
+TEST(Warmup, PreloadAndEvict) {
+  Scope root = Scope::NewRootScope();
+  auto x = ops::Placeholder(root.WithOpName("x"), DT_FLOAT,
+                            ops::Placeholder::Shape({2, 3}));
+  auto abs = ops::Abs(root.WithOpName("abs"), x);
+  ops::Neg(root.WithOpName("neg"), abs);
+
+  Graph graph(OpRegistry::Global());
+  TF_CHECK_OK(root.ToGraph(&graph));
+  ASSERT_OK(MarkForClustering(&graph));
+  ASSERT_OK(AssignClusters(&graph));
+  ASSERT_OK(EncapsulateClusters(&graph));
+
+  // Compute the key the cluster's kernel would use.
+  Node* encapsulate = nullptr;
+  for (auto node : graph.op_nodes()) {
+    if (node->type_string() == "NGraphEncapsulate") {
+      encapsulate = node;
+    }
+  }
+  ASSERT_NE(encapsulate, nullptr);
+  int cluster;
+  string backend;
+  ASSERT_OK(GetNodeAttr(encapsulate->attrs(), "ngraph_cluster", &cluster));
+  ASSERT_OK(GetNodeAttr(encapsulate->attrs(), "_ngraph_backend", &backend));
+  Graph cluster_graph(OpRegistry::Global());
+  GraphConstructorOptions opts;
+  opts.allow_internal_ops = true;
+  ASSERT_OK(ConvertGraphDefToGraph(
+      opts, *NGraphClusterManager::GetClusterGraph(cluster), &cluster_graph));
+  string key = NGraphFunctionRegistry::MakeKey(
+      NGraphFunctionRegistry::CanonicalGraphHash(cluster_graph), backend,
+      NGraphFunctionRegistry::ShapeSignature({TensorShape({2, 3})}) +
+          MixedPrecisionSignature());
+
+  // Warmup is opt-in.
+  ASSERT_OK(WarmUpClusters(graph));
+  ASSERT_FALSE(NGraphFunctionRegistry::Contains(key));
+
+  setenv("NGRAPH_TF_WARMUP_THREADS", "1", 1);
+  ASSERT_OK(WarmUpClusters(graph));
+  auto function = NGraphFunctionRegistry::Acquire(key);
+  ASSERT_NE(function, nullptr);
+
+  // The kernel owns the function once it has acquired it.
+  ASSERT_EQ(NGraphFunctionRegistry::Release(key), function);
+  BackendManager::GetBackend(backend)->remove_compiled_function(function);
+
+  // A preload nobody claims is evicted by the next warmup that does not
+  // want it.
+  ASSERT_OK(WarmUpClusters(graph));
+  ASSERT_TRUE(NGraphFunctionRegistry::Contains(key));
+  Graph empty_graph(OpRegistry::Global());
+  ASSERT_OK(WarmUpClusters(empty_graph));
+  ASSERT_FALSE(NGraphFunctionRegistry::Contains(key));
+
+  unsetenv("NGRAPH_TF_WARMUP_THREADS");
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+#include "ngraph_api.h"
+#include "ngraph_mixed_precision.h"
+
+using namespace std;
+namespace ng = ngraph;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+static int CountConverts(const shared_ptr<ng::Function>& ng_function) {
+  int count = 0;
+  for (auto node : ng_function->get_ordered_ops()) {
+    if (dynamic_pointer_cast<ng::op::Convert>(node) != nullptr) count++;
+  }
+  return count;
+}
+
+static shared_ptr<ng::Node> FindOp(const shared_ptr<ng::Function>& ng_function,
+                                   const string& op_type) {
+  for (auto node : ng_function->get_ordered_ops()) {
+    if (node->description() == op_type) return node;
+  }
+  return nullptr;
+}
+
+// Dot -> Relu -> Dot -> Softmax: the Relu stays in bf16 between the Dots, and
+// the Softmax runs in f32.
+TEST(mixed_precision, dot_relu_dot_softmax) {
+  auto ng_x = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2, 3});
+  auto ng_w1 =
+      make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{3, 4});
+  auto ng_w2 =
+      make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{4, 5});
+
+  shared_ptr<ng::Node> ng_node = make_shared<ng::op::Dot>(ng_x, ng_w1);
+  ng_node = make_shared<ng::op::Relu>(ng_node);
+  ng_node = make_shared<ng::op::Dot>(ng_node, ng_w2);
+  ng_node = make_shared<ng::op::Softmax>(ng_node, ng::AxisSet{1});
+
+  auto ng_function = make_shared<ng::Function>(
+      ng_node, ng::ParameterVector{ng_x, ng_w1, ng_w2});
+  ASSERT_OK(ApplyMixedPrecision(ng_function));
+
+  // Three inputs narrowed, and the second Dot's result widened.
+  ASSERT_EQ(CountConverts(ng_function), 4);
+  ASSERT_EQ(FindOp(ng_function, "Relu")->get_element_type(),
+            ng::element::bf16);
+  auto ng_softmax = FindOp(ng_function, "Softmax");
+  ASSERT_EQ(ng_softmax->get_element_type(), ng::element::f32);
+  ASSERT_EQ(ng_softmax->get_argument(0)->get_argument(0)->description(),
+            "Dot");
+  ASSERT_EQ(ng_function->get_results()[0]->get_element_type(),
+            ng::element::f32);
+}
+
+// An Add of a Dot and an f32 bias is not moved to bf16, since that would
+// round the bias.
+TEST(mixed_precision, keep_f32_operands) {
+  auto ng_x = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2, 3});
+  auto ng_w = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{3, 4});
+  auto ng_b = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2, 4});
+
+  auto ng_dot = make_shared<ng::op::Dot>(ng_x, ng_w);
+  auto ng_add = make_shared<ng::op::Add>(ng_dot, ng_b);
+
+  auto ng_function = make_shared<ng::Function>(
+      ng_add, ng::ParameterVector{ng_x, ng_w, ng_b});
+  ASSERT_OK(ApplyMixedPrecision(ng_function));
+
+  ASSERT_EQ(FindOp(ng_function, "Dot")->get_element_type(), ng::element::bf16);
+  ASSERT_EQ(FindOp(ng_function, "Add")->get_element_type(), ng::element::f32);
+}
+
+// Functions translated with and without mixed precision must not share keys.
+TEST(mixed_precision, signature) {
+  if (std::getenv("NGRAPH_TF_MIXED_PRECISION") != nullptr) {
+    return;
+  }
+  ASSERT_EQ(MixedPrecisionSignature(), "");
+  config::EnableMixedPrecision();
+  string signature = MixedPrecisionSignature();
+  config::DisableMixedPrecision();
+  ASSERT_NE(signature, "");
+  ASSERT_NE(signature.find("Dot"), string::npos);
+  ASSERT_NE(signature.find("Softmax"), string::npos);
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
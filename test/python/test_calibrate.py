@@ -0,0 +1,124 @@
+# ==============================================================================
+#  Copyright 2018 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""nGraph TensorFlow bridge INT8 calibration tool test
+
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import os
+import sys
+
+import numpy as np
+import tensorflow as tf
+
+from common import NgraphTest
+
+sys.path.append(
+    os.path.join(
+        os.path.dirname(os.path.realpath(__file__)), '..', '..', 'tools'))
+import ngraph_calibrate
+
+
+class TestCalibrate(NgraphTest):
+
+    def build_graph_def(self):
+        graph = tf.Graph()
+        with graph.as_default():
+            x = tf.placeholder(tf.float32, shape=(None, 4), name='x')
+            w = tf.constant(np.ones((4, 3), dtype=np.float32))
+            b = tf.constant(np.zeros(3, dtype=np.float32))
+            y = tf.nn.relu(tf.nn.bias_add(tf.matmul(x, w), b), name='y')
+            tf.identity(y * 2.0, name='out')
+        return graph.as_graph_def()
+
+    def build_conv_graph_def(self):
+        rng = np.random.RandomState(0)
+        graph = tf.Graph()
+        with graph.as_default():
+            x = tf.placeholder(tf.float32, shape=(None, 6, 6, 2), name='x')
+            w = tf.constant(rng.uniform(-1, 1, (3, 3, 2, 4)).astype(np.float32))
+            b = tf.constant(rng.uniform(-0.5, 0.5, 4).astype(np.float32))
+            y = tf.nn.relu(
+                tf.nn.bias_add(tf.nn.conv2d(x, w, [1, 1, 1, 1], 'SAME'), b),
+                name='y')
+            tf.identity(y * 2.0, name='out')
+        return graph.as_graph_def()
+
+    def test_find_layers(self):
+        layers = ngraph_calibrate.find_layers(self.build_conv_graph_def())
+        assert len(layers) == 1
+        assert layers[0].op.op == 'Conv2D'
+        assert layers[0].bias_add is not None
+        assert layers[0].relu.name == 'y'
+        assert layers[0].output_tensor == 'y:0'
+
+    def test_find_layers_skips_matmul(self):
+        assert ngraph_calibrate.find_layers(self.build_graph_def()) == []
+
+    def run_graph_def(self, graph_def, x, use_ngraph):
+        with tf.Graph().as_default() as graph:
+            tf.import_graph_def(graph_def, name='')
+            out = graph.get_tensor_by_name('out:0')
+            feed_dict = {graph.get_tensor_by_name('x:0'): x}
+            run = self.with_ngraph if use_ngraph else self.without_ngraph
+            return run(lambda sess: sess.run(out, feed_dict))
+
+    def test_calibrated_conv_matches_float(self):
+        graph_def = self.build_conv_graph_def()
+        data = {
+            'x':
+            np.random.RandomState(1).uniform(0, 1, (16, 6, 6, 2)).astype(
+                np.float32)
+        }
+        calibrated = ngraph_calibrate.calibrate(graph_def, data, batch_size=8)
+        assert [
+            node.op for node in calibrated.node if node.op.startswith('Quant')
+        ] == ['QuantizeV2', 'QuantizedConv2DWithBiasAndReluAndRequantize']
+
+        x = data['x'][:4]
+        expected = self.run_graph_def(graph_def, x, False)
+        result = self.run_graph_def(calibrated, x, True)
+        # About a step of the 8-bit output range, plus the input and weight
+        # rounding accumulated over the 18 products of each output.
+        assert np.allclose(
+            result, expected, atol=0.05 * np.abs(expected).max())
+
+    def test_collect_ranges(self):
+        data = {'x': np.array([[1, 2, 3, 4], [-1, -2, -3, -4]], np.float32)}
+        collectors = ngraph_calibrate.collect_ranges(
+            self.build_graph_def(), ['x:0', 'y:0'], data, 1, 'minmax', 16)
+        assert collectors['x:0'].min == -4 and collectors['x:0'].max == 4
+        assert collectors['y:0'].min == 0 and collectors['y:0'].max == 10
+
+    def test_percentile_threshold(self):
+        # 999 values in the first bin, and an outlier in the last one.
+        histogram = np.zeros(100, dtype=np.int64)
+        histogram[0] = 999
+        histogram[99] = 1
+        assert np.isclose(
+            ngraph_calibrate.percentile_threshold(histogram, 10.0, 99.0), 0.1)
+        assert np.isclose(
+            ngraph_calibrate.percentile_threshold(histogram, 10.0, 100.0),
+            10.0)
+
+    def test_kl_threshold_clips_outliers(self):
+        values = np.abs(np.random.RandomState(0).randn(100000))
+        values = np.append(values, 100.0)
+        histogram, _ = np.histogram(values, bins=2048, range=(0, 100.0))
+        threshold = ngraph_calibrate.kl_threshold(histogram, 100.0)
+        assert 2.0 < threshold < 10.0
@@ -0,0 +1,57 @@
+# ==============================================================================
+#  Copyright 2018 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""nGraph TensorFlow bridge test for placement logging
+
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import pytest
+
+import tensorflow as tf
+import numpy as np
+
+import ngraph_config
+from common import NgraphTest
+
+
+class TestPlacementLogging(NgraphTest):
+
+    def test_logged_for_cached_rewrite(self, capfd):
+        test_input = np.random.rand(2, 3).astype(np.float32) - 0.5
+        val = tf.placeholder(tf.float32, shape=(2, 3))
+        out = tf.abs(tf.negative(val))
+
+        def run_test(sess):
+            return sess.run(out, feed_dict={val: test_input})
+
+        ngraph_config.start_logging_placement()
+        try:
+            # The second session reuses the rewrite of the first one.
+            logs = []
+            for _ in range(2):
+                self.with_ngraph(run_test)
+                logs.append(capfd.readouterr().out)
+        finally:
+            ngraph_config.stop_logging_placement()
+
+        placements = [[
+            line for line in log.splitlines()
+            if line.startswith('OP_placement:')
+        ] for log in logs]
+        assert len(placements[0]) > 0
+        assert sorted(placements[0]) == sorted(placements[1])
@@ -0,0 +1,95 @@
+# ==============================================================================
+#  Copyright 2018 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""nGraph TensorFlow bridge test for the fallback to TensorFlow of clusters
+that keep recompiling
+
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import pytest
+
+import tensorflow as tf
+import numpy as np
+
+import ngraph_config
+from common import NgraphTest
+
+# The number of calls over which NGraphEncapsulateOp counts compiles.
+SIGNATURE_WINDOW_STEPS = 20
+
+
+class TestRecompileFallback(NgraphTest):
+
+    def run_paddings(self, paddings):
+        # The Pad's paddings are a static input, so each new value needs a
+        # compile.
+        test_input = np.random.rand(6).astype(np.float32) - 0.5
+        val = tf.placeholder(tf.float32, shape=(6,))
+        pad = tf.placeholder(tf.int32, shape=(1, 2))
+        out = tf.abs(tf.pad(tf.negative(val), pad))
+
+        def run_test(sess):
+            return [
+                sess.run(out, feed_dict={
+                    val: test_input,
+                    pad: p
+                }) for p in paddings
+            ]
+
+        compile_count = ngraph_config.get_compile_count()
+        actual = self.with_ngraph(run_test)
+        compile_count = ngraph_config.get_compile_count() - compile_count
+
+        for e, a in zip(self.without_ngraph(run_test), actual):
+            assert e.shape == a.shape
+            assert np.allclose(e, a)
+        return compile_count
+
+    def test_new_paddings_every_call(self):
+        # Every call needs a compile, so the last call of the first window
+        # finds too many of them and runs with TensorFlow, like all the calls
+        # after it.
+        paddings = [[[i, 1]] for i in range(2 * SIGNATURE_WINDOW_STEPS)]
+        assert self.run_paddings(paddings) == SIGNATURE_WINDOW_STEPS - 1
+
+    def test_stable_paddings(self):
+        # After two windows with a single compile, the cluster still runs with
+        # nGraph, and compiles for new paddings.
+        paddings = [[[2, 3]]] * (2 * SIGNATURE_WINDOW_STEPS) + [[[3, 2]]]
+        assert self.run_paddings(paddings) == 2
+
+    def test_disabled(self):
+        # Without the fallback, every call compiles.
+        paddings = [[[i, 1]] for i in range(2 * SIGNATURE_WINDOW_STEPS)]
+        ngraph_config.disable_recompile_fallback()
+        try:
+            assert not ngraph_config.is_recompile_fallback_enabled()
+            assert self.run_paddings(paddings) == len(paddings)
+        finally:
+            ngraph_config.enable_recompile_fallback()
+
+    def test_max_new_signature_rate(self):
+        # With a rate of 1, no window can have too many compiles.
+        paddings = [[[i, 1]] for i in range(2 * SIGNATURE_WINDOW_STEPS)]
+        saved = ngraph_config.get_max_new_signature_rate()
+        ngraph_config.set_max_new_signature_rate(1.0)
+        try:
+            assert ngraph_config.get_max_new_signature_rate() == 1.0
+            assert self.run_paddings(paddings) == len(paddings)
+        finally:
+            ngraph_config.set_max_new_signature_rate(saved)
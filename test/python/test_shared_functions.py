@@ -0,0 +1,55 @@
+# ==============================================================================
+#  Copyright 2018 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""nGraph TensorFlow bridge test for kernels sharing a function
+
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import pytest
+
+import tensorflow as tf
+import numpy as np
+
+from common import NgraphTest
+
+
+class TestSharedFunctions(NgraphTest):
+
+    def test_kernels_reading_same_variable(self):
+        var = tf.Variable(np.ones((2, 3), dtype=np.float32))
+        new_value = tf.placeholder(tf.float32, shape=(2, 3))
+        assign = tf.assign(var, new_value)
+        # Two copies of the same cluster, run by separate kernels that share
+        # one function.
+        out1 = tf.abs(tf.negative(var))
+        out2 = tf.abs(tf.negative(var))
+
+        def run_test(sess):
+            sess.run(tf.global_variables_initializer())
+            results = [sess.run(out1)]
+            sess.run(assign, feed_dict={new_value: np.full((2, 3), -2.0)})
+            # The second kernel reads the new value, after which the first
+            # kernel must not take its own copy of the variable for current.
+            results.append(sess.run(out2))
+            results.append(sess.run(out1))
+            return results
+
+        actual = self.with_ngraph(run_test)
+        assert np.allclose(actual[2], 2.0)
+        for e, a in zip(self.without_ngraph(run_test), actual):
+            assert np.allclose(e, a)
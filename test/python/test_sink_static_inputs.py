@@ -0,0 +1,87 @@
+# ==============================================================================
+#  Copyright 2018 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""nGraph TensorFlow bridge test for sinking static inputs computed from
+shapes into their consumers
+
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import pytest
+
+import tensorflow as tf
+import os
+import numpy as np
+
+import ngraph_config
+from common import NgraphTest
+
+
+class TestSinkStaticInputs(NgraphTest):
+
+    def run_batches(self, batches):
+        test_inputs = [
+            np.random.rand(batch, 6).astype(np.float32) - 0.5
+            for batch in batches
+        ]
+        val = tf.placeholder(tf.float32, shape=(None, 6))
+        # The Reshape's shape is a static input computed from the shape of
+        # "val", by ops that could be clustered on their own.
+        shape = tf.stack([tf.shape(val)[0] * 2, 3])
+        out = tf.abs(tf.reshape(tf.negative(val), shape))
+
+        def run_test(sess):
+            return [
+                sess.run(out, feed_dict={val: test_input})
+                for test_input in test_inputs
+            ]
+
+        # Keep the shape computation from being folded or rewritten.
+        config = tf.ConfigProto(
+            graph_options=tf.GraphOptions(
+                optimizer_options=tf.OptimizerOptions(
+                    opt_level=tf.OptimizerOptions.L0,
+                    do_common_subexpression_elimination=False,
+                    do_constant_folding=False,
+                    do_function_inlining=False,
+                )))
+
+        compile_count = ngraph_config.get_compile_count()
+        actual = self.with_ngraph(run_test, config)
+        compile_count = ngraph_config.get_compile_count() - compile_count
+
+        for e, a in zip(self.without_ngraph(run_test, config), actual):
+            assert e.shape == a.shape
+            assert np.allclose(e, a)
+        return compile_count
+
+    def test_one_compile_per_shape(self):
+        # The shape computation is folded into the Reshape's cluster, which
+        # compiles once for each new input shape.
+        batches = [1, 2, 3, 1, 2, 3]
+        assert self.run_batches(batches) == len(set(batches))
+
+    def test_disabled(self):
+        # Without sinking, the shape computation is a cluster of its own, and
+        # both clusters compile for each new input shape.
+        batches = [1, 2, 3, 1, 2, 3]
+        os.environ['NGRAPH_TF_DISABLE_STATIC_INPUT_SINKING'] = '1'
+        try:
+            compile_count = self.run_batches(batches)
+        finally:
+            os.environ.pop('NGRAPH_TF_DISABLE_STATIC_INPUT_SINKING')
+        assert compile_count == 2 * len(set(batches))
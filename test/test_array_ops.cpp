@@ -1042,6 +1042,28 @@ TEST(ArrayOps, Tile) {
   }
 }  // end of test op Tile
 
+// Test op: Tile, with unit and large multiples
+TEST(ArrayOps, TileLargeMultiples) {
+  Scope root = Scope::NewRootScope();
+
+  Tensor input_data(DT_FLOAT, TensorShape({3, 1, 2}));
+  AssignInputValuesRandom<float>(input_data, -5.0f, 10.0f);
+
+  Tensor multiples(DT_INT32, TensorShape({3}));
+  AssignInputValues<int32>(multiples, {1, 500, 2});
+
+  vector<int> static_input_indexes = {1};
+
+  auto R = ops::Tile(root, input_data, multiples);
+  vector<DataType> output_datatypes = {DT_FLOAT};
+  std::vector<Output> sess_run_fetchoutputs = {R};
+
+  OpExecuter opexecuter(root, "Tile", static_input_indexes, output_datatypes,
+                        sess_run_fetchoutputs);
+
+  opexecuter.RunTest();
+}  // end of test op TileLargeMultiples
+
 // Unpacks the given dimension of a rank R tensor into a (R-1) tensor
 TEST(ArrayOps, Unpack) {
   std::vector<std::vector<int64>> input_sizes;
@@ -485,6 +485,55 @@ TEST(MathOps, BatchMatMul3DAdjY) {
 
   vector<DataType> output_datatypes = {DT_FLOAT};
 
+  std::vector<Output> sess_run_fetchoutputs = {R};
+  OpExecuter opexecuter(root, "BatchMatMul", static_input_indexes,
+                        output_datatypes, sess_run_fetchoutputs);
+
+  opexecuter.RunTest();
+}
+
+// BatchMatMul 4D with non-square matrices and both adjoint attributes set
+TEST(MathOps, BatchMatMul4DAdjXAdjY) {
+  Scope root = Scope::NewRootScope();
+
+  Tensor A(DT_FLOAT, TensorShape({2, 3, 5, 4}));
+  Tensor B(DT_FLOAT, TensorShape({2, 3, 6, 5}));
+
+  auto attrs = ops::BatchMatMul::Attrs().AdjX(true).AdjY(true);
+
+  AssignInputValuesRandom(A);
+  AssignInputValuesRandom(B);
+
+  vector<int> static_input_indexes = {};
+
+  auto R = ops::BatchMatMul(root, A, B, attrs);
+
+  vector<DataType> output_datatypes = {DT_FLOAT};
+
+  std::vector<Output> sess_run_fetchoutputs = {R};
+  OpExecuter opexecuter(root, "BatchMatMul", static_input_indexes,
+                        output_datatypes, sess_run_fetchoutputs);
+
+  opexecuter.RunTest();
+}
+
+// BatchMatMul with products too large to broadcast all at once, which are
+// multiplied in groups of batch elements (here 4 and 1)
+TEST(MathOps, BatchMatMulGrouped) {
+  Scope root = Scope::NewRootScope();
+
+  Tensor A(DT_FLOAT, TensorShape({5, 160, 160}));
+  Tensor B(DT_FLOAT, TensorShape({5, 160, 160}));
+
+  AssignInputValuesRandom(A);
+  AssignInputValuesRandom(B);
+
+  vector<int> static_input_indexes = {};
+
+  auto R = ops::BatchMatMul(root, A, B);
+
+  vector<DataType> output_datatypes = {DT_FLOAT};
+
   std::vector<Output> sess_run_fetchoutputs = {R};
   OpExecuter opexecuter(root, "BatchMatMul", static_input_indexes,
                         output_datatypes, sess_run_fetchoutputs);
@@ -1038,6 +1087,60 @@ TEST(MathOps, Rsqrt) {
   opexecuter.RunTest();
 }  // end of test op Rsqrt
 
+// Test op: Select, with a condition of the same shape as the branches
+TEST(MathOps, Select) {
+  Scope root = Scope::NewRootScope();
+  int dim1 = 2;
+  int dim2 = 2;
+
+  Tensor C(DT_BOOL, TensorShape({dim1, dim2}));
+  Tensor A(DT_FLOAT, TensorShape({dim1, dim2}));
+  Tensor B(DT_FLOAT, TensorShape({dim1, dim2}));
+
+  AssignInputValues<bool>(C, {true, false, false, true});
+  AssignInputValues(A, 2.0f);
+  AssignInputValues(B, -3.0f);
+
+  vector<int> static_input_indexes = {};
+  auto R = ops::Select(root, C, A, B);
+
+  vector<DataType> output_datatypes = {DT_FLOAT};
+
+  std::vector<Output> sess_run_fetchoutputs = {R};
+  OpExecuter opexecuter(root, "Select", static_input_indexes, output_datatypes,
+                        sess_run_fetchoutputs);
+  opexecuter.RunTest();
+}  // end of test op Select
+
+// Test op: Select, with a scalar and a vector condition
+TEST(MathOps, SelectBroadcastCondition) {
+  int dim1 = 2;
+  int dim2 = 3;
+
+  Tensor A(DT_FLOAT, TensorShape({dim1, dim2}));
+  Tensor B(DT_FLOAT, TensorShape({dim1, dim2}));
+  AssignInputValues(A, 2.0f);
+  AssignInputValues(B, -3.0f);
+
+  Tensor C_scalar(DT_BOOL, TensorShape({}));
+  AssignInputValues<bool>(C_scalar, {false});
+  Tensor C_vector(DT_BOOL, TensorShape({dim1}));
+  AssignInputValues<bool>(C_vector, {false, true});
+
+  for (auto C : {C_scalar, C_vector}) {
+    Scope root = Scope::NewRootScope();
+    vector<int> static_input_indexes = {};
+    auto R = ops::Select(root, C, A, B);
+
+    vector<DataType> output_datatypes = {DT_FLOAT};
+
+    std::vector<Output> sess_run_fetchoutputs = {R};
+    OpExecuter opexecuter(root, "Select", static_input_indexes,
+                          output_datatypes, sess_run_fetchoutputs);
+    opexecuter.RunTest();
+  }
+}  // end of test op SelectBroadcastCondition
+
 // Test op: Square
 TEST(MathOps, Square) {
   Scope root = Scope::NewRootScope();
@@ -1036,6 +1036,164 @@ TEST(NNOps, QuantizedMaxPool) {
   }
 }
 
+// Computes Quantized Avgpool. With the range [0, 255], quantized values are
+// their own real values, so the result does not depend on how the range is
+// interpreted.
+TEST(NNOps, QuantizedAvgPool) {
+  int dim1 = 2;
+  int dim2 = 3;
+  int channels = 2;
+
+  for (auto padding_mode : {"SAME", "VALID"}) {
+    Scope root = Scope::NewRootScope();
+    auto quant_type = DT_QUINT8;
+    Tensor A(quant_type, TensorShape({1, dim1, dim2, channels}));
+    AssignInputValues<quint8>(
+        A, {50, 242, 14, 0, 17, 22, 100, 250, 34, 60, 79, 255});
+    vector<int> ksize = {1, 2, 2, 1};
+    vector<int> strides = {1, 1, 1, 1};
+
+    vector<int> static_input_indexes = {};
+    auto R = ops::QuantizedAvgPool(root, A, 0.0f, 255.0f, ksize, strides,
+                                   padding_mode);
+
+    vector<DataType> output_datatypes = {quant_type, DT_FLOAT, DT_FLOAT};
+
+    std::vector<Output> sess_run_fetchoutputs = {R.output, R.min_output,
+                                                 R.max_output};
+    OpExecuter opexecuter(root, "QuantizedAvgPool", static_input_indexes,
+                          output_datatypes, sess_run_fetchoutputs);
+
+    opexecuter.RunTest();
+  }
+}
+
+// Computes QuantizedConv2D with asymmetric ranges, in which zero is not the
+// quantized value 0: 64 for the input, 170 for the filter.
+TEST(NNOps, QuantizedConv2D) {
+  for (auto padding_mode : {"SAME", "VALID"}) {
+    Scope root = Scope::NewRootScope();
+    Tensor input(DT_QUINT8, TensorShape({1, 3, 4, 2}));
+    AssignInputValues<quint8>(input, {0,   12,  64,  255, 200, 31, 90,  64,
+                                      128, 7,   250, 64,  15,  99, 180, 230,
+                                      64,  140, 3,   77,  255, 42, 160, 64});
+    Tensor filter(DT_QUINT8, TensorShape({2, 2, 2, 2}));
+    AssignInputValues<quint8>(filter, {170, 0, 255, 85, 34, 170, 200, 120,
+                                       255, 61, 170, 9, 100, 240, 170, 45});
+    vector<int> strides = {1, 1, 1, 1};
+
+    vector<int> static_input_indexes = {};
+    auto R = ops::QuantizedConv2D(root, input, filter, -1.0f, 3.0f, -2.0f,
+                                  1.0f, strides, padding_mode);
+
+    vector<DataType> output_datatypes = {DT_QINT32, DT_FLOAT, DT_FLOAT};
+    std::vector<Output> sess_run_fetchoutputs = {R.output, R.min_output,
+                                                 R.max_output};
+    OpExecuter opexecuter(root, "QuantizedConv2D", static_input_indexes,
+                          output_datatypes, sess_run_fetchoutputs);
+
+    opexecuter.RunTest();
+  }
+}
+
+// Computes QuantizedMatMul with asymmetric ranges, in which zero is the
+// quantized value 51 for a and 191 for b.
+TEST(NNOps, QuantizedMatMul) {
+  for (bool transpose_b : {false, true}) {
+    Scope root = Scope::NewRootScope();
+    Tensor a(DT_QUINT8, TensorShape({2, 3}));
+    AssignInputValues<quint8>(a, {0, 51, 255, 100, 17, 220});
+    Tensor b(DT_QUINT8,
+             transpose_b ? TensorShape({4, 3}) : TensorShape({3, 4}));
+    AssignInputValues<quint8>(
+        b, {191, 0, 255, 30, 120, 191, 64, 250, 5, 180, 191, 77});
+
+    vector<int> static_input_indexes = {};
+    auto R = ops::QuantizedMatMul(
+        root, a, b, -0.5f, 2.0f, -3.0f, 1.0f,
+        ops::QuantizedMatMul::TransposeB(transpose_b));
+
+    vector<DataType> output_datatypes = {DT_QINT32, DT_FLOAT, DT_FLOAT};
+    std::vector<Output> sess_run_fetchoutputs = {R.out, R.min_out, R.max_out};
+    OpExecuter opexecuter(root, "QuantizedMatMul", static_input_indexes,
+                          output_datatypes, sess_run_fetchoutputs);
+
+    opexecuter.RunTest();
+  }
+}
+
+// Computes QuantizedConcat of values in different asymmetric ranges. The
+// first value is in the output range and is copied, the second is
+// requantized to it.
+TEST(NNOps, QuantizedConcat) {
+  for (int axis : {0, 1}) {
+    Scope root = Scope::NewRootScope();
+    Tensor a(DT_QUINT8, TensorShape({2, 3}));
+    AssignInputValues<quint8>(a, {0, 64, 255, 13, 128, 200});
+    Tensor b(DT_QUINT8, TensorShape({2, 3}));
+    AssignInputValues<quint8>(b, {0, 17, 64, 100, 230, 255});
+
+    vector<int> static_input_indexes = {0};
+    auto R = ops::QuantizedConcat(root, axis, {a, b}, {-1.0f, -0.5f},
+                                  {3.0f, 2.2f});
+
+    vector<DataType> output_datatypes = {DT_QUINT8, DT_FLOAT, DT_FLOAT};
+    std::vector<Output> sess_run_fetchoutputs = {R.output, R.output_min,
+                                                 R.output_max};
+    OpExecuter opexecuter(root, "QuantizedConcat", static_input_indexes,
+                          output_datatypes, sess_run_fetchoutputs);
+
+    opexecuter.RunTest();
+  }
+}
+
+// Requantizes qint32 values in [-4, 2] to quint8 in [-1, 1.5].
+TEST(NNOps, Requantize) {
+  Scope root = Scope::NewRootScope();
+  Tensor input(DT_QINT32, TensorShape({2, 6}));
+  AssignInputValues<qint32>(
+      input, {-1500000000, -123456789, 55555555, 98765432, 123456789,
+              300000000, 400000000, 650000000, 777777777, 1234567890,
+              1500000000, 2147483000});
+
+  vector<int> static_input_indexes = {};
+  auto R = ops::Requantize(root, input, -4.0f, 2.0f, -1.0f, 1.5f, DT_QUINT8);
+
+  vector<DataType> output_datatypes = {DT_QUINT8, DT_FLOAT, DT_FLOAT};
+  std::vector<Output> sess_run_fetchoutputs = {R.output, R.output_min,
+                                               R.output_max};
+  OpExecuter opexecuter(root, "Requantize", static_input_indexes,
+                        output_datatypes, sess_run_fetchoutputs);
+
+  opexecuter.RunTest();
+}
+
+// Computes the range of qint32 values in [-4, 2]. Without negative values,
+// the range still starts at zero.
+TEST(NNOps, RequantizationRange) {
+  for (bool has_negative_values : {true, false}) {
+    Scope root = Scope::NewRootScope();
+    Tensor input(DT_QINT32, TensorShape({2, 3}));
+    if (has_negative_values) {
+      AssignInputValues<qint32>(input, {-1500000000, 55555555, 98765432,
+                                        400000000, 1234567890, 2147483000});
+    } else {
+      AssignInputValues<qint32>(input, {1000000000, 1100000000, 1234567890,
+                                        1500000000, 1700000000, 2000000000});
+    }
+
+    vector<int> static_input_indexes = {};
+    auto R = ops::RequantizationRange(root, input, -4.0f, 2.0f);
+
+    vector<DataType> output_datatypes = {DT_FLOAT, DT_FLOAT};
+    std::vector<Output> sess_run_fetchoutputs = {R.output_min, R.output_max};
+    OpExecuter opexecuter(root, "RequantizationRange", static_input_indexes,
+                          output_datatypes, sess_run_fetchoutputs);
+
+    opexecuter.RunTest();
+  }
+}
+
 // Computes Quantized Maxpool when min==max
 TEST(NNOps, QuantizedMaxPoolSameMinMax) {
   int dim1 = 2;
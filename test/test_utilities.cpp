@@ -138,6 +138,9 @@ void Compare(const vector<Tensor>& v1, const vector<Tensor>& v2) {
       case DT_QUINT8:
         Compare<quint8>(v1[i], v2[i]);
         break;
+      case DT_QINT32:
+        Compare<qint32>(v1[i], v2[i]);
+        break;
       default:
         ASSERT_TRUE(false)
             << "Could not find the corresponding function for the "
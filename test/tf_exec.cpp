@@ -13,9 +13,15 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  *******************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+
 #include "gtest/gtest.h"
 
+#include "ngraph_api.h"
 #include "ngraph_builder.h"
+#include "ngraph_log.h"
 #include "ngraph_utils.h"
 #include "test_utilities.h"
 
@@ -206,6 +212,411 @@ TEST(tf_exec, BatchMatMul) {
   Compare<float>(outputs_z2_ng[0], outputs_z2_tf[0]);
 }
 
+// Times the first run (which includes translation and compilation on nGraph)
+// and the average of subsequent runs of BatchMatMul, on nGraph and on
+// TensorFlow. The shapes cover a product broadcast in one piece, products
+// split into groups of batch elements (a few large groups, and many small
+// matrices), and products done with one Dot per batch element. Run the same
+// test on an earlier revision to compare against a different lowering.
+TEST(tf_exec, DISABLED_BatchMatMulBenchmark) {
+  const int num_steps = 10;
+  std::vector<std::vector<int64>> lhs_shapes{
+      {4, 16, 32, 64}, {8, 16, 128, 64}, {2048, 64, 64}, {4, 512, 512}};
+  std::vector<std::vector<int64>> rhs_shapes{
+      {4, 16, 64, 32}, {8, 16, 64, 128}, {2048, 64, 64}, {4, 512, 512}};
+
+  for (size_t i = 0; i < lhs_shapes.size(); i++) {
+    Tensor X(DT_FLOAT, TensorShape(lhs_shapes[i]));
+    Tensor Y(DT_FLOAT, TensorShape(rhs_shapes[i]));
+    AssignInputValuesRandom(X);
+    AssignInputValuesRandom(Y);
+
+    for (bool use_ngraph : {true, false}) {
+      Scope root = Scope::NewRootScope();
+      auto x = ops::Placeholder(root, DT_FLOAT);
+      auto y = ops::Placeholder(root, DT_FLOAT);
+      auto R = ops::BatchMatMul(root.WithOpName("R"), x, y);
+
+      if (use_ngraph) {
+        ActivateNGraph();
+      } else {
+        DeactivateNGraph();
+      }
+      ClientSession session(root);
+      std::vector<Tensor> outputs;
+
+      auto start = std::chrono::steady_clock::now();
+      ASSERT_OK(session.Run({{x, X}, {y, Y}}, {R}, &outputs));
+      auto first = std::chrono::steady_clock::now();
+      for (int step = 0; step < num_steps; step++) {
+        ASSERT_OK(session.Run({{x, X}, {y, Y}}, {R}, &outputs));
+      }
+      auto end = std::chrono::steady_clock::now();
+
+      LOG(INFO) << (use_ngraph ? "nGraph" : "TF") << " BatchMatMul "
+                << X.shape().DebugString() << " x " << Y.shape().DebugString()
+                << ": first run "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       first - start)
+                       .count()
+                << " ms, steady state "
+                << std::chrono::duration_cast<std::chrono::microseconds>(
+                       end - first)
+                           .count() /
+                       num_steps
+                << " us";
+    }
+  }
+  ActivateNGraph();
+}
+
+TEST(tf_exec, VLogLevel) {
+  int64 saved = config::GetVLogLevel();
+  config::SetVLogLevel(2);
+  ASSERT_EQ(config::GetVLogLevel(), 2);
+  ASSERT_EQ(NGRAPH_VLOG_IS_ON(2), 2 <= NGRAPH_TF_MAX_VLOG_LEVEL);
+  ASSERT_FALSE(NGRAPH_VLOG_IS_ON(3));
+  config::SetVLogLevel(saved);
+}
+
+// The per-step cost of checking the VLOG level, as it was (reading and
+// parsing NGRAPH_TF_VLOG_LEVEL on every check) and as it is, next to the
+// cost of running a small cluster.
+TEST(tf_exec, DISABLED_VLogOverheadBenchmark) {
+  const int num_checks = 1000000;
+  auto parse_env_level = []() {
+    const char* value = std::getenv("NGRAPH_TF_VLOG_LEVEL");
+    int64 level = 0;
+    if (value != nullptr) {
+      std::istringstream ss(value);
+      if (!(ss >> level)) level = 0;
+    }
+    return level;
+  };
+
+  int enabled = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_checks; i++) {
+    enabled += (5 <= parse_env_level());
+  }
+  auto parsed = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_checks; i++) {
+    enabled += NGRAPH_VLOG_IS_ON(5);
+  }
+  auto cached = std::chrono::steady_clock::now();
+
+  Scope root = Scope::NewRootScope();
+  Tensor X(DT_FLOAT, TensorShape({2, 2}));
+  AssignInputValuesRandom(X);
+  auto x = ops::Placeholder(root, DT_FLOAT);
+  auto R = ops::Add(root.WithOpName("R"), ops::Abs(root, x), x);
+  ActivateNGraph();
+  ClientSession session(root);
+  std::vector<Tensor> outputs;
+  ASSERT_OK(session.Run({{x, X}}, {R}, &outputs));
+  const int num_steps = 1000;
+  auto run_start = std::chrono::steady_clock::now();
+  for (int step = 0; step < num_steps; step++) {
+    ASSERT_OK(session.Run({{x, X}}, {R}, &outputs));
+  }
+  auto run_end = std::chrono::steady_clock::now();
+
+  auto ns_per = [](std::chrono::steady_clock::duration d, int count) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count() /
+           count;
+  };
+  LOG(INFO) << "VLOG level check: parsed " << ns_per(parsed - start, num_checks)
+            << " ns, cached " << ns_per(cached - parsed, num_checks)
+            << " ns; Run " << ns_per(run_end - run_start, num_steps)
+            << " ns per step (" << enabled << " checks enabled)";
+}
+
+// Conv2D followed by BiasAdd + Relu6 and by FusedBatchNorm + Relu, which the
+// builder translates as fused convolution epilogues.
+TEST(tf_exec, ConvEpilogue) {
+  Scope root = Scope::NewRootScope();
+
+  Tensor X(DT_FLOAT, TensorShape({2, 7, 7, 3}));
+  Tensor F(DT_FLOAT, TensorShape({3, 3, 3, 4}));
+  Tensor B(DT_FLOAT, TensorShape({4}));
+  Tensor Scale(DT_FLOAT, TensorShape({4}));
+  Tensor Variance(DT_FLOAT, TensorShape({4}));
+  AssignInputValuesRandom<float>(X, -2.0f, 2.0f);
+  AssignInputValuesRandom<float>(F, -1.0f, 1.0f);
+  AssignInputValuesRandom<float>(B, -1.0f, 1.0f);
+  AssignInputValuesRandom<float>(Scale, 0.5f, 1.5f);
+  AssignInputValuesRandom<float>(Variance, 0.5f, 1.5f);
+
+  auto x = ops::Placeholder(root, DT_FLOAT);
+  auto f = ops::Placeholder(root, DT_FLOAT);
+  auto b = ops::Placeholder(root, DT_FLOAT);
+  auto scale = ops::Placeholder(root, DT_FLOAT);
+  auto variance = ops::Placeholder(root, DT_FLOAT);
+
+  auto conv_1 = ops::Conv2D(root, x, f, {1, 1, 1, 1}, "SAME");
+  auto R1 = ops::Relu6(root.WithOpName("R1"), ops::BiasAdd(root, conv_1, b));
+
+  auto conv_2 = ops::Conv2D(root, x, f, {1, 2, 2, 1}, "VALID");
+  auto bn_attrs = ops::FusedBatchNorm::Attrs().IsTraining(false);
+  auto bn = ops::FusedBatchNorm(root, conv_2, scale, b, b, variance, bn_attrs);
+  auto R2 = ops::Relu(root.WithOpName("R2"), bn.y);
+
+  ClientSession::FeedType feeds{
+      {x, X}, {f, F}, {b, B}, {scale, Scale}, {variance, Variance}};
+
+  std::vector<Tensor> outputs_ng;
+  ActivateNGraph();
+  ClientSession session_ng(root);
+  ASSERT_OK(session_ng.Run(feeds, {R1, R2}, &outputs_ng));
+
+  std::vector<Tensor> outputs_tf;
+  DeactivateNGraph();
+  ClientSession session_tf(root);
+  ASSERT_OK(session_tf.Run(feeds, {R1, R2}, &outputs_tf));
+  ActivateNGraph();
+
+  Compare(outputs_ng[0], outputs_tf[0], 1e-5);
+  Compare(outputs_ng[1], outputs_tf[1], 1e-4);
+}
+
+// Inference batch norms folded into a depthwise convolution whose filter and
+// parameters are fed, and into a convolution whose filter and parameters are
+// constants.
+TEST(tf_exec, BatchNormFolding) {
+  Scope root = Scope::NewRootScope();
+
+  Tensor X(DT_FLOAT, TensorShape({2, 7, 7, 3}));
+  Tensor DF(DT_FLOAT, TensorShape({3, 3, 3, 2}));
+  Tensor F(DT_FLOAT, TensorShape({3, 3, 3, 4}));
+  AssignInputValuesRandom<float>(X, -2.0f, 2.0f);
+  AssignInputValuesRandom<float>(DF, -1.0f, 1.0f);
+  AssignInputValuesRandom<float>(F, -1.0f, 1.0f);
+
+  Tensor D_Scale(DT_FLOAT, TensorShape({6}));
+  Tensor D_Mean(DT_FLOAT, TensorShape({6}));
+  Tensor D_Variance(DT_FLOAT, TensorShape({6}));
+  AssignInputValuesRandom<float>(D_Scale, 0.5f, 1.5f);
+  AssignInputValuesRandom<float>(D_Mean, -1.0f, 1.0f);
+  AssignInputValuesRandom<float>(D_Variance, 0.5f, 1.5f);
+
+  Tensor C_Scale(DT_FLOAT, TensorShape({4}));
+  Tensor C_Mean(DT_FLOAT, TensorShape({4}));
+  Tensor C_Variance(DT_FLOAT, TensorShape({4}));
+  AssignInputValuesRandom<float>(C_Scale, 0.5f, 1.5f);
+  AssignInputValuesRandom<float>(C_Mean, -1.0f, 1.0f);
+  AssignInputValuesRandom<float>(C_Variance, 0.5f, 1.5f);
+
+  auto x = ops::Placeholder(root, DT_FLOAT);
+  auto df = ops::Placeholder(root, DT_FLOAT);
+  auto d_scale = ops::Placeholder(root, DT_FLOAT);
+  auto d_mean = ops::Placeholder(root, DT_FLOAT);
+  auto d_variance = ops::Placeholder(root, DT_FLOAT);
+
+  auto bn_attrs = ops::FusedBatchNorm::Attrs().IsTraining(false);
+  auto depthwise =
+      ops::DepthwiseConv2dNative(root, x, df, {1, 1, 1, 1}, "SAME");
+  auto d_bn = ops::FusedBatchNorm(root, depthwise, d_scale, d_mean, d_mean,
+                                  d_variance, bn_attrs);
+  auto R1 = ops::Relu(root.WithOpName("R1"), d_bn.y);
+
+  auto conv = ops::Conv2D(root, x, ops::Const(root, F), {1, 1, 1, 1}, "SAME");
+  auto c_bn = ops::FusedBatchNorm(
+      root, conv, ops::Const(root, C_Scale), ops::Const(root, C_Mean),
+      ops::Const(root, C_Mean), ops::Const(root, C_Variance), bn_attrs);
+  auto R2 = ops::Relu(root.WithOpName("R2"), c_bn.y);
+
+  ClientSession::FeedType feeds{{x, X},
+                                {df, DF},
+                                {d_scale, D_Scale},
+                                {d_mean, D_Mean},
+                                {d_variance, D_Variance}};
+
+  std::vector<Tensor> outputs_ng;
+  ActivateNGraph();
+  ClientSession session_ng(root);
+  ASSERT_OK(session_ng.Run(feeds, {R1, R2}, &outputs_ng));
+
+  std::vector<Tensor> outputs_tf;
+  DeactivateNGraph();
+  ClientSession session_tf(root);
+  ASSERT_OK(session_tf.Run(feeds, {R1, R2}, &outputs_tf));
+  ActivateNGraph();
+
+  Compare(outputs_ng[0], outputs_tf[0], 1e-4);
+  Compare(outputs_ng[1], outputs_tf[1], 1e-4);
+}
+
+// Fake quantized convolution and matmul layers, as left by quantization-aware
+// training, which are translated to integer ops. The results may differ from
+// TensorFlow's by one quantization step of the output.
+TEST(tf_exec, QDQFolding) {
+  Scope root = Scope::NewRootScope();
+
+  Tensor X(DT_FLOAT, TensorShape({2, 6, 6, 3}));
+  Tensor F(DT_FLOAT, TensorShape({3, 3, 3, 4}));
+  Tensor Bias(DT_FLOAT, TensorShape({4}));
+  Tensor A(DT_FLOAT, TensorShape({2, 5}));
+  Tensor B(DT_FLOAT, TensorShape({5, 3}));
+  AssignInputValuesRandom<float>(X, -1.0f, 2.0f);
+  AssignInputValuesRandom<float>(F, -1.0f, 1.0f);
+  AssignInputValuesRandom<float>(Bias, -1.0f, 1.0f);
+  AssignInputValuesRandom<float>(A, -2.0f, 2.0f);
+  AssignInputValuesRandom<float>(B, -1.0f, 1.0f);
+
+  auto fake_quant = [&root](Output value, float min, float max,
+                            bool is_signed) {
+    auto attrs = ops::QuantizeAndDequantizeV2::Attrs()
+                     .SignedInput(is_signed)
+                     .NumBits(8)
+                     .RangeGiven(true);
+    return ops::QuantizeAndDequantizeV2(root, value, min, max, attrs).output;
+  };
+
+  auto x = ops::Placeholder(root, DT_FLOAT);
+  auto conv = ops::Conv2D(root, fake_quant(x, 0.0f, 2.0f, false),
+                          fake_quant(ops::Const(root, F), -1.0f, 1.0f, true),
+                          {1, 1, 1, 1}, "SAME");
+  auto relu =
+      ops::Relu(root, ops::BiasAdd(root, conv, ops::Const(root, Bias)));
+  auto R1 = ops::Identity(root.WithOpName("R1"),
+                          fake_quant(relu, 0.0f, 8.0f, false));
+
+  auto a = ops::Placeholder(root, DT_FLOAT);
+  auto matmul = ops::MatMul(root, fake_quant(a, -2.0f, 2.0f, true),
+                            fake_quant(ops::Const(root, B), -1.0f, 1.0f, true));
+  auto R2 = ops::Identity(root.WithOpName("R2"),
+                          fake_quant(matmul, -6.0f, 6.0f, true));
+
+  ClientSession::FeedType feeds{{x, X}, {a, A}};
+
+  std::vector<Tensor> outputs_ng;
+  ActivateNGraph();
+  ClientSession session_ng(root);
+  ASSERT_OK(session_ng.Run(feeds, {R1, R2}, &outputs_ng));
+
+  std::vector<Tensor> outputs_tf;
+  DeactivateNGraph();
+  ClientSession session_tf(root);
+  ASSERT_OK(session_tf.Run(feeds, {R1, R2}, &outputs_tf));
+  ActivateNGraph();
+
+  // One quantization step of each output.
+  std::vector<float> steps{8.0f / 255, 6.0f / 127};
+  for (int i = 0; i < 2; i++) {
+    ASSERT_EQ(outputs_ng[i].shape(), outputs_tf[i].shape());
+    auto ng_values = outputs_ng[i].flat<float>();
+    auto tf_values = outputs_tf[i].flat<float>();
+    for (int k = 0; k < ng_values.size(); k++) {
+      EXPECT_NEAR(ng_values(k), tf_values(k), steps[i] + 1e-4);
+    }
+  }
+}
+
+// Builds y = batch_normalization(x, moments(x, axes), beta, gamma) the way
+// tf.nn.moments and tf.nn.batch_normalization expand it.
+static Output BuildNormalization(const Scope& scope, Output x, Output gamma,
+                                 Output beta, const std::vector<int>& axes) {
+  Tensor axes_tensor(DT_INT32, TensorShape({int64(axes.size())}));
+  std::copy(axes.begin(), axes.end(), axes_tensor.flat<int32>().data());
+  auto reduction_axes = ops::Const(scope, axes_tensor);
+
+  auto keep_dims = ops::Mean::KeepDims(true);
+  auto mean = ops::Mean(scope, x, reduction_axes, keep_dims);
+  auto variance = ops::Mean(
+      scope, ops::SquaredDifference(scope, x, ops::StopGradient(scope, mean)),
+      reduction_axes, keep_dims);
+  auto inv = ops::Mul(
+      scope, ops::Rsqrt(scope, ops::Add(scope, variance, 1e-12f)), gamma);
+  return ops::Add(scope.WithOpName("y"), ops::Mul(scope, x, inv),
+                  ops::Sub(scope, beta, ops::Mul(scope, mean, inv)));
+}
+
+// Layer norm over the last axis and instance norm over the spatial axes,
+// which the builder translates as fused normalizations.
+TEST(tf_exec, Normalization) {
+  std::vector<std::vector<int64>> x_shapes{{4, 16, 64}, {2, 5, 5, 8}};
+  std::vector<std::vector<int>> norm_axes{{-1}, {1, 2}};
+
+  for (size_t i = 0; i < x_shapes.size(); i++) {
+    Scope root = Scope::NewRootScope();
+    int64 depth = x_shapes[i].back();
+    Tensor X(DT_FLOAT, TensorShape(x_shapes[i]));
+    Tensor Gamma(DT_FLOAT, TensorShape({depth}));
+    Tensor Beta(DT_FLOAT, TensorShape({depth}));
+    AssignInputValuesRandom<float>(X, -10.0f, 10.0f);
+    AssignInputValuesRandom<float>(Gamma, 0.5f, 1.5f);
+    AssignInputValuesRandom<float>(Beta, -1.0f, 1.0f);
+
+    auto x = ops::Placeholder(root, DT_FLOAT);
+    auto gamma = ops::Placeholder(root, DT_FLOAT);
+    auto beta = ops::Placeholder(root, DT_FLOAT);
+    auto y = BuildNormalization(root, x, gamma, beta, norm_axes[i]);
+    ClientSession::FeedType feeds{{x, X}, {gamma, Gamma}, {beta, Beta}};
+
+    std::vector<Tensor> outputs_ng;
+    ActivateNGraph();
+    ClientSession session_ng(root);
+    ASSERT_OK(session_ng.Run(feeds, {y}, &outputs_ng));
+
+    std::vector<Tensor> outputs_tf;
+    DeactivateNGraph();
+    ClientSession session_tf(root);
+    ASSERT_OK(session_tf.Run(feeds, {y}, &outputs_tf));
+    ActivateNGraph();
+
+    Compare(outputs_ng[0], outputs_tf[0], 1e-4);
+  }
+}
+
+// Times BERT-sized layer norms (batch 8, sequence 128) on nGraph and on
+// TensorFlow. Set NGRAPH_TF_DISABLE_NORMALIZATION_FUSION=1 to time the op by
+// op translation instead.
+TEST(tf_exec, DISABLED_LayerNormBenchmark) {
+  const int num_steps = 20;
+
+  for (int64 hidden : {768, 1024}) {
+    Tensor X(DT_FLOAT, TensorShape({8, 128, hidden}));
+    Tensor Gamma(DT_FLOAT, TensorShape({hidden}));
+    Tensor Beta(DT_FLOAT, TensorShape({hidden}));
+    AssignInputValuesRandom(X);
+    AssignInputValuesRandom(Gamma);
+    AssignInputValuesRandom(Beta);
+
+    for (bool use_ngraph : {true, false}) {
+      Scope root = Scope::NewRootScope();
+      auto x = ops::Placeholder(root, DT_FLOAT);
+      auto gamma = ops::Placeholder(root, DT_FLOAT);
+      auto beta = ops::Placeholder(root, DT_FLOAT);
+      auto y = BuildNormalization(root, x, gamma, beta, {-1});
+      ClientSession::FeedType feeds{{x, X}, {gamma, Gamma}, {beta, Beta}};
+
+      if (use_ngraph) {
+        ActivateNGraph();
+      } else {
+        DeactivateNGraph();
+      }
+      ClientSession session(root);
+      std::vector<Tensor> outputs;
+
+      ASSERT_OK(session.Run(feeds, {y}, &outputs));
+      auto start = std::chrono::steady_clock::now();
+      for (int step = 0; step < num_steps; step++) {
+        ASSERT_OK(session.Run(feeds, {y}, &outputs));
+      }
+      auto end = std::chrono::steady_clock::now();
+
+      LOG(INFO) << (use_ngraph ? "nGraph" : "TF") << " LayerNorm "
+                << X.shape().DebugString() << ": "
+                << std::chrono::duration_cast<std::chrono::microseconds>(
+                       end - start)
+                           .count() /
+                       num_steps
+                << "us per step";
+    }
+  }
+  ActivateNGraph();
+}
+
 TEST(tf_exec, DISABLED_BatchMatMul_3D) {
   Scope root = Scope::NewRootScope();
   auto dev_scope = root.WithDevice("/device:NGRAPH:0");
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright 2017-2018 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *******************************************************************************/
+#include "gtest/gtest.h"
+
+#include "ngraph_conversions.h"
+#include "ngraph_transpose_sinking.h"
+
+using namespace std;
+namespace ng = ngraph;
+
+namespace tensorflow {
+
+namespace ngraph_bridge {
+
+namespace testing {
+
+#define ASSERT_OK(x) ASSERT_EQ((x), ::tensorflow::Status::OK());
+
+static int CountReshapes(const shared_ptr<ng::Function>& ng_function) {
+  int count = 0;
+  for (auto node : ng_function->get_ordered_ops()) {
+    if (dynamic_pointer_cast<ng::op::Reshape>(node) != nullptr) count++;
+  }
+  return count;
+}
+
+// NCHW -> NHWC -> Relu -> BiasAdd -> NCHW, as between two convolutions.
+TEST(transpose_sinking, cancel_across_elementwise) {
+  auto ng_input =
+      make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2, 3, 4, 5});
+  auto ng_bias = make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{3});
+
+  shared_ptr<ng::Node> ng_node = ng_input;
+  BatchToTensorflow(true, ng_node);
+  ng_node = make_shared<ng::op::Relu>(ng_node);
+  auto ng_bias_broadcast = make_shared<ng::op::Broadcast>(
+      ng_bias, ng_node->get_shape(), ng::AxisSet{0, 1, 2});
+  ng_node = make_shared<ng::op::Add>(ng_node, ng_bias_broadcast);
+  BatchToNGraph(true, ng_node);
+
+  auto ng_function = make_shared<ng::Function>(
+      ng_node, ng::ParameterVector{ng_input, ng_bias});
+  ASSERT_EQ(CountReshapes(ng_function), 2);
+
+  ASSERT_OK(SinkTransposes(ng_function));
+  ASSERT_EQ(CountReshapes(ng_function), 0);
+  ASSERT_EQ(ng_function->get_results()[0]->get_shape(),
+            (ng::Shape{2, 3, 4, 5}));
+}
+
+// The transpose back to NHWC is still needed at the function boundary.
+TEST(transpose_sinking, keep_boundary_transpose) {
+  auto ng_input =
+      make_shared<ng::op::Parameter>(ng::element::f32, ng::Shape{2, 3, 4, 5});
+
+  shared_ptr<ng::Node> ng_node = ng_input;
+  BatchToTensorflow(true, ng_node);
+  ng_node = make_shared<ng::op::Relu>(ng_node);
+
+  auto ng_function =
+      make_shared<ng::Function>(ng_node, ng::ParameterVector{ng_input});
+  ASSERT_OK(SinkTransposes(ng_function));
+
+  ASSERT_EQ(CountReshapes(ng_function), 1);
+  auto ng_result = ng_function->get_results()[0]->get_argument(0);
+  ASSERT_NE(dynamic_pointer_cast<ng::op::Reshape>(ng_result), nullptr);
+  ASSERT_EQ(ng_result->get_shape(), (ng::Shape{2, 4, 5, 3}));
+}
+
+}  // namespace testing
+
+}  // namespace ngraph_bridge
+
+}  // namespace tensorflow
@@ -0,0 +1,518 @@
+# ==============================================================================
+#  Copyright 2018 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""Offline INT8 calibration for the nGraph TensorFlow bridge.
+
+Loads a frozen GraphDef, finds the convolution layers that can run on the
+bridge's quantized kernels, runs representative batches through the bridge to
+collect the ranges of their inputs and outputs, and writes a graph in which
+each of those layers is replaced by
+
+    QuantizeV2 -> QuantizedConv2DWithBias...AndRequantize -> Dequantize
+
+with static ranges. A layer is a Conv2D (NHWC) with a constant filter,
+optionally followed by a BiasAdd with a constant bias and by a Relu.
+
+MatMul layers are left in float: TensorFlow 1.12 has no fused quantized
+matmul, and its QuantizedMatMul takes MIN_FIRST ranges, which the bridge
+does not quantize to.
+
+The ranges are collected by ops added to the graph at each candidate point:
+Min and Max reductions for all modes, and for the percentile and KL modes, a
+second pass of fixed width histograms of the absolute values.
+"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import argparse
+import os
+
+import numpy as np
+import tensorflow as tf
+from google.protobuf import text_format
+from tensorflow.core.framework import attr_value_pb2
+from tensorflow.core.framework import graph_pb2
+from tensorflow.core.framework import node_def_pb2
+from tensorflow.python.framework import op_def_registry
+from tensorflow.python.framework import tensor_util
+
+CALIBRATION_MODES = ['minmax', 'percentile', 'kl']
+
+
+def load_graph_def(path):
+    graph_def = graph_pb2.GraphDef()
+    with open(path, 'rb') as f:
+        contents = f.read()
+    if path.endswith('.pbtxt'):
+        text_format.Merge(contents, graph_def)
+    else:
+        graph_def.ParseFromString(contents)
+    return graph_def
+
+
+def save_graph_def(graph_def, path):
+    if path.endswith('.pbtxt'):
+        with open(path, 'w') as f:
+            f.write(text_format.MessageToString(graph_def))
+    else:
+        with open(path, 'wb') as f:
+            f.write(graph_def.SerializeToString())
+
+
+def _node_name(input_name):
+    return input_name.lstrip('^').split(':')[0]
+
+
+def _consumers(graph_def):
+    consumers = {}
+    for node in graph_def.node:
+        for input_name in node.input:
+            consumers.setdefault(_node_name(input_name), []).append(
+                (node, input_name))
+    return consumers
+
+
+def _const_value(nodes, input_name):
+    """The value of a constant input, possibly read through Identity ops as
+    frozen variables are."""
+    while True:
+        if ':' in input_name and not input_name.endswith(':0'):
+            return None
+        node = nodes.get(_node_name(input_name))
+        if node is None or node.op != 'Identity':
+            break
+        input_name = node.input[0]
+    if node is None or node.op != 'Const':
+        return None
+    return tensor_util.MakeNdarray(node.attr['value'].tensor)
+
+
+def _is_float(node):
+    return node.attr['T'].type == tf.float32.as_datatype_enum
+
+
+class Layer(object):
+    """A convolution, with its optional bias and activation."""
+
+    def __init__(self, op, weights):
+        self.op = op
+        self.weights = weights
+        self.bias_add = None
+        self.bias = None
+        self.relu = None
+
+    @property
+    def last(self):
+        return self.relu or self.bias_add or self.op
+
+    @property
+    def input_tensor(self):
+        name = self.op.input[0]
+        return name if ':' in name else name + ':0'
+
+    @property
+    def output_tensor(self):
+        return self.last.name + ':0'
+
+
+def find_layers(graph_def):
+    """Returns the layers of "graph_def" that can be quantized."""
+    nodes = {node.name: node for node in graph_def.node}
+    consumers = _consumers(graph_def)
+
+    def sole_consumer(node):
+        users = consumers.get(node.name, [])
+        if len(users) != 1 or users[0][1] not in (node.name, node.name + ':0'):
+            return None
+        return users[0][0]
+
+    layers = []
+    for node in graph_def.node:
+        if node.op != 'Conv2D' or not _is_float(node):
+            continue
+        if node.attr['data_format'].s not in (b'', b'NHWC'):
+            continue
+        weights = _const_value(nodes, node.input[1])
+        if weights is None:
+            continue
+        layer = Layer(node, weights)
+
+        next_node = sole_consumer(node)
+        if next_node is not None and next_node.op == 'BiasAdd' and \
+                next_node.input[0] in (node.name, node.name + ':0'):
+            bias = _const_value(nodes, next_node.input[1])
+            if bias is not None:
+                layer.bias_add = next_node
+                layer.bias = bias
+                next_node = sole_consumer(next_node)
+        if next_node is not None and next_node.op == 'Relu':
+            layer.relu = next_node
+        layers.append(layer)
+    return layers
+
+
+class RangeCollector(object):
+    """Accumulates the range of one tensor over the calibration batches."""
+
+    def __init__(self, num_bins):
+        self.min = np.inf
+        self.max = -np.inf
+        self.histogram = np.zeros(num_bins, dtype=np.int64)
+
+    @property
+    def abs_max(self):
+        return max(abs(self.min), abs(self.max))
+
+    def update_range(self, batch_min, batch_max):
+        self.min = min(self.min, float(batch_min))
+        self.max = max(self.max, float(batch_max))
+
+    def update_histogram(self, batch_histogram):
+        self.histogram += batch_histogram
+
+    def calibrated_range(self, mode, percentile):
+        if mode == 'minmax' or self.abs_max == 0:
+            return self.min, self.max
+        if mode == 'percentile':
+            threshold = percentile_threshold(self.histogram, self.abs_max,
+                                             percentile)
+        else:
+            threshold = kl_threshold(self.histogram, self.abs_max)
+        return max(self.min, -threshold), min(self.max, threshold)
+
+
+def percentile_threshold(histogram, abs_max, percentile):
+    """The smallest threshold covering "percentile" percent of the values in a
+    histogram of absolute values over [0, abs_max]."""
+    total = histogram.sum()
+    if total == 0:
+        return abs_max
+    cumulative = np.cumsum(histogram)
+    index = np.searchsorted(cumulative, total * percentile / 100.0)
+    bin_width = abs_max / len(histogram)
+    return min(abs_max, (index + 1) * bin_width)
+
+
+def kl_threshold(histogram, abs_max, num_levels=128):
+    """The threshold that minimizes the KL divergence between the
+    distribution of absolute values in "histogram", over [0, abs_max], and its
+    quantization to "num_levels" levels, clipped at the threshold."""
+    histogram = histogram.astype(np.float64)
+    num_bins = len(histogram)
+    if histogram.sum() == 0 or num_bins <= num_levels:
+        return abs_max
+
+    best_divergence = np.inf
+    best_index = num_bins
+    for index in range(num_levels, num_bins + 1):
+        reference = histogram[:index].copy()
+        # Values past the threshold are clipped to it.
+        reference[-1] += histogram[index:].sum()
+        nonzero = reference != 0
+
+        # Merge the bins into num_levels levels, and spread each level back
+        # evenly over the nonzero bins it came from.
+        candidate = np.zeros(index)
+        edges = np.linspace(0, index, num_levels + 1).astype(np.int64)
+        for begin, end in zip(edges[:-1], edges[1:]):
+            count = nonzero[begin:end].sum()
+            if count != 0:
+                candidate[begin:end] = np.where(
+                    nonzero[begin:end],
+                    histogram[begin:end].sum() / count, 0.0)
+
+        p = reference / reference.sum()
+        q = candidate / max(candidate.sum(), 1e-12)
+        mask = p > 0
+        divergence = np.sum(p[mask] * np.log(p[mask] / np.maximum(
+            q[mask], 1e-12)))
+        if divergence < best_divergence:
+            best_divergence = divergence
+            best_index = index
+    return (best_index + 0.5) * abs_max / num_bins
+
+
+def _batches(data, batch_size):
+    num_samples = min(len(value) for value in data.values())
+    for begin in range(0, num_samples, batch_size):
+        yield {
+            name: value[begin:begin + batch_size]
+            for name, value in data.items()
+        }
+
+
+def collect_ranges(graph_def, tensor_names, data, batch_size, mode, num_bins):
+    """Runs the calibration data through the bridge, and returns a
+    RangeCollector for each tensor in "tensor_names"."""
+    import ngraph_config
+    ngraph_config.enable()
+
+    collectors = {name: RangeCollector(num_bins) for name in tensor_names}
+    graph = tf.Graph()
+    with graph.as_default():
+        tf.import_graph_def(graph_def, name='')
+        feeds = {
+            graph.get_tensor_by_name(name if ':' in name else name + ':0'):
+            name for name in data
+        }
+        tensors = [graph.get_tensor_by_name(name) for name in tensor_names]
+        with tf.name_scope('ngraph_calibration'):
+            ranges = [(tf.reduce_min(t), tf.reduce_max(t)) for t in tensors]
+
+        with tf.Session(graph=graph) as sess:
+            for batch in _batches(data, batch_size):
+                feed_dict = {t: batch[name] for t, name in feeds.items()}
+                for name, value in zip(tensor_names,
+                                       sess.run(ranges, feed_dict)):
+                    collectors[name].update_range(*value)
+
+        if mode == 'minmax':
+            return collectors
+
+        with tf.name_scope('ngraph_calibration'):
+            histograms = [
+                tf.histogram_fixed_width(
+                    tf.abs(t), [0.0, max(collectors[name].abs_max, 1e-12)],
+                    nbins=num_bins)
+                for t, name in zip(tensors, tensor_names)
+            ]
+        with tf.Session(graph=graph) as sess:
+            for batch in _batches(data, batch_size):
+                feed_dict = {t: batch[name] for t, name in feeds.items()}
+                for name, value in zip(tensor_names,
+                                       sess.run(histograms, feed_dict)):
+                    collectors[name].update_histogram(value)
+    return collectors
+
+
+def _attr(value):
+    if isinstance(value, attr_value_pb2.AttrValue):
+        return value
+    if isinstance(value, bool):
+        return attr_value_pb2.AttrValue(b=value)
+    if isinstance(value, int):
+        return attr_value_pb2.AttrValue(i=value)
+    if isinstance(value, str):
+        return attr_value_pb2.AttrValue(s=value.encode('ascii'))
+    if isinstance(value, tf.DType):
+        return attr_value_pb2.AttrValue(type=value.as_datatype_enum)
+    raise ValueError('Unsupported attribute value ' + repr(value))
+
+
+def _make_node(op, name, inputs, attrs):
+    node = node_def_pb2.NodeDef(op=op, name=name, input=inputs)
+    for key, value in attrs.items():
+        node.attr[key].CopyFrom(_attr(value))
+    return node
+
+
+def _make_const(name, value, dtype):
+    return _make_node(
+        'Const', name, [], {
+            'dtype': dtype,
+            'value': attr_value_pb2.AttrValue(
+                tensor=tensor_util.make_tensor_proto(value, dtype=dtype))
+        })
+
+
+def _quantized_type(min_value):
+    return tf.quint8 if min_value >= 0 else tf.qint8
+
+
+def quantize_layer(layer, input_range, output_range, registered_ops):
+    """Returns the nodes that replace "layer", or None if it cannot be
+    quantized with the ops TensorFlow has registered. The last node takes the
+    name of the layer's last op, so that its consumers are unchanged."""
+    prefix = layer.op.name + '/quantized'
+    relu = layer.relu is not None
+    input_type = _quantized_type(input_range[0])
+    output_type = tf.quint8 if relu else tf.qint8
+    nodes = []
+
+    # The input, in SCALED mode with the calibrated range.
+    nodes.append(_make_const(prefix + '/input_min', input_range[0], tf.float32))
+    nodes.append(_make_const(prefix + '/input_max', input_range[1], tf.float32))
+    nodes.append(
+        _make_node('QuantizeV2', prefix + '/input', [
+            layer.op.input[0], prefix + '/input_min', prefix + '/input_max'
+        ], {
+            'T': input_type,
+            'mode': 'SCALED'
+        }))
+
+    # The weights, in SCALED mode with their own range.
+    weights_max = float(np.abs(layer.weights).max()) or 1.0
+    quantized_weights = np.clip(
+        np.round(layer.weights * (127.0 / weights_max)), -127, 127)
+    nodes.append(
+        _make_const(prefix + '/weights', quantized_weights.astype(np.int8),
+                    tf.qint8))
+    nodes.append(_make_const(prefix + '/weights_min', -weights_max,
+                             tf.float32))
+    nodes.append(_make_const(prefix + '/weights_max', weights_max, tf.float32))
+
+    if layer.bias is not None:
+        bias = layer.bias.astype(np.float32)
+    else:
+        bias = np.zeros(layer.weights.shape[-1], dtype=np.float32)
+    nodes.append(_make_const(prefix + '/bias', bias, tf.float32))
+
+    nodes.append(_make_const(prefix + '/output_min', output_range[0],
+                             tf.float32))
+    nodes.append(_make_const(prefix + '/output_max', output_range[1],
+                             tf.float32))
+
+    op_type = 'QuantizedConv2DWithBias' + ('AndRelu' if relu else '') + \
+        'AndRequantize'
+    inputs = [
+        prefix + '/input', prefix + '/weights', prefix + '/bias',
+        prefix + '/input:1', prefix + '/input:2', prefix + '/weights_min',
+        prefix + '/weights_max', prefix + '/output_min', prefix + '/output_max'
+    ]
+    attrs = {
+        'Tinput': input_type,
+        'Tfilter': tf.qint8,
+        'Tbias': tf.float32,
+        'out_type': output_type,
+        'strides': layer.op.attr['strides'],
+        'padding': layer.op.attr['padding'],
+    }
+    if 'dilations' in layer.op.attr:
+        attrs['dilations'] = layer.op.attr['dilations']
+
+    if op_type not in registered_ops:
+        return None
+    nodes.append(_make_node(op_type, prefix + '/op', inputs, attrs))
+    # The output range is the frozen one. Reading it from the constants keeps
+    # the static inputs of the Dequantize in the same cluster.
+    nodes.append(
+        _make_node('Dequantize', layer.last.name, [
+            prefix + '/op', prefix + '/output_min', prefix + '/output_max'
+        ], {
+            'T': output_type,
+            'mode': 'SCALED'
+        }))
+    return nodes
+
+
+def calibrate(graph_def, data, batch_size=32, mode='minmax', percentile=99.99,
+              num_bins=2048):
+    """Returns a copy of "graph_def" with its quantizable layers replaced by
+    quantized ops, whose ranges are calibrated on "data", a dict from input
+    tensor names to arrays whose first axis indexes samples."""
+    if mode not in CALIBRATION_MODES:
+        raise ValueError('Unknown calibration mode ' + mode)
+
+    layers = find_layers(graph_def)
+    tensor_names = sorted(
+        set(t for layer in layers
+            for t in (layer.input_tensor, layer.output_tensor)))
+    collectors = collect_ranges(graph_def, tensor_names, data, batch_size,
+                                mode, num_bins)
+
+    registered_ops = op_def_registry.get_registered_ops()
+    replaced = {}
+    new_nodes = []
+    for layer in layers:
+        input_range = collectors[layer.input_tensor].calibrated_range(
+            mode, percentile)
+        output_range = collectors[layer.output_tensor].calibrated_range(
+            mode, percentile)
+        if layer.relu is not None:
+            output_range = (0.0, max(output_range[1], 1e-6))
+        nodes = quantize_layer(layer, input_range, output_range,
+                               registered_ops)
+        if nodes is None:
+            print('Skipping ' + layer.op.name + ': its quantized op is not '
+                  'registered in this TensorFlow build')
+            continue
+        print('Quantized {0}: input range [{1}, {2}], output range [{3}, {4}]'
+              .format(layer.op.name, input_range[0], input_range[1],
+                      output_range[0], output_range[1]))
+        for node in (layer.op, layer.bias_add, layer.relu):
+            if node is not None:
+                replaced[node.name] = node
+        new_nodes.extend(nodes)
+
+    output_graph_def = graph_pb2.GraphDef()
+    output_graph_def.versions.CopyFrom(graph_def.versions)
+    output_graph_def.library.CopyFrom(graph_def.library)
+    output_graph_def.node.extend(
+        node for node in graph_def.node if node.name not in replaced)
+    output_graph_def.node.extend(new_nodes)
+    # Keeps what the graph's outputs depend on, which drops the float weights
+    # and biases nothing reads anymore.
+    consumers = _consumers(graph_def)
+    return tf.graph_util.extract_sub_graph(
+        output_graph_def,
+        [node.name for node in graph_def.node if node.name not in consumers])
+
+
+if __name__ == "__main__":
+    helptxt = '''
+    Calibrate a frozen graph for the nGraph bridge's INT8 kernels.
+
+    The calibration data is an .npz file with an array for each input of the
+    graph, keyed by the input's name, whose first axis indexes samples.
+
+    Sample usage from command line:
+    python ngraph_calibrate.py model.pb data.npz model_int8.pb
+    python ngraph_calibrate.py -m kl model.pb data.npz model_int8.pb
+    python ngraph_calibrate.py -m percentile -p 99.9 model.pb data.npz out.pb
+    '''
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawTextHelpFormatter, description=helptxt)
+    parser.add_argument("input", help="The frozen graph (pb or pbtxt)")
+    parser.add_argument("data", help="The calibration data (npz)")
+    parser.add_argument("output", help="The calibrated graph (pb or pbtxt)")
+    parser.add_argument(
+        "-m",
+        dest="mode",
+        default="minmax",
+        choices=CALIBRATION_MODES,
+        help="How ranges are chosen from the collected values")
+    parser.add_argument(
+        "-p",
+        dest="percentile",
+        type=float,
+        default=99.99,
+        help="The percentile of absolute values kept, in percentile mode")
+    parser.add_argument(
+        "-n",
+        dest="batch_size",
+        type=int,
+        default=32,
+        help="The number of samples per calibration batch")
+    parser.add_argument(
+        "--bins",
+        dest="num_bins",
+        type=int,
+        default=2048,
+        help="The number of histogram bins, in percentile and KL modes")
+    parser.add_argument(
+        "--backend", dest="backend", help="The nGraph backend to run on")
+    args = parser.parse_args()
+
+    if args.backend is not None:
+        import ngraph_config
+        ngraph_config.set_backend(args.backend)
+
+    calibration_data = dict(np.load(args.data).items())
+    calibrated = calibrate(
+        load_graph_def(args.input), calibration_data, args.batch_size,
+        args.mode, args.percentile, args.num_bins)
+    save_graph_def(calibrated, args.output)
+    print("Wrote " + os.path.abspath(args.output))